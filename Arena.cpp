@@ -0,0 +1,88 @@
+#include "Arena.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+/**
+ * @struct Arena::Block
+ * @brief Header in front of the memory of each block.
+ */
+struct alignas(std::max_align_t) Arena::Block {
+  Block *next;
+  size_t size; ///< Usable bytes after the header.
+};
+
+Arena::Arena(size_t blockSize) : fBlockSize(blockSize) {}
+
+Arena::~Arena() { _FreeBlocks(); }
+
+void *Arena::Allocate(size_t size, size_t alignment) {
+  uintptr_t at = ((uintptr_t)fCursor + alignment - 1) & ~(alignment - 1);
+  if (fCursor == nullptr || at + size > (uintptr_t)fEnd) {
+    _AddBlock(size + alignment);
+    at = ((uintptr_t)fCursor + alignment - 1) & ~(alignment - 1);
+  }
+
+  fCursor = (char *)(at + size);
+  fUsed += size;
+  return (void *)at;
+}
+
+char *Arena::CopyString(const char *data, size_t length) {
+  char *copy = static_cast<char *>(Allocate(length + 1, 1));
+  memcpy(copy, data, length);
+  copy[length] = '\0';
+  return copy;
+}
+
+/**
+ * @brief Frees all blocks, then keeps one that fits what was used.
+ *
+ * A single block keeps the next phase from spreading over several again;
+ * sizing it to the last phase lets the arena settle after one round.
+ */
+void Arena::Reset() {
+  if (fBlocks == nullptr)
+    return;
+
+  if (fBlocks->next == nullptr) {
+    fCursor = reinterpret_cast<char *>(fBlocks + 1);
+    fUsed = 0;
+    return;
+  }
+
+  // Leave room for the alignment padding between the allocations
+  const size_t wanted = fUsed + fUsed / 8;
+  _FreeBlocks();
+  _AddBlock(wanted);
+}
+
+void Arena::_AddBlock(size_t minimum) {
+  size_t size = fBlockSize;
+  while (size < minimum)
+    size *= 2;
+
+  Block *block = static_cast<Block *>(malloc(sizeof(Block) + size));
+  if (block == nullptr)
+    throw std::bad_alloc();
+  block->next = fBlocks;
+  block->size = size;
+  fBlocks = block;
+  fReserved += size;
+
+  fCursor = reinterpret_cast<char *>(block + 1);
+  fEnd = fCursor + size;
+}
+
+void Arena::_FreeBlocks() {
+  while (fBlocks) {
+    Block *next = fBlocks->next;
+    free(fBlocks);
+    fBlocks = next;
+  }
+  fCursor = fEnd = nullptr;
+  fUsed = 0;
+  fReserved = 0;
+}
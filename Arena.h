@@ -0,0 +1,64 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <SupportDefs.h>
+#include <cstddef>
+
+/**
+ * @class Arena
+ * @brief Bump allocator for data that dies all at once.
+ *
+ * Allocations are carved from large blocks and never freed one by one;
+ * Reset() drops everything in one go. Meant for phases that create many
+ * short-lived strings and buffers, such as parsing the tags of one file.
+ *
+ * After a Reset() the arena keeps a single block big enough for everything
+ * the last phase used, so a phase that repeats with similar sizes does not
+ * touch malloc() at all once it has warmed up. Not thread safe; use one
+ * arena per thread.
+ */
+class Arena {
+public:
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  explicit Arena(size_t blockSize = kDefaultBlockSize);
+  ~Arena();
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief Returns @p size bytes aligned to @p alignment (a power of two).
+   *
+   * Never fails except by throwing std::bad_alloc, like operator new. The
+   * memory is uninitialized and stays valid until the next Reset().
+   */
+  void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /** @brief Copies @p length bytes and appends a NUL. */
+  char *CopyString(const char *data, size_t length);
+
+  /** @brief Releases every allocation at once. */
+  void Reset();
+
+  /** @brief Bytes handed out since the last Reset(). */
+  size_t BytesUsed() const { return fUsed; }
+
+  /** @brief Bytes held in blocks, used or not. */
+  size_t BytesReserved() const { return fReserved; }
+
+private:
+  struct Block;
+
+  void _AddBlock(size_t minimum);
+  void _FreeBlocks();
+
+  Block *fBlocks = nullptr; ///< Newest first.
+  char *fCursor = nullptr;
+  char *fEnd = nullptr;
+  size_t fBlockSize;
+  size_t fUsed = 0;
+  size_t fReserved = 0;
+};
+
+#endif // ARENA_H
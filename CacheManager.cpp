@@ -1,452 +1,583 @@
-#include "CacheManager.h"
-#include "Debug.h"
-#include "MediaScanner.h"
-#include "Messages.h"
-#include <Directory.h>
-#include <Entry.h>
-#include <File.h>
-#include <FindDirectory.h>
-#include <Path.h>
-#include <algorithm>
-#include <fstream>
-#include <set>
-#include <string>
-#include <unistd.h>
-
-/**
- * @brief Helper to trim leading/trailing whitespace from a std::string.
- * @param s Input string.
- * @return Trimmed string.
- */
-static std::string Trim(std::string s) {
-  auto is_space = [](int c) {
-    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
-  };
-  s.erase(s.begin(), std::find_if(s.begin(), s.end(),
-                                  [&](int c) { return !is_space(c); }));
-  s.erase(
-      std::find_if(s.rbegin(), s.rend(), [&](int c) { return !is_space(c); })
-          .base(),
-      s.end());
-  return s;
-}
-
-/**
- * @brief Constructor.
- * Determines the path to the cache file (user settings) but does not load it
- * yet.
- */
-CacheManager::CacheManager(const BMessenger &target)
-    : BLooper("CacheManager"), fTarget(target) {
-  BPath settingsPath;
-  find_directory(B_USER_SETTINGS_DIRECTORY, &settingsPath);
-  settingsPath.Append("BeTon/media.cache");
-  fCachePath = settingsPath.Path();
-}
-
-/**
- * @brief Loads the list of watched directories from 'directories.txt'.
- * @param outDirs Vector to populate with directory paths.
- */
-void CacheManager::LoadDirectories(std::vector<BString> &outDirs) {
-  BPath p;
-  find_directory(B_USER_SETTINGS_DIRECTORY, &p);
-  p.Append("BeTon/directories.txt");
-
-  std::ifstream in(p.Path());
-  if (!in.is_open())
-    return;
-
-  std::string line;
-  while (std::getline(in, line)) {
-    line = Trim(line);
-    if (line.empty() || line[0] == '#')
-      continue;
-    outDirs.emplace_back(line.c_str());
-  }
-}
-
-/**
- * @brief Triggers a full rescan of all configured directories.
- *
- * Scanning Process:
- * 1. Remove entries that belong to directories no longer monitored.
- * 2. Start Scanners for each directory.
- * 3. Mark existing known files as missing if they are gone from disk (quick
- * check).
- *
- * Note: Real sync happens via Scanners reporting back.
- */
-void CacheManager::StartScan() {
-  std::vector<BString> dirs;
-  LoadDirectories(dirs);
-
-  // 1. Remove entries that belong to directories no longer monitored
-  std::set<BString> validBases(dirs.begin(), dirs.end());
-
-  for (auto it = fEntries.begin(); it != fEntries.end();) {
-    const MediaItem &e = it->second;
-    if (validBases.find(e.base) == validBases.end()) {
-      it = fEntries.erase(it);
-    } else {
-      ++it;
-    }
-  }
-
-  // Notify UI that we are starting with the current known state
-  if (fTarget.IsValid()) {
-    BMessage update(MSG_CACHE_LOADED);
-    fTarget.SendMessage(&update);
-  }
-
-  // 2. Start Scanners
-  fActiveScanners = 0;
-  for (const auto &dirPath : dirs) {
-    entry_ref ref;
-    status_t s = get_ref_for_path(dirPath.String(), &ref);
-    if (s != B_OK) {
-      MarkBaseOffline(dirPath);
-      continue;
-    }
-
-    BDirectory dir(&ref);
-    if (dir.InitCheck() != B_OK) {
-      MarkBaseOffline(dirPath);
-      continue;
-    }
-
-    // Launch scanner. It will report back via
-    // MSG_MEDIA_ITEM_FOUND/MSG_SCAN_DONE
-    auto *scanner = new MediaScanner(ref, BMessenger(this), fTarget);
-    scanner->SetCache(fEntries);
-    scanner->Run();
-
-    BMessenger msgr(scanner);
-    msgr.SendMessage(MSG_START_SCAN);
-    fActiveScanners++;
-  }
-
-  // 3. Mark existing known files as missing if they are gone from disk
-  // NOTE: This is a quick check on the cache, the real sync happens via
-  // Scanners.
-  for (auto &kv : fEntries) {
-    const BString &path = kv.first;
-    MediaItem &entry = kv.second;
-
-    BEntry e(path.String());
-    if (!e.Exists() && !entry.missing) {
-      entry.missing = true;
-      DEBUG_PRINT("[CacheManager] Mark missing: %s\n", path.String());
-
-      if (fTarget.IsValid()) {
-        BMessage gone(MSG_MEDIA_ITEM_REMOVED);
-        gone.AddString("path", path);
-        fTarget.SendMessage(&gone);
-      }
-    }
-  }
-
-  // If no scanners were started (e.g. no dirs), finish immediately
-  if (fActiveScanners == 0) {
-    SaveCache();
-    if (fTarget.IsValid()) {
-      BMessage done(MSG_SCAN_DONE);
-      fTarget.SendMessage(&done);
-    }
-  }
-}
-
-/**
- * @brief Saves the current in-memory cache to disk.
- * The cache is flattened into a BMessage and saved to 'media.cache'.
- */
-void CacheManager::SaveCache() {
-  BMessage archive;
-  for (auto &[key, entry] : fEntries) {
-    BMessage item;
-    item.AddString("path", entry.path);
-    item.AddString("base", entry.base);
-    item.AddString("title", entry.title);
-    item.AddString("artist", entry.artist);
-    item.AddString("album", entry.album);
-    item.AddString("genre", entry.genre);
-    item.AddInt32("year", entry.year);
-    item.AddInt32("track", entry.track);
-    item.AddInt32("disc", entry.disc);
-    item.AddInt32("duration", entry.duration);
-    item.AddInt32("bitrate", entry.bitrate);
-    item.AddInt64("size", entry.size);
-    item.AddInt64("mtime", entry.mtime);
-    item.AddInt64("inode", entry.inode);
-    item.AddBool("missing", entry.missing);
-
-    item.AddBool("missing", entry.missing);
-
-    item.AddString("mbAlbumId", entry.mbAlbumId);
-    item.AddString("mbArtistId", entry.mbArtistId);
-    item.AddString("mbTrackId", entry.mbTrackId);
-    archive.AddMessage("entry", &item);
-  }
-
-  BFile file(fCachePath, B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
-  if (file.InitCheck() == B_OK) {
-    archive.Flatten(&file);
-    DEBUG_PRINT("[CacheManager] SaveCache: Saved to %s\n", fCachePath.String());
-  } else {
-    DEBUG_PRINT("[CacheManager] SaveCache: Failed to save to %s\n",
-                fCachePath.String());
-  }
-}
-
-/**
- * @brief Loads the cache from disk into memory.
- */
-void CacheManager::LoadCache() {
-  fEntries.clear();
-
-  BFile file(fCachePath, B_READ_ONLY);
-  if (file.InitCheck() != B_OK) {
-    DEBUG_PRINT("Kein Cache gefunden (%s)\n", fCachePath.String());
-    return;
-  }
-
-  BMessage archive;
-  if (archive.Unflatten(&file) != B_OK) {
-    DEBUG_PRINT("Konnte Cache nicht unflatten (%s)\n", fCachePath.String());
-    return;
-  }
-
-  MediaItem entry;
-  for (int32 i = 0;; i++) {
-    BMessage item;
-    if (archive.FindMessage("entry", i, &item) != B_OK)
-      break;
-
-    entry.path = item.GetString("path", "");
-    entry.base = item.GetString("base", "");
-    entry.title = item.GetString("title", "");
-    entry.artist = item.GetString("artist", "");
-    entry.album = item.GetString("album", "");
-    entry.genre = item.GetString("genre", "");
-    entry.year = item.GetInt32("year", 0);
-    entry.track = item.GetInt32("track", 0);
-    entry.disc = item.GetInt32("disc", 0);
-    entry.duration = item.GetInt32("duration", 0);
-    entry.bitrate = item.GetInt32("bitrate", 0);
-    entry.size = item.GetInt64("size", 0);
-    entry.mtime = item.GetInt64("mtime", 0);
-    entry.inode = item.GetInt64("inode", 0);
-    entry.missing = item.GetBool("missing", false);
-
-    entry.mbAlbumId = item.GetString("mbAlbumId", "");
-    entry.mbArtistId = item.GetString("mbArtistId", "");
-    entry.mbTrackId = item.GetString("mbTrackId", "");
-
-    fEntries[entry.path] = entry;
-  }
-
-  DEBUG_PRINT("[CacheManager] LoadCache: Loaded %zu items\n", fEntries.size());
-
-  if (fTarget.IsValid()) {
-    BMessage msg(MSG_CACHE_LOADED);
-    fTarget.SendMessage(&msg);
-  }
-}
-
-/**
- * @brief Returns a copy of all current media items.
- * @return std::vector<MediaItem>
- */
-std::vector<MediaItem> CacheManager::AllEntries() const {
-  std::vector<MediaItem> out;
-  out.reserve(fEntries.size());
-
-  for (const auto &kv : fEntries) {
-    out.push_back(kv.second);
-  }
-  return out;
-}
-
-/**
- * @brief Main message loop for the CacheManager looper.
- * Handles loading, batch updates, and scanning notifications.
- */
-void CacheManager::MessageReceived(BMessage *msg) {
-  switch (msg->what) {
-  case MSG_LOAD_CACHE:
-    DEBUG_PRINT("[CacheManager] Asynchronous cache load started\\n");
-    LoadCache();
-    break;
-
-  case MSG_MEDIA_BATCH: {
-    type_code type;
-    int32 count = 0;
-    if (msg->GetInfo("path", &type, &count) != B_OK)
-      break;
-
-    const char *baseStr = nullptr;
-    msg->FindString("base", &baseStr);
-
-    for (int32 i = 0; i < count; i++) {
-      MediaItem e;
-      if (baseStr)
-        e.base = baseStr;
-
-      const char *tmp = nullptr;
-      if (msg->FindString("path", i, &tmp) == B_OK)
-        e.path = tmp;
-      if (msg->FindString("title", i, &tmp) == B_OK)
-        e.title = tmp;
-      if (msg->FindString("artist", i, &tmp) == B_OK)
-        e.artist = tmp;
-      if (msg->FindString("album", i, &tmp) == B_OK)
-        e.album = tmp;
-      if (msg->FindString("genre", i, &tmp) == B_OK)
-        e.genre = tmp;
-
-      msg->FindInt32("year", i, &e.year);
-      msg->FindInt32("track", i, &e.track);
-      msg->FindInt32("disc", i, &e.disc);
-      msg->FindInt32("duration", i, &e.duration);
-      msg->FindInt32("bitrate", i, &e.bitrate);
-      msg->FindInt64("size", i, &e.size);
-      msg->FindInt64("mtime", i, &e.mtime);
-      msg->FindInt64("inode", i, &e.inode);
-
-      if (msg->FindString("mbAlbumId", i, &tmp) == B_OK)
-        e.mbAlbumId = tmp;
-      if (msg->FindString("mbArtistId", i, &tmp) == B_OK)
-        e.mbArtistId = tmp;
-      if (msg->FindString("mbTrackId", i, &tmp) == B_OK)
-        e.mbTrackId = tmp;
-
-      AddOrUpdateEntry(e);
-    }
-
-    DEBUG_PRINT("[CacheManager] Processed batch of %d items\n", (int)count);
-
-    if (fTarget.IsValid())
-      fTarget.SendMessage(msg);
-    break;
-  }
-
-  case MSG_MEDIA_ITEM_FOUND: {
-    MediaItem e;
-    const char *tmpStr = nullptr;
-
-    if (msg->FindString("path", &tmpStr) == B_OK)
-      e.path = tmpStr;
-    if (msg->FindString("base", &tmpStr) == B_OK)
-      e.base = tmpStr;
-    if (msg->FindString("title", &tmpStr) == B_OK)
-      e.title = tmpStr;
-    if (msg->FindString("artist", &tmpStr) == B_OK)
-      e.artist = tmpStr;
-    if (msg->FindString("album", &tmpStr) == B_OK)
-      e.album = tmpStr;
-    if (msg->FindString("genre", &tmpStr) == B_OK)
-      e.genre = tmpStr;
-
-    msg->FindInt32("year", &e.year);
-    msg->FindInt32("track", &e.track);
-    msg->FindInt32("disc", &e.disc);
-    msg->FindInt32("duration", &e.duration);
-    msg->FindInt32("bitrate", &e.bitrate);
-    msg->FindInt64("size", &e.size);
-    msg->FindInt64("mtime", &e.mtime);
-    msg->FindInt64("inode", &e.inode);
-
-    if (msg->FindString("mbAlbumId", &tmpStr) == B_OK)
-      e.mbAlbumId = tmpStr;
-    if (msg->FindString("mbArtistId", &tmpStr) == B_OK)
-      e.mbArtistId = tmpStr;
-    if (msg->FindString("mbTrackId", &tmpStr) == B_OK)
-      e.mbTrackId = tmpStr;
-
-    AddOrUpdateEntry(e);
-
-    SaveCache();
-
-    DEBUG_PRINT("[CacheManager] Item found: path=%s, title=%s\n",
-                e.path.String(), e.title.String());
-
-    if (fTarget.IsValid())
-      fTarget.SendMessage(msg);
-    break;
-  }
-
-  case MSG_REGISTER_TARGET: {
-    BMessenger newTarget;
-    if (msg->FindMessenger("target", &newTarget) == B_OK) {
-      fTarget = newTarget;
-      DEBUG_PRINT("[CacheManager] UI target registered\n");
-    }
-    break;
-  }
-  case MSG_RESCAN:
-    DEBUG_PRINT("[CacheManager] received MSG_RESCAN, starting new scan\n");
-    StartScan();
-    break;
-
-  case MSG_SCAN_DONE: {
-    DEBUG_PRINT("[CacheManager] received MSG_SCAN_DONE (scanners left: %d)\\n",
-                fActiveScanners - 1);
-
-    if (--fActiveScanners <= 0) {
-      DEBUG_PRINT(
-          "[CacheManager] all scanners finished, writing media.cache\\n");
-      SaveCache();
-
-      if (fTarget.IsValid()) {
-        DEBUG_PRINT("[CacheManager] forward MSG_SCAN_DONE to MainWindow\\n");
-        BMessage done(MSG_SCAN_DONE);
-        fTarget.SendMessage(&done);
-      }
-    }
-    break;
-  }
-
-  default:
-    BLooper::MessageReceived(msg);
-  }
-}
-
-/**
- * @brief Updates or inserts a media item into the internal map.
- * Also checks for potential conflicts or data integrity issues (warns on DB ID
- * loss).
- * @param entry The item to store.
- */
-void CacheManager::AddOrUpdateEntry(const MediaItem &entry) {
-  auto it = fEntries.find(entry.path);
-  if (it == fEntries.end()) {
-    fEntries[entry.path] = entry;
-
-  } else {
-    const MediaItem &old = it->second;
-    if (!old.mbTrackId.IsEmpty() && entry.mbTrackId.IsEmpty()) {
-      DEBUG_PRINT("[CacheManager] WARNING: Overwriting existing MB Track ID "
-                  "for %s with empty value!\n",
-                  entry.path.String());
-    }
-    fEntries[entry.path] = entry;
-  }
-}
-
-/**
- * @brief Marks all entries belonging to a specific base path as "missing".
- * This is used when a configured directory is not found/mounted.
- */
-void CacheManager::MarkBaseOffline(const BString &basePath) {
-  for (auto &kv : fEntries) {
-    if (kv.first.StartsWith(basePath)) {
-      kv.second.missing = true;
-    }
-  }
-
-  if (fTarget.IsValid()) {
-    BMessage off(MSG_BASE_OFFLINE);
-    off.AddString("base", basePath);
-    fTarget.SendMessage(&off);
-  }
-}
+#include "CacheManager.h"
+#include "Debug.h"
+#include "MediaBatch.h"
+#include "MediaScanner.h"
+#include "Messages.h"
+#include "MetricsRegistry.h"
+#include "Trace.h"
+#include <Directory.h>
+#include <Entry.h>
+#include <File.h>
+#include <FindDirectory.h>
+#include <Path.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#include <unistd.h>
+
+/**
+ * @brief Helper to trim leading/trailing whitespace from a std::string.
+ * @param s Input string.
+ * @return Trimmed string.
+ */
+static std::string Trim(std::string s) {
+  auto is_space = [](int c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  };
+  s.erase(s.begin(), std::find_if(s.begin(), s.end(),
+                                  [&](int c) { return !is_space(c); }));
+  s.erase(
+      std::find_if(s.rbegin(), s.rend(), [&](int c) { return !is_space(c); })
+          .base(),
+      s.end());
+  return s;
+}
+
+/**
+ * @brief Constructor.
+ * Determines the path to the cache file (user settings, unless given) but
+ * does not load it yet.
+ */
+CacheManager::CacheManager(const BMessenger &target, const char *cachePath)
+    : BLooper("CacheManager"), fTarget(target),
+      fQueuedBatches(std::make_shared<std::atomic<int32>>(0)),
+      fIOGovernor(std::make_shared<ScanIOGovernor>()) {
+  if (cachePath) {
+    fCachePath = cachePath;
+    fJournalPath = fCachePath;
+    fJournalPath << ".journal";
+    fCheckpointPath = fCachePath;
+    fCheckpointPath << ".checkpoint";
+    return;
+  }
+
+  BPath settingsPath;
+  find_directory(B_USER_SETTINGS_DIRECTORY, &settingsPath);
+  settingsPath.Append("BeTon/media.cache");
+  fCachePath = settingsPath.Path();
+  fJournalPath = fCachePath;
+  fJournalPath << ".journal";
+
+  BPath checkpointPath;
+  find_directory(B_USER_SETTINGS_DIRECTORY, &checkpointPath);
+  checkpointPath.Append("BeTon/scan.checkpoint");
+  fCheckpointPath = checkpointPath.Path();
+}
+
+/**
+ * @brief Loads the checkpoints of scans that did not finish last time.
+ */
+void CacheManager::LoadCheckpoints() {
+  fCheckpoints.clear();
+
+  BFile file(fCheckpointPath, B_READ_ONLY);
+  if (file.InitCheck() != B_OK)
+    return;
+
+  BMessage archive;
+  if (archive.Unflatten(&file) != B_OK)
+    return;
+
+  BMessage checkpoint;
+  for (int32 i = 0; archive.FindMessage("checkpoint", i, &checkpoint) == B_OK;
+       i++) {
+    const char *base = nullptr;
+    if (checkpoint.FindString("base", &base) == B_OK)
+      fCheckpoints[base] = checkpoint;
+  }
+
+  DEBUG_PRINT("[CacheManager] Loaded %zu scan checkpoints\n",
+              fCheckpoints.size());
+}
+
+/**
+ * @brief Writes all pending checkpoints, or removes the file if none are left.
+ */
+void CacheManager::SaveCheckpoints() {
+  if (fCheckpoints.empty()) {
+    BEntry(fCheckpointPath.String()).Remove();
+    return;
+  }
+
+  TRACE_SCOPE("cache", "SaveCheckpoints");
+  BMessage archive;
+  for (const auto &[base, checkpoint] : fCheckpoints)
+    archive.AddMessage("checkpoint", &checkpoint);
+
+  BFile file(fCheckpointPath, B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+  if (file.InitCheck() == B_OK)
+    archive.Flatten(&file);
+}
+
+/**
+ * @brief Loads the traversal options from 'scan.settings'.
+ *
+ * A missing or unreadable file leaves every option at its default.
+ */
+void CacheManager::LoadScanSettings() {
+  fScanSettings.MakeEmpty();
+
+  BPath p;
+  if (find_directory(B_USER_SETTINGS_DIRECTORY, &p) != B_OK)
+    return;
+  p.Append("BeTon/scan.settings");
+
+  BFile file(p.Path(), B_READ_ONLY);
+  if (file.InitCheck() == B_OK && fScanSettings.Unflatten(&file) != B_OK)
+    fScanSettings.MakeEmpty();
+}
+
+/**
+ * @brief Loads the list of watched directories from 'directories.txt'.
+ *
+ * Indented lines below a directory are options for it (see ScanFilter);
+ * they are compiled into one filter per directory.
+ * @param outDirs Vector to populate with directory paths.
+ * @param outFilters Receives the filter of every directory.
+ */
+void CacheManager::LoadDirectories(std::vector<BString> &outDirs,
+                                   std::map<BString, ScanFilter> &outFilters) {
+  BPath p;
+  find_directory(B_USER_SETTINGS_DIRECTORY, &p);
+  p.Append("BeTon/directories.txt");
+
+  std::ifstream in(p.Path());
+  if (!in.is_open())
+    return;
+
+  std::string line;
+  ScanFilter *filter = nullptr;
+  while (std::getline(in, line)) {
+    const bool option = !line.empty() && (line[0] == ' ' || line[0] == '\t');
+    line = Trim(line);
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    if (option) {
+      if (!filter || !filter->ParseOption(line.c_str()))
+        DEBUG_PRINT("[CacheManager] Ignoring option '%s'\n", line.c_str());
+      continue;
+    }
+
+    outDirs.emplace_back(line.c_str());
+    filter = &outFilters[outDirs.back()];
+  }
+}
+
+/**
+ * @brief Triggers a full rescan of all configured directories.
+ *
+ * Reads 'directories.txt' and 'scan.settings', then scans as below.
+ */
+void CacheManager::StartScan() {
+  std::vector<BString> dirs;
+  std::map<BString, ScanFilter> filters;
+  LoadDirectories(dirs, filters);
+  LoadScanSettings();
+  StartScan(dirs, filters);
+}
+
+/**
+ * @brief Scans the given directories.
+ *
+ * Scanning Process:
+ * 1. Remove entries that belong to directories no longer monitored.
+ * 2. Start Scanners for each directory, resuming from a saved checkpoint
+ * where the previous scan of that directory was interrupted.
+ * 3. Mark existing known files as missing if they are gone from disk (quick
+ * check).
+ *
+ * Note: Real sync happens via Scanners reporting back.
+ */
+void CacheManager::StartScan(const std::vector<BString> &dirs,
+                             std::map<BString, ScanFilter> &filters) {
+  fIOGovernor->SetLimits(fScanSettings.GetInt64("io_bytes_per_sec", 0),
+                         fScanSettings.GetInt32("io_ops_per_sec", 0));
+
+  // 1. Remove entries that belong to directories no longer monitored
+  std::set<BString> validBases(dirs.begin(), dirs.end());
+  fStore.RemoveOtherBases(validBases);
+
+  LoadCheckpoints();
+  for (auto it = fCheckpoints.begin(); it != fCheckpoints.end();) {
+    if (validBases.find(it->first) == validBases.end())
+      it = fCheckpoints.erase(it);
+    else
+      ++it;
+  }
+
+  // Notify UI that we are starting with the current known state
+  if (fTarget.IsValid()) {
+    BMessage update(MSG_CACHE_LOADED);
+    fTarget.SendMessage(&update);
+  }
+
+  // 2. Start Scanners
+  fActiveScanners = 0;
+  for (const auto &dirPath : dirs) {
+    entry_ref ref;
+    status_t s = get_ref_for_path(dirPath.String(), &ref);
+    if (s != B_OK) {
+      MarkBaseOffline(dirPath);
+      continue;
+    }
+
+    BDirectory dir(&ref);
+    if (dir.InitCheck() != B_OK) {
+      MarkBaseOffline(dirPath);
+      continue;
+    }
+
+    // Launch scanner. It will report back via
+    // MSG_MEDIA_ITEM_FOUND/MSG_SCAN_DONE
+    auto *scanner = new MediaScanner(ref, BMessenger(this), fTarget);
+    scanner->SetCache(fStore.Entries());
+    scanner->SetBatchQueueCounter(fQueuedBatches);
+    scanner->SetIOGovernor(fIOGovernor);
+    scanner->SetFollowLinks(fScanSettings.GetBool("follow_links", true));
+    scanner->SetParserHelpers(fScanSettings.GetInt32("parser_helpers", 0));
+    scanner->SetQuarantine(fStore.Quarantine());
+    scanner->SetFilter(filters[dirPath]);
+
+    auto checkpoint = fCheckpoints.find(dirPath);
+    if (checkpoint != fCheckpoints.end())
+      scanner->SetResumeState(checkpoint->second);
+    scanner->Run();
+
+    BMessenger msgr(scanner);
+    msgr.SendMessage(MSG_START_SCAN);
+    fActiveScanners++;
+  }
+
+  // 3. Mark existing known files as missing if they are gone from disk
+  // NOTE: This is a quick check on the cache, the real sync happens via
+  // Scanners.
+  std::vector<BString> missing;
+  fStore.MarkMissingFiles(&missing);
+  for (const BString &path : missing) {
+    DEBUG_PRINT("[CacheManager] Mark missing: %s\n", path.String());
+
+    if (fTarget.IsValid()) {
+      BMessage gone(MSG_MEDIA_ITEM_REMOVED);
+      gone.AddString("path", path);
+      fTarget.SendMessage(&gone);
+    }
+  }
+
+  // If no scanners were started (e.g. no dirs), finish immediately
+  if (fActiveScanners == 0) {
+    SaveCache();
+    SaveCheckpoints();
+    if (fTarget.IsValid()) {
+      BMessage done(MSG_SCAN_DONE);
+      fTarget.SendMessage(&done);
+    }
+  }
+}
+
+/**
+ * @brief Saves the current in-memory cache to disk.
+ * The store writes 'media.cache' in its own format (see LibraryStore). The
+ * journal of the checkpoints is then part of the cache and is removed.
+ */
+void CacheManager::SaveCache() {
+  TRACE_SCOPE_ARG("cache", "SaveCache", "entries", fStore.Entries().size());
+  const bigtime_t start = system_time();
+  if (fStore.Save(fCachePath.String()) == B_OK) {
+    MetricsRegistry::Default()
+        .Gauge("cache.save_ms", "ms")
+        ->Set((system_time() - start) / 1000.0);
+    DEBUG_PRINT("[CacheManager] SaveCache: Saved to %s\n", fCachePath.String());
+    BEntry(fJournalPath.String()).Remove();
+    fJournalPaths.clear();
+  } else {
+    DEBUG_PRINT("[CacheManager] SaveCache: Failed to save to %s\n",
+                fCachePath.String());
+  }
+  PublishMetrics();
+}
+
+/**
+ * @brief Loads the cache from disk into memory.
+ *
+ * Every chunk is forwarded to the UI as MSG_CACHE_CHUNK as soon as it is
+ * stored, so browsing can start on part of the library. MSG_CACHE_LOADED
+ * follows, with "streamed" set if the chunks carried every entry. The
+ * journal of an interrupted scan is applied on top of the cache; since its
+ * changes are not in the chunks, "streamed" is never set when there is one,
+ * and the window takes the whole library instead. It is
+ * sent even without a usable cache, so the window replaces its startup
+ * snapshot with the (empty) library.
+ */
+void CacheManager::LoadCache() {
+  TRACE_SCOPE("cache", "LoadCache");
+  const bigtime_t start = system_time();
+  int32 forwarded = 0;
+  auto forward = [&](const MediaBatchReader &chunk, int32 loaded,
+                     int32 total) {
+    if (!fTarget.IsValid())
+      return;
+    BMessage msg(MSG_CACHE_CHUNK);
+    msg.AddData(kMediaBatchField, B_RAW_TYPE, chunk.Data(), chunk.Size());
+    msg.AddInt32("loaded", loaded);
+    msg.AddInt32("total", total);
+    if (fTarget.SendMessage(&msg) == B_OK)
+      forwarded += chunk.CountItems();
+  };
+
+  status_t status = fStore.Load(fCachePath.String(), forward);
+  if (status == B_ENTRY_NOT_FOUND) {
+    DEBUG_PRINT("Kein Cache gefunden (%s)\n", fCachePath.String());
+  } else if (status != B_OK) {
+    DEBUG_PRINT("Konnte Cache nicht laden (%s): %s\n", fCachePath.String(),
+                strerror(status));
+  } else {
+    DEBUG_PRINT("[CacheManager] LoadCache: Loaded %zu items\n",
+                fStore.Entries().size());
+    MetricsRegistry::Default()
+        .Gauge("cache.load_ms", "ms")
+        ->Set((system_time() - start) / 1000.0);
+    PublishMetrics();
+  }
+
+  // Also after a first scan that was interrupted before any cache existed
+  const size_t cached = fStore.Entries().size();
+  const bool journaled =
+      fStore.ApplyJournal(fJournalPath.String()) != B_ENTRY_NOT_FOUND;
+  if (journaled) {
+    DEBUG_PRINT("[CacheManager] LoadCache: Journal added %zu items\n",
+                fStore.Entries().size() - cached);
+  }
+
+  if (fTarget.IsValid()) {
+    // A journal may update entries the chunks already carried, without
+    // changing their number, so the chunks are only complete without one
+    BMessage msg(MSG_CACHE_LOADED);
+    msg.AddBool("streamed", status == B_OK && !journaled && forwarded > 0 &&
+                                forwarded == (int32)fStore.Entries().size());
+    fTarget.SendMessage(&msg);
+  }
+}
+
+/**
+ * @brief Returns a copy of all current media items.
+ * @return std::vector<MediaItem>
+ */
+std::vector<MediaItem> CacheManager::AllEntries() const {
+  TRACE_SCOPE_ARG("cache", "AllEntries", "entries", fStore.Entries().size());
+  return fStore.AllEntries();
+}
+
+/**
+ * @brief Main message loop for the CacheManager looper.
+ * Handles loading, batch updates, and scanning notifications.
+ */
+void CacheManager::MessageReceived(BMessage *msg) {
+  switch (msg->what) {
+  case MSG_LOAD_CACHE:
+    DEBUG_PRINT("[CacheManager] Asynchronous cache load started\\n");
+    LoadCache();
+    break;
+
+  case MSG_MEDIA_BATCH: {
+    fQueuedBatches->fetch_sub(1);
+
+    MediaBatchReader batch;
+    if (batch.SetTo(msg) != B_OK)
+      break;
+
+    const char *baseStr = nullptr;
+    msg->FindString("base", &baseStr);
+
+    TRACE_SCOPE_ARG("cache", "MediaBatch", "items", batch.CountItems());
+    const int32 count = fStore.AddBatch(batch, baseStr);
+    for (int32 i = 0; i < count; i++)
+      fJournalPaths.push_back(batch.PathAt(i));
+
+    DEBUG_PRINT("[CacheManager] Processed batch of %d items\n", (int)count);
+    MetricsRegistry::Default()
+        .Gauge("cache.entries", "items")
+        ->Set(fStore.Entries().size());
+
+    if (fTarget.IsValid())
+      fTarget.SendMessage(msg);
+    break;
+  }
+
+  case MSG_MEDIA_ITEM_FOUND: {
+    MediaItem e;
+    const char *tmpStr = nullptr;
+
+    if (msg->FindString("path", &tmpStr) == B_OK) {
+      // Tag edits only carry the changed fields; keep everything else
+      if (const MediaItem *existing = fStore.Find(tmpStr))
+        e = *existing;
+      e.path = tmpStr;
+    }
+    if (msg->FindString("base", &tmpStr) == B_OK)
+      e.base = tmpStr;
+    if (msg->FindString("title", &tmpStr) == B_OK)
+      e.title = tmpStr;
+    if (msg->FindString("artist", &tmpStr) == B_OK)
+      e.artist = tmpStr;
+    if (msg->FindString("album", &tmpStr) == B_OK)
+      e.album = tmpStr;
+    if (msg->FindString("genre", &tmpStr) == B_OK)
+      e.genre = tmpStr;
+    if (msg->FindString("albumArtist", &tmpStr) == B_OK)
+      e.albumArtist = tmpStr;
+    if (msg->FindString("composer", &tmpStr) == B_OK)
+      e.composer = tmpStr;
+    if (msg->FindString("comment", &tmpStr) == B_OK)
+      e.comment = tmpStr;
+
+    msg->FindInt32("year", &e.year);
+    msg->FindInt32("track", &e.track);
+    msg->FindInt32("trackTotal", &e.trackTotal);
+    msg->FindInt32("disc", &e.disc);
+    msg->FindInt32("discTotal", &e.discTotal);
+    msg->FindInt32("duration", &e.duration);
+    msg->FindInt32("bitrate", &e.bitrate);
+    msg->FindInt32("sampleRate", &e.sampleRate);
+    msg->FindInt32("channels", &e.channels);
+    msg->FindInt64("size", &e.size);
+    msg->FindInt64("mtime", &e.mtime);
+    msg->FindInt64("inode", &e.inode);
+
+    if (msg->FindString("mbAlbumId", &tmpStr) == B_OK ||
+        msg->FindString("mbAlbumID", &tmpStr) == B_OK)
+      e.mbAlbumId = tmpStr;
+    if (msg->FindString("mbArtistId", &tmpStr) == B_OK ||
+        msg->FindString("mbArtistID", &tmpStr) == B_OK)
+      e.mbArtistId = tmpStr;
+    if (msg->FindString("mbTrackId", &tmpStr) == B_OK ||
+        msg->FindString("mbTrackID", &tmpStr) == B_OK)
+      e.mbTrackId = tmpStr;
+
+    DEBUG_PRINT("[CacheManager] Item found: path=%s, title=%s\n",
+                e.path.String(), e.title.String());
+
+    fStore.AddOrUpdate(std::move(e));
+
+    SaveCache();
+
+    if (fTarget.IsValid())
+      fTarget.SendMessage(msg);
+    break;
+  }
+
+  case MSG_REGISTER_TARGET: {
+    BMessenger newTarget;
+    if (msg->FindMessenger("target", &newTarget) == B_OK) {
+      fTarget = newTarget;
+      DEBUG_PRINT("[CacheManager] UI target registered\n");
+    }
+    break;
+  }
+  case MSG_RESCAN:
+    DEBUG_PRINT("[CacheManager] received MSG_RESCAN, starting new scan\n");
+    StartScan();
+    break;
+
+  case MSG_SCAN_CHECKPOINT: {
+    const char *base = nullptr;
+    if (msg->FindString("base", &base) != B_OK)
+      break;
+
+    // All batches sent before the checkpoint have already been applied, so
+    // cache, journal and checkpoint describe the same state once the changes
+    // since the last checkpoint are appended.
+    BMessage checkpoint(*msg);
+    checkpoint.what = 0;
+    fCheckpoints[base] = checkpoint;
+
+    TRACE_SCOPE_ARG("cache", "AppendJournal", "items", fJournalPaths.size());
+    if (fStore.AppendJournal(fJournalPath.String(), fJournalPaths) == B_OK) {
+      fJournalPaths.clear();
+    } else {
+      DEBUG_PRINT("[CacheManager] Could not append to %s\n",
+                  fJournalPath.String());
+    }
+    SaveCheckpoints();
+    break;
+  }
+
+  case MSG_SCAN_FILE_FAILED: {
+    const char *path = nullptr;
+    if (msg->FindString("path", &path) != B_OK)
+      break;
+
+    // Stored with the next checkpoint or SaveCache(), like the entries
+    QuarantinedFile bad;
+    bad.size = msg->GetInt64("size", 0);
+    bad.mtime = msg->GetInt64("mtime", 0);
+    bad.reason = msg->GetString("reason", "");
+    fStore.AddToQuarantine(path, bad);
+    fJournalPaths.push_back(path);
+    DEBUG_PRINT("[CacheManager] Quarantined %s (%s)\n", path,
+                bad.reason.String());
+    break;
+  }
+
+  case MSG_SCAN_DONE: {
+    const char *finishedBase = nullptr;
+    if (msg->FindString("base", &finishedBase) == B_OK &&
+        fCheckpoints.erase(finishedBase) > 0)
+      SaveCheckpoints();
+
+    DEBUG_PRINT("[CacheManager] received MSG_SCAN_DONE (scanners left: %d)\\n",
+                fActiveScanners - 1);
+
+    if (--fActiveScanners <= 0) {
+      DEBUG_PRINT(
+          "[CacheManager] all scanners finished, writing media.cache\\n");
+      SaveCache();
+
+      if (fTarget.IsValid()) {
+        DEBUG_PRINT("[CacheManager] forward MSG_SCAN_DONE to MainWindow\\n");
+        BMessage done(MSG_SCAN_DONE);
+        fTarget.SendMessage(&done);
+      }
+    }
+    break;
+  }
+
+  default:
+    BLooper::MessageReceived(msg);
+  }
+}
+
+int32 CacheManager::Compact() {
+  int32 removed = fStore.Compact();
+  PublishMetrics();
+  return removed;
+}
+
+/**
+ * @brief Updates the cache.entries and memory.cache metrics.
+ *
+ * Walks all entries, so it runs after loading, saving and compacting rather
+ * than for every batch.
+ */
+void CacheManager::PublishMetrics() {
+  MetricsRegistry &metrics = MetricsRegistry::Default();
+  metrics.Gauge("cache.entries", "items")->Set(fStore.Entries().size());
+  metrics.Gauge("memory.cache", "MB")
+      ->Set(fStore.MemoryUsage() / (1024.0 * 1024.0));
+}
+
+/**
+ * @brief Marks all entries belonging to a specific base path as "missing".
+ * This is used when a configured directory is not found/mounted.
+ */
+void CacheManager::MarkBaseOffline(const BString &basePath) {
+  fStore.MarkMissingBelow(basePath);
+
+  if (fTarget.IsValid()) {
+    BMessage off(MSG_BASE_OFFLINE);
+    off.AddString("base", basePath);
+    fTarget.SendMessage(&off);
+  }
+}
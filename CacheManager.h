@@ -1,73 +1,153 @@
-#ifndef CACHE_MANAGER_H
-#define CACHE_MANAGER_H
-
-#include "MediaItem.h"
-#include "Messages.h"
-#include <Looper.h>
-#include <Messenger.h>
-#include <String.h>
-#include <map>
-#include <vector>
-
-/**
- * @class CacheManager
- * @brief Manages the central media library cache.
- *
- * The CacheManager is responsible for:
- * - Loading and saving the 'media.cache' file.
- * - Coordinating the scanning process (via MediaScanner).
- * - Maintaining the in-memory state of all known media files (fEntries).
- * - Notifying the UI about progress and updates.
- *
- * It runs as a BLooper to handle asynchronous messages.
- */
-class CacheManager : public BLooper {
-public:
-  /**
-   * @brief Construct a new Cache Manager object
-   *
-   * @param target The target messenger (usually MainWindow) to receive
-   * notifications.
-   */
-  CacheManager(const BMessenger &target);
-
-  /**
-   * @brief Loads the cache from disk.
-   */
-  void LoadCache();
-
-  /**
-   * @brief Saves the current cache to disk.
-   */
-  void SaveCache();
-
-  /**
-   * @brief Starts the scanning process for all configured directories.
-   */
-  void StartScan();
-
-  void MessageReceived(BMessage *msg) override;
-
-  const std::map<BString, MediaItem> &Entries() const { return fEntries; }
-
-  /**
-   * @brief Returns a flattened vector of all media items.
-   * Useful for UI population.
-   */
-  std::vector<MediaItem> AllEntries() const;
-
-private:
-  void AddOrUpdateEntry(const MediaItem &entry);
-  void LoadDirectories(std::vector<BString> &outDirs);
-  void MarkBaseOffline(const BString &basePath);
-
-  /** @name Data */
-  ///@{
-  std::map<BString, MediaItem> fEntries;
-  BMessenger fTarget;
-  BString fCachePath;
-  int32 fActiveScanners{0};
-  ///@}
-};
-
-#endif // CACHE_MANAGER_H
+#ifndef CACHE_MANAGER_H
+#define CACHE_MANAGER_H
+
+#include "LibraryStore.h"
+#include "MediaItem.h"
+#include "Messages.h"
+#include "ScanFilter.h"
+#include "ScanIOGovernor.h"
+#include <Looper.h>
+#include <Messenger.h>
+#include <String.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @class CacheManager
+ * @brief Manages the central media library cache.
+ *
+ * The CacheManager is responsible for:
+ * - Loading and saving the 'media.cache' file.
+ * - Persisting checkpoints of unfinished scans ('scan.checkpoint') so they
+ *   can be resumed, together with the entries scanned since the last
+ *   checkpoint ('media.cache.journal') rather than the whole cache.
+ * - Applying the traversal options and I/O limits from 'scan.settings' to
+ *   every scanner.
+ * - Keeping the quarantine of files that crashed or hung the tag parser,
+ *   stored in 'media.cache' next to the entries.
+ * - Coordinating the scanning process (via MediaScanner).
+ * - Maintaining the in-memory state of all known media files (fStore).
+ * - Notifying the UI about progress and updates.
+ *
+ * It runs as a BLooper to handle asynchronous messages.
+ */
+class CacheManager : public BLooper {
+public:
+  /**
+   * @brief Construct a new Cache Manager object
+   *
+   * @param target The target messenger (usually MainWindow) to receive
+   * notifications.
+   * @param cachePath Cache file to use instead of the one in the user
+   * settings; scan checkpoints are then kept next to it.
+   */
+  CacheManager(const BMessenger &target, const char *cachePath = nullptr);
+
+  /**
+   * @brief Loads the cache from disk.
+   */
+  void LoadCache();
+
+  /**
+   * @brief Saves the current cache to disk.
+   */
+  void SaveCache();
+
+  /**
+   * @brief Starts the scanning process for all configured directories.
+   */
+  void StartScan();
+
+  /**
+   * @brief Scans @p dirs with the current scan settings.
+   *
+   * Entries of other directories are removed from the cache. Must be called
+   * with the looper locked.
+   * @param dirs Root directories to scan.
+   * @param filters Filter of every root; roots without one are unfiltered.
+   */
+  void StartScan(const std::vector<BString> &dirs,
+                 std::map<BString, ScanFilter> &filters);
+
+  /**
+   * @brief Replaces the options read from 'scan.settings'.
+   *
+   * Used by the two-argument StartScan(), which does not read the file.
+   */
+  void SetScanSettings(const BMessage &settings) { fScanSettings = settings; }
+
+  /**
+   * @brief Drops entries marked missing and quarantine records of files that
+   * no longer exist.
+   * @return Number of removed entries and records.
+   */
+  int32 Compact();
+
+  void MessageReceived(BMessage *msg) override;
+
+  const std::map<BString, MediaItem> &Entries() const {
+    return fStore.Entries();
+  }
+
+  const std::map<BString, QuarantinedFile> &Quarantine() const {
+    return fStore.Quarantine();
+  }
+
+  /**
+   * @brief Returns a flattened vector of all media items.
+   * Useful for UI population.
+   */
+  std::vector<MediaItem> AllEntries() const;
+
+  /**
+   * @brief The I/O budget shared by all scanners.
+   *
+   * The playback controller reports to it so that scans back off while music
+   * plays.
+   */
+  std::shared_ptr<ScanIOGovernor> IOGovernor() const { return fIOGovernor; }
+
+private:
+  void LoadDirectories(std::vector<BString> &outDirs,
+                       std::map<BString, ScanFilter> &outFilters);
+  void MarkBaseOffline(const BString &basePath);
+  void LoadCheckpoints();
+  void SaveCheckpoints();
+  void LoadScanSettings();
+  void PublishMetrics();
+
+  /** @name Data */
+  ///@{
+  LibraryStore fStore; ///< Entries and quarantine.
+  BMessenger fTarget;
+  BString fCachePath;
+  BString fJournalPath;
+  /// Paths changed since the last checkpoint, appended to the journal.
+  std::vector<BString> fJournalPaths;
+  int32 fActiveScanners{0};
+  ///@}
+
+  /** @name Scan Checkpoints */
+  ///@{
+  /// Last MSG_SCAN_CHECKPOINT of every unfinished scan, keyed by root.
+  std::map<BString, BMessage> fCheckpoints;
+  BString fCheckpointPath;
+  ///@}
+
+  /** @name Scan Settings */
+  ///@{
+  /// Traversal options written by the DirectoryManagerWindow.
+  BMessage fScanSettings;
+  ///@}
+
+  /** @name Scanner Backpressure */
+  ///@{
+  /// Batches sent by scanners but not yet processed by this looper.
+  std::shared_ptr<std::atomic<int32>> fQueuedBatches;
+  std::shared_ptr<ScanIOGovernor> fIOGovernor;
+  ///@}
+};
+
+#endif // CACHE_MANAGER_H
@@ -1,90 +1,122 @@
-#ifndef CONTENT_COLUMN_VIEW_H
-#define CONTENT_COLUMN_VIEW_H
-
-#include "MediaItem.h"
-#include "Messages.h"
-#include <ColumnListView.h>
-#include <ColumnTypes.h>
-#include <MessageFilter.h>
-#include <PopUpMenu.h>
-#include <map>
-#include <vector>
-
-/**
- * @class ContentColumnView
- * @brief The main list view displaying the audio library.
- *
- * It supports:
- * - Multi-column display (Title, Artist, Album, etc.).
- * - Sorting by clicking column headers.
- * - Drag & Drop of items.
- * - Context menus.
- * - Asynchronous chunked loading to keep the UI responsive.
- * - Graying out missing files.
- */
-class ContentColumnView : public BColumnListView {
-public:
-  ContentColumnView(const char *name);
-  virtual ~ContentColumnView();
-
-  /**
-   * @brief Adds a single media item to the view.
-   */
-  void AddEntry(const MediaItem &mi);
-
-  /**
-   * @brief Adds a list of items asynchronously (chunked).
-   */
-  void AddEntries(const std::vector<MediaItem> &items);
-
-  void ClearEntries();
-  void RefreshScrollbars();
-
-  static constexpr uint32 kMsgShowCtx = MSG_SHOW_CONTEXT_MENU;
-
-  const MediaItem *SelectedItem() const;
-  const MediaItem *ItemAt(int32 index) const;
-  bool IsRowMissing(BRow *row) const;
-
-protected:
-  bool InitiateDrag(BPoint point, bool wasSelected) override;
-  void KeyDown(const char *bytes, int32 numBytes) override;
-  void MouseMoved(BPoint where, uint32 transit,
-                  const BMessage *dragMsg) override;
-
-  void AttachedToWindow() override;
-  void DetachedFromWindow() override;
-  void MessageReceived(BMessage *msg) override;
-
-private:
-  /** @name Filters */
-  ///@{
-  class RightClickFilter;
-  class DropFilter;
-  RightClickFilter *fRCFilter = nullptr;
-  DropFilter *fDropFilter = nullptr;
-  ///@}
-
-  void ShowContextMenu(BPoint screenWhere);
-  /**
-   * @note fRowMap seemed unused in the .cpp, but keeping declaration if needed
-   * later.
-   */
-  std::map<BRow *, MediaItem> fRowMap;
-
-  /** @name Chunked loading state */
-  ///@{
-  std::vector<MediaItem> fPendingItems;
-  size_t fPendingIndex = 0;
-  void _AddBatch(size_t count);
-  static constexpr uint32 kMsgChunkAdd = 'chnk';
-  ///@}
-
-  /** @name Internal drag-drop reordering */
-  ///@{
-  int32 fDragSourceIndex = -1;
-  BPoint fLastDropPoint;
-  ///@}
-};
-
-#endif
+#ifndef CONTENT_COLUMN_VIEW_H
+#define CONTENT_COLUMN_VIEW_H
+
+#include "MediaItem.h"
+#include "Messages.h"
+#include <ColumnListView.h>
+#include <ColumnTypes.h>
+#include <MessageFilter.h>
+#include <PopUpMenu.h>
+#include <map>
+#include <vector>
+
+/**
+ * @class ContentColumnView
+ * @brief The main list view displaying the audio library.
+ *
+ * It supports:
+ * - Multi-column display (Title, Artist, Album, etc.).
+ * - Sorting by clicking column headers.
+ * - Drag & Drop of items.
+ * - Context menus.
+ * - Asynchronous chunked loading to keep the UI responsive.
+ * - Graying out missing files.
+ */
+class ContentColumnView : public BColumnListView {
+public:
+  ContentColumnView(const char *name);
+  virtual ~ContentColumnView();
+
+  /**
+   * @brief Adds a single media item to the view.
+   *
+   * The row keeps the item; pass an rvalue to move it in instead of
+   * copying.
+   */
+  void AddEntry(MediaItem item);
+
+  /**
+   * @brief Adds a list of items asynchronously (chunked).
+   *
+   * The items are moved into their rows as the chunks are added.
+   */
+  void AddEntries(std::vector<MediaItem> &&items);
+
+  /** @brief Removes all rows, pending ones and the scroll target. */
+  void ClearEntries();
+  void RefreshScrollbars();
+
+  /**
+   * @brief Scrolls the row of @p path to the top as soon as AddEntries()
+   * has added it, and keeps it there while the remaining chunks come in.
+   *
+   * Used to restore the position of the startup snapshot, both for its own
+   * rows and once the real rows replace them. Set it after ClearEntries().
+   * @param offset Pixels of the row to scroll out at the top.
+   * @param left Horizontal scroll offset.
+   */
+  void SetScrollTarget(const BString &path, float offset = 0, float left = 0);
+
+  /**
+   * @return Index of the topmost visible row, or 0.
+   * @param offset If given, set to the pixels of that row scrolled out at the
+   * top.
+   */
+  int32 TopRowIndex(float *offset = nullptr);
+
+  /** @return The horizontal scroll offset. */
+  float ScrollLeft();
+
+  static constexpr uint32 kMsgShowCtx = MSG_SHOW_CONTEXT_MENU;
+
+  const MediaItem *SelectedItem() const;
+  const MediaItem *ItemAt(int32 index) const;
+  bool IsRowMissing(BRow *row) const;
+
+protected:
+  bool InitiateDrag(BPoint point, bool wasSelected) override;
+  void KeyDown(const char *bytes, int32 numBytes) override;
+  void MouseMoved(BPoint where, uint32 transit,
+                  const BMessage *dragMsg) override;
+
+  void AttachedToWindow() override;
+  void DetachedFromWindow() override;
+  void MessageReceived(BMessage *msg) override;
+
+private:
+  /** @name Filters */
+  ///@{
+  class RightClickFilter;
+  class DropFilter;
+  RightClickFilter *fRCFilter = nullptr;
+  DropFilter *fDropFilter = nullptr;
+  ///@}
+
+  void ShowContextMenu(BPoint screenWhere);
+  /**
+   * @note fRowMap seemed unused in the .cpp, but keeping declaration if needed
+   * later.
+   */
+  std::map<BRow *, MediaItem> fRowMap;
+
+  /** @name Chunked loading state */
+  ///@{
+  std::vector<MediaItem> fPendingItems;
+  size_t fPendingIndex = 0;
+  void _AddBatch(size_t count);
+  void _ScrollToTarget();
+  static constexpr uint32 kMsgChunkAdd = 'chnk';
+
+  BString fScrollTarget;
+  BRow *fScrollTargetRow = nullptr;
+  BPoint fScrollTargetOffset;
+  ///@}
+
+  /** @name Internal drag-drop reordering */
+  ///@{
+  int32 fDragSourceIndex = -1;
+  BPoint fLastDropPoint;
+  ///@}
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef COPY_COUNTER_H
+#define COPY_COUNTER_H
+
+#include <SupportDefs.h>
+#include <atomic>
+
+/**
+ * @class CopyCounter
+ * @brief Empty base class that counts the copies of its derived type.
+ *
+ * Copy construction and copy assignment of @p T add one to a process-wide
+ * count; moves are not counted. The count feeds the library.item_copies
+ * metric and the copy budgets of CoreBenchmark.
+ *
+ * Counting is only compiled in when BETON_COPY_COUNT is defined
+ * (CoreBenchmark.make does this). Otherwise the base is empty, copies cost
+ * no atomic update, and Copies() returns -1. Everything linked into one
+ * program, libbeton-core included, has to be built with the same setting.
+ */
+#ifdef BETON_COPY_COUNT
+
+template <typename T> class CopyCounter {
+public:
+  /** @brief Copies of @p T made so far by all threads. */
+  static int64 Copies() { return sCopies.load(std::memory_order_relaxed); }
+
+protected:
+  CopyCounter() = default;
+  CopyCounter(const CopyCounter &) { _Count(); }
+  CopyCounter(CopyCounter &&) noexcept = default;
+
+  CopyCounter &operator=(const CopyCounter &) {
+    _Count();
+    return *this;
+  }
+  CopyCounter &operator=(CopyCounter &&) noexcept = default;
+
+private:
+  static void _Count() { sCopies.fetch_add(1, std::memory_order_relaxed); }
+
+  static inline std::atomic<int64> sCopies{0};
+};
+
+#else
+
+template <typename T> class CopyCounter {
+public:
+  static int64 Copies() { return -1; }
+};
+
+#endif // BETON_COPY_COUNT
+
+#endif // COPY_COUNTER_H
@@ -1,61 +1,76 @@
-#include "CoverView.h"
-#include "Debug.h"
-#include <Bitmap.h>
-#include <cstdio>
-
-CoverView::CoverView(const char *name)
-    : BView(name, B_WILL_DRAW | B_FULL_UPDATE_ON_RESIZE) {
-  SetViewColor(B_TRANSPARENT_COLOR);
-}
-
-CoverView::~CoverView() {
-  delete fBitmap;
-  fBitmap = nullptr;
-}
-
-/**
- * @brief Updates the displayed cover image.
- * Makes a defensive copy of the provided bitmap.
- *
- * @param bmp The new bitmap to display (can be nullptr to clear).
- */
-void CoverView::SetBitmap(BBitmap *bmp) {
-  BBitmap *clone = nullptr;
-  if (bmp && bmp->IsValid()) {
-    clone = new BBitmap(bmp);
-    if (!clone->IsValid()) {
-      delete clone;
-      clone = nullptr;
-    }
-  }
-  delete fBitmap;
-  fBitmap = clone;
-
-  DEBUG_PRINT("[CoverView] SetBitmap: %p %s\n", fBitmap,
-              (fBitmap && fBitmap->IsValid()) ? "valid" : "null");
-  Invalidate();
-}
-
-/**
- * @brief Draws the cover scaled to fit the view bounds.
- */
-void CoverView::Draw(BRect) {
-  // Fill background
-  SetHighColor(ui_color(B_PANEL_BACKGROUND_COLOR));
-  FillRect(Bounds());
-
-  if (!fBitmap || !fBitmap->IsValid()) {
-    // No valid bitmap -> just background
-    return;
-  }
-
-  // Draw scaled bitmap
-  DrawBitmapAsync(fBitmap, fBitmap->Bounds(), Bounds());
-}
-
-void CoverView::GetPreferredSize(float *w, float *h) {
-  if (w)
-    *w = 200;
-  if (h)
-    *h = 200;
-}
+#include "CoverView.h"
+#include "Debug.h"
+#include "MetricsRegistry.h"
+#include <Bitmap.h>
+#include <cstdio>
+
+CoverView::CoverView(const char *name)
+    : BView(name, B_WILL_DRAW | B_FULL_UPDATE_ON_RESIZE) {
+  SetViewColor(B_TRANSPARENT_COLOR);
+}
+
+CoverView::~CoverView() {
+  _CountMemory(fBitmap, -1);
+  delete fBitmap;
+  fBitmap = nullptr;
+}
+
+/**
+ * @brief Adds (@p sign 1) or removes (-1) @p bitmap from the memory.covers
+ * metric, the bitmaps of all cover views together.
+ */
+void CoverView::_CountMemory(const BBitmap *bitmap, int32 sign) {
+  static MetricGauge *sMemory =
+      MetricsRegistry::Default().Gauge("memory.covers", "MB");
+  if (bitmap)
+    sMemory->Add(sign * bitmap->BitsLength() / (1024.0 * 1024.0));
+}
+
+/**
+ * @brief Updates the displayed cover image.
+ * Makes a defensive copy of the provided bitmap.
+ *
+ * @param bmp The new bitmap to display (can be nullptr to clear).
+ */
+void CoverView::SetBitmap(BBitmap *bmp) {
+  BBitmap *clone = nullptr;
+  if (bmp && bmp->IsValid()) {
+    clone = new BBitmap(bmp);
+    if (!clone->IsValid()) {
+      delete clone;
+      clone = nullptr;
+    }
+  }
+  _CountMemory(fBitmap, -1);
+  delete fBitmap;
+  fBitmap = clone;
+  _CountMemory(fBitmap, 1);
+
+  DEBUG_PRINT("[CoverView] SetBitmap: %p %s\n", fBitmap,
+              (fBitmap && fBitmap->IsValid()) ? "valid" : "null");
+  Invalidate();
+}
+
+/**
+ * @brief Draws the cover scaled to fit the view bounds.
+ */
+void CoverView::Draw(BRect) {
+  // Fill background
+  SetHighColor(ui_color(B_PANEL_BACKGROUND_COLOR));
+  FillRect(Bounds());
+
+  if (!fBitmap || !fBitmap->IsValid()) {
+    // No valid bitmap -> just background
+    return;
+  }
+
+  // Draw scaled bitmap
+  DrawBitmapAsync(fBitmap, fBitmap->Bounds(), Bounds());
+}
+
+void CoverView::GetPreferredSize(float *w, float *h) {
+  if (w)
+    *w = 200;
+  if (h)
+    *h = 200;
+}
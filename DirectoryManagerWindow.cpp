@@ -1,179 +1,263 @@
-#include "DirectoryManagerWindow.h"
-#include "Messages.h"
-
-#include <Catalog.h>
-
-#undef B_TRANSLATION_CONTEXT
-#define B_TRANSLATION_CONTEXT "DirectoryManagerWindow"
-
-#include <Alert.h>
-#include <Directory.h>
-#include <Entry.h>
-#include <File.h>
-#include <FindDirectory.h>
-#include <LayoutBuilder.h>
-#include <NodeInfo.h>
-#include <Path.h>
-#include <StorageDefs.h>
-
-/**
- * @brief Constructs the Directory Manager window.
- *
- * Sets up the UI layout:
- * - List view for directories.
- * - Add/Remove/OK buttons.
- * - File panel for selecting new folders.
- *
- * Loads existing directory settings from disk.
- *
- * @param cacheManager Messenger to the CacheManager for triggering rescans.
- */
-DirectoryManagerWindow::DirectoryManagerWindow(BMessenger cacheManager)
-    : BWindow(BRect(100, 100, 500, 400), B_TRANSLATE("Manage Music Folders"),
-              B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS),
-      fCacheManager(cacheManager) {
-
-  // UI Components
-  fDirectoryList = new BListView("directoryList");
-  BScrollView *scroll =
-      new BScrollView("scroll", fDirectoryList, 0, false, true);
-
-  fBtnAdd = new BButton("Add", B_TRANSLATE("Add"), new BMessage(MSG_DIR_ADD));
-  fBtnRemove = new BButton("Remove", B_TRANSLATE("Remove"),
-                           new BMessage(MSG_DIR_REMOVE));
-  fBtnOK = new BButton("OK", B_TRANSLATE("OK"), new BMessage(MSG_DIR_OK));
-
-  // File Panel for folder selection
-  fAddPanel =
-      new BFilePanel(B_OPEN_PANEL, new BMessenger(this), nullptr,
-                     B_DIRECTORY_NODE, false, nullptr, nullptr, true, true);
-
-  // Layout Setup
-  BBox *buttonBox = new BBox(B_FANCY_BORDER);
-  BLayoutBuilder::Group<>(buttonBox, B_HORIZONTAL, 10)
-      .SetInsets(10, 10, 10, 10)
-      .Add(fBtnAdd)
-      .Add(fBtnRemove)
-      .AddGlue()
-      .Add(fBtnOK);
-
-  BLayoutBuilder::Group<>(this, B_VERTICAL, 10)
-      .SetInsets(10, 10, 10, 10)
-      .Add(scroll)
-      .Add(buttonBox);
-
-  // Calculate font-relative size
-  font_height fh;
-  be_plain_font->GetHeight(&fh);
-  float fontHeight = fh.ascent + fh.descent + fh.leading;
-
-  ResizeTo(fontHeight * 27, fontHeight * 20);
-  CenterOnScreen();
-
-  // Load saved settings
-  BPath settingsPath;
-  if (find_directory(B_USER_SETTINGS_DIRECTORY, &settingsPath) == B_OK) {
-    settingsPath.Append("BeTon/directories.txt");
-    BFile file(settingsPath.Path(), B_READ_ONLY);
-    if (file.InitCheck() == B_OK) {
-      BString line;
-      char ch;
-      while (file.Read(&ch, 1) == 1) {
-        if (ch == '\n') {
-          if (!line.IsEmpty()) {
-            fDirectoryList->AddItem(new BStringItem(line.String()));
-            fDirectories.push_back(BPath(line.String()));
-            line.Truncate(0);
-          }
-        } else {
-          line += ch;
-        }
-      }
-    }
-  }
-}
-
-void DirectoryManagerWindow::MessageReceived(BMessage *msg) {
-  switch (msg->what) {
-  case MSG_DIR_ADD:
-    fAddPanel->Show();
-    break;
-
-  case B_REFS_RECEIVED: {
-    entry_ref ref;
-    if (msg->FindRef("refs", &ref) == B_OK) {
-      AddDirectory(ref);
-    }
-    break;
-  }
-
-  case MSG_DIR_REMOVE:
-    RemoveSelectedDirectory();
-    break;
-
-  case MSG_DIR_OK:
-    SaveSettings();
-    // Notify CacheManager to rescan with new list
-    if (fCacheManager.IsValid()) {
-      fCacheManager.SendMessage(MSG_RESCAN);
-    }
-    Quit();
-    break;
-
-  default:
-    BWindow::MessageReceived(msg);
-    break;
-  }
-}
-
-/**
- * @brief Adds a directory to the list.
- * Prevents adding duplicate or invalid directories.
- */
-void DirectoryManagerWindow::AddDirectory(const entry_ref &ref) {
-  BPath path(&ref);
-  if (path.InitCheck() != B_OK)
-    return;
-
-  // Check for duplicates!!
-  for (int32 i = 0; i < fDirectoryList->CountItems(); ++i) {
-    BStringItem *item = static_cast<BStringItem *>(fDirectoryList->ItemAt(i));
-    if (item && item->Text() == path.Path())
-      return;
-  }
-
-  fDirectoryList->AddItem(new BStringItem(path.Path()));
-  fDirectories.push_back(path);
-}
-
-void DirectoryManagerWindow::RemoveSelectedDirectory() {
-  int32 index = fDirectoryList->CurrentSelection();
-  if (index < 0)
-    return;
-
-  delete fDirectoryList->RemoveItem(index);
-  fDirectories.erase(fDirectories.begin() + index);
-}
-
-/**
- * @brief Saves the list of configured directories to disk.
- * Path: ~/config/settings/BeTon/directories.txt
- */
-void DirectoryManagerWindow::SaveSettings() {
-  BPath settingsPath;
-  if (find_directory(B_USER_SETTINGS_DIRECTORY, &settingsPath) != B_OK)
-    return;
-
-  settingsPath.Append("BeTon");
-  create_directory(settingsPath.Path(), 0755);
-  settingsPath.Append("directories.txt");
-
-  BFile file(settingsPath.Path(), B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
-  if (file.InitCheck() != B_OK)
-    return;
-
-  for (const auto &path : fDirectories) {
-    file.Write(path.Path(), strlen(path.Path()));
-    file.Write("\n", 1);
-  }
-}
+#include "DirectoryManagerWindow.h"
+#include "Messages.h"
+#include "TagParserSandbox.h"
+
+#include <Catalog.h>
+
+#undef B_TRANSLATION_CONTEXT
+#define B_TRANSLATION_CONTEXT "DirectoryManagerWindow"
+
+#include <Alert.h>
+#include <Directory.h>
+#include <Entry.h>
+#include <File.h>
+#include <FindDirectory.h>
+#include <LayoutBuilder.h>
+#include <NodeInfo.h>
+#include <Path.h>
+#include <StorageDefs.h>
+#include <stdlib.h>
+
+/**
+ * @brief Constructs the Directory Manager window.
+ *
+ * Sets up the UI layout:
+ * - List view for directories.
+ * - Add/Remove/OK buttons.
+ * - Checkboxes for following symbolic links and sandboxed tag parsing.
+ * - File panel for selecting new folders.
+ *
+ * Loads existing directory settings from disk.
+ *
+ * @param cacheManager Messenger to the CacheManager for triggering rescans.
+ */
+DirectoryManagerWindow::DirectoryManagerWindow(BMessenger cacheManager)
+    : BWindow(BRect(100, 100, 500, 400), B_TRANSLATE("Manage Music Folders"),
+              B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS),
+      fCacheManager(cacheManager) {
+
+  // UI Components
+  fDirectoryList = new BListView("directoryList");
+  BScrollView *scroll =
+      new BScrollView("scroll", fDirectoryList, 0, false, true);
+
+  fBtnAdd = new BButton("Add", B_TRANSLATE("Add"), new BMessage(MSG_DIR_ADD));
+  fBtnRemove = new BButton("Remove", B_TRANSLATE("Remove"),
+                           new BMessage(MSG_DIR_REMOVE));
+  fBtnOK = new BButton("OK", B_TRANSLATE("OK"), new BMessage(MSG_DIR_OK));
+  fFollowLinks = new BCheckBox("followLinks",
+                               B_TRANSLATE("Follow symbolic links"), nullptr);
+  fFollowLinks->SetValue(B_CONTROL_ON);
+  fSandboxParsing = new BCheckBox(
+      "sandboxParsing", B_TRANSLATE("Read tags in separate processes"),
+      nullptr);
+  fMaxReadRate = new BTextControl(
+      "maxReadRate", B_TRANSLATE("Scan read limit (MB/s, 0 = none):"), "0",
+      nullptr);
+  fMaxFileOps = new BTextControl(
+      "maxFileOps", B_TRANSLATE("Scan I/O limit (operations/s, 0 = none):"),
+      "0", nullptr);
+
+  // File Panel for folder selection
+  fAddPanel =
+      new BFilePanel(B_OPEN_PANEL, new BMessenger(this), nullptr,
+                     B_DIRECTORY_NODE, false, nullptr, nullptr, true, true);
+
+  // Layout Setup
+  BBox *buttonBox = new BBox(B_FANCY_BORDER);
+  BLayoutBuilder::Group<>(buttonBox, B_HORIZONTAL, 10)
+      .SetInsets(10, 10, 10, 10)
+      .Add(fBtnAdd)
+      .Add(fBtnRemove)
+      .AddGlue()
+      .Add(fBtnOK);
+
+  BLayoutBuilder::Group<>(this, B_VERTICAL, 10)
+      .SetInsets(10, 10, 10, 10)
+      .Add(scroll)
+      .Add(fFollowLinks)
+      .Add(fSandboxParsing)
+      .Add(fMaxReadRate)
+      .Add(fMaxFileOps)
+      .Add(buttonBox);
+
+  // Calculate font-relative size
+  font_height fh;
+  be_plain_font->GetHeight(&fh);
+  float fontHeight = fh.ascent + fh.descent + fh.leading;
+
+  ResizeTo(fontHeight * 27, fontHeight * 20);
+  CenterOnScreen();
+
+  // Load saved settings
+  BPath settingsPath;
+  if (find_directory(B_USER_SETTINGS_DIRECTORY, &settingsPath) == B_OK) {
+    settingsPath.Append("BeTon/directories.txt");
+    BFile file(settingsPath.Path(), B_READ_ONLY);
+    if (file.InitCheck() == B_OK) {
+      BString line;
+      char ch;
+      while (file.Read(&ch, 1) == 1) {
+        if (ch == '\n') {
+          if (line.StartsWith(" ") || line.StartsWith("\t")) {
+            // Option of the folder above, kept as written (see ScanFilter)
+            if (!fDirectoryOptions.empty())
+              fDirectoryOptions.back() << line << "\n";
+          } else if (!line.IsEmpty() && !line.StartsWith("#")) {
+            fDirectoryList->AddItem(new BStringItem(line.String()));
+            fDirectories.push_back(BPath(line.String()));
+            fDirectoryOptions.push_back(BString());
+          }
+          line.Truncate(0);
+        } else {
+          line += ch;
+        }
+      }
+    }
+
+    BPath scanSettingsPath;
+    find_directory(B_USER_SETTINGS_DIRECTORY, &scanSettingsPath);
+    scanSettingsPath.Append("BeTon/scan.settings");
+    BFile scanFile(scanSettingsPath.Path(), B_READ_ONLY);
+    BMessage scanSettings;
+    if (scanFile.InitCheck() == B_OK &&
+        scanSettings.Unflatten(&scanFile) == B_OK) {
+      fFollowLinks->SetValue(scanSettings.GetBool("follow_links", true)
+                                 ? B_CONTROL_ON
+                                 : B_CONTROL_OFF);
+      fSandboxParsing->SetValue(
+          scanSettings.GetInt32("parser_helpers", 0) > 0 ? B_CONTROL_ON
+                                                         : B_CONTROL_OFF);
+
+      BString limit;
+      limit << scanSettings.GetInt64("io_bytes_per_sec", 0) / (1024 * 1024);
+      fMaxReadRate->SetText(limit.String());
+      limit.Truncate(0);
+      limit << scanSettings.GetInt32("io_ops_per_sec", 0);
+      fMaxFileOps->SetText(limit.String());
+    }
+  }
+}
+
+void DirectoryManagerWindow::MessageReceived(BMessage *msg) {
+  switch (msg->what) {
+  case MSG_DIR_ADD:
+    fAddPanel->Show();
+    break;
+
+  case B_REFS_RECEIVED: {
+    entry_ref ref;
+    if (msg->FindRef("refs", &ref) == B_OK) {
+      AddDirectory(ref);
+    }
+    break;
+  }
+
+  case MSG_DIR_REMOVE:
+    RemoveSelectedDirectory();
+    break;
+
+  case MSG_DIR_OK:
+    SaveSettings();
+    // Notify CacheManager to rescan with new list
+    if (fCacheManager.IsValid()) {
+      fCacheManager.SendMessage(MSG_RESCAN);
+    }
+    Quit();
+    break;
+
+  default:
+    BWindow::MessageReceived(msg);
+    break;
+  }
+}
+
+/**
+ * @brief Adds a directory to the list.
+ * Prevents adding duplicate or invalid directories.
+ */
+void DirectoryManagerWindow::AddDirectory(const entry_ref &ref) {
+  BPath path(&ref);
+  if (path.InitCheck() != B_OK)
+    return;
+
+  // Check for duplicates!!
+  for (int32 i = 0; i < fDirectoryList->CountItems(); ++i) {
+    BStringItem *item = static_cast<BStringItem *>(fDirectoryList->ItemAt(i));
+    if (item && item->Text() == path.Path())
+      return;
+  }
+
+  fDirectoryList->AddItem(new BStringItem(path.Path()));
+  fDirectories.push_back(path);
+  fDirectoryOptions.push_back(BString());
+}
+
+void DirectoryManagerWindow::RemoveSelectedDirectory() {
+  int32 index = fDirectoryList->CurrentSelection();
+  if (index < 0)
+    return;
+
+  delete fDirectoryList->RemoveItem(index);
+  fDirectories.erase(fDirectories.begin() + index);
+  fDirectoryOptions.erase(fDirectoryOptions.begin() + index);
+}
+
+/**
+ * @brief Saves the list of configured directories and the scan options to
+ * disk.
+ * Paths: ~/config/settings/BeTon/directories.txt and
+ * ~/config/settings/BeTon/scan.settings
+ */
+void DirectoryManagerWindow::SaveSettings() {
+  BPath settingsPath;
+  if (find_directory(B_USER_SETTINGS_DIRECTORY, &settingsPath) != B_OK)
+    return;
+
+  settingsPath.Append("BeTon");
+  create_directory(settingsPath.Path(), 0755);
+  settingsPath.Append("directories.txt");
+
+  BFile file(settingsPath.Path(), B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+  if (file.InitCheck() != B_OK)
+    return;
+
+  for (size_t i = 0; i < fDirectories.size(); i++) {
+    const char *path = fDirectories[i].Path();
+    file.Write(path, strlen(path));
+    file.Write("\n", 1);
+    file.Write(fDirectoryOptions[i].String(), fDirectoryOptions[i].Length());
+  }
+
+  settingsPath.GetParent(&settingsPath);
+  settingsPath.Append("scan.settings");
+
+  // Keep options this window does not edit
+  BMessage scanSettings;
+  BFile scanFile(settingsPath.Path(), B_READ_WRITE | B_CREATE_FILE);
+  if (scanFile.InitCheck() != B_OK)
+    return;
+  scanSettings.Unflatten(&scanFile);
+
+  scanSettings.RemoveName("follow_links");
+  scanSettings.AddBool("follow_links", fFollowLinks->Value() == B_CONTROL_ON);
+
+  scanSettings.RemoveName("parser_helpers");
+  scanSettings.AddInt32("parser_helpers",
+                        fSandboxParsing->Value() == B_CONTROL_ON
+                            ? TagParserSandbox::kDefaultHelpers
+                            : 0);
+
+  int64 readRate = strtoll(fMaxReadRate->Text(), nullptr, 10);
+  scanSettings.RemoveName("io_bytes_per_sec");
+  scanSettings.AddInt64("io_bytes_per_sec",
+                        readRate > 0 ? readRate * 1024 * 1024 : 0);
+
+  int32 fileOps = atoi(fMaxFileOps->Text());
+  scanSettings.RemoveName("io_ops_per_sec");
+  scanSettings.AddInt32("io_ops_per_sec", fileOps > 0 ? fileOps : 0);
+
+  scanFile.SetSize(0);
+  scanFile.Seek(0, SEEK_SET);
+  scanSettings.Flatten(&scanFile);
+}
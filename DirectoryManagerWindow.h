@@ -1,57 +1,70 @@
-#ifndef DIRECTORY_MANAGER_WINDOW_H
-#define DIRECTORY_MANAGER_WINDOW_H
-
-#include <Box.h>
-#include <Button.h>
-#include <FilePanel.h>
-#include <ListView.h>
-#include <ScrollView.h>
-#include <StringItem.h>
-#include <Window.h>
-#include <vector>
-
-/**
- * @class DirectoryManagerWindow
- * @brief Window for managing the list of music directories.
- *
- * Allows the user to:
- * - View currently monitored folders.
- * - Add new folders via a standard BFilePanel.
- * - Remove folders from the list.
- *
- * Changes are saved to disk and the CacheManager is notified to rescan.
- */
-class DirectoryManagerWindow : public BWindow {
-public:
-  /**
-   * @brief Construct a new Directory Manager Window
-   *
-   * @param cacheManager Messenger target to receive the MSG_RESCAN command upon
-   * saving.
-   */
-  DirectoryManagerWindow(BMessenger cacheManager);
-
-  void MessageReceived(BMessage *msg) override;
-
-private:
-  void AddDirectory(const entry_ref &ref);
-  void RemoveSelectedDirectory();
-  void SaveSettings();
-
-  /** @name UI Components */
-  ///@{
-  BListView *fDirectoryList;
-  BButton *fBtnAdd;
-  BButton *fBtnRemove;
-  BButton *fBtnOK;
-  BFilePanel *fAddPanel;
-  ///@}
-
-  /** @name Data */
-  ///@{
-  std::vector<BPath> fDirectories;
-  BMessenger fCacheManager;
-  ///@}
-};
-
-#endif // DIRECTORY_MANAGER_WINDOW_H
+#ifndef DIRECTORY_MANAGER_WINDOW_H
+#define DIRECTORY_MANAGER_WINDOW_H
+
+#include <Box.h>
+#include <Button.h>
+#include <CheckBox.h>
+#include <FilePanel.h>
+#include <ListView.h>
+#include <ScrollView.h>
+#include <String.h>
+#include <StringItem.h>
+#include <TextControl.h>
+#include <Window.h>
+#include <vector>
+
+/**
+ * @class DirectoryManagerWindow
+ * @brief Window for managing the list of music directories.
+ *
+ * Allows the user to:
+ * - View currently monitored folders.
+ * - Add new folders via a standard BFilePanel.
+ * - Remove folders from the list.
+ * - Choose whether symbolic links inside the folders are followed.
+ * - Choose whether tags are parsed in separate helper processes.
+ *
+ * Changes are saved to disk and the CacheManager is notified to rescan.
+ * Per-folder scan options (exclude patterns, minimums) are edited in
+ * directories.txt directly and kept untouched by this window.
+ */
+class DirectoryManagerWindow : public BWindow {
+public:
+  /**
+   * @brief Construct a new Directory Manager Window
+   *
+   * @param cacheManager Messenger target to receive the MSG_RESCAN command upon
+   * saving.
+   */
+  DirectoryManagerWindow(BMessenger cacheManager);
+
+  void MessageReceived(BMessage *msg) override;
+
+private:
+  void AddDirectory(const entry_ref &ref);
+  void RemoveSelectedDirectory();
+  void SaveSettings();
+
+  /** @name UI Components */
+  ///@{
+  BListView *fDirectoryList;
+  BButton *fBtnAdd;
+  BButton *fBtnRemove;
+  BButton *fBtnOK;
+  BCheckBox *fFollowLinks;
+  BCheckBox *fSandboxParsing;
+  BTextControl *fMaxReadRate; ///< MB/s, empty or 0 for no limit.
+  BTextControl *fMaxFileOps;  ///< Operations/s, empty or 0 for no limit.
+  BFilePanel *fAddPanel;
+  ///@}
+
+  /** @name Data */
+  ///@{
+  std::vector<BPath> fDirectories;
+  /// Indented option lines below each directory, preserved on save.
+  std::vector<BString> fDirectoryOptions;
+  BMessenger fCacheManager;
+  ///@}
+};
+
+#endif // DIRECTORY_MANAGER_WINDOW_H
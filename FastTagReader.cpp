@@ -0,0 +1,939 @@
+#include "FastTagReader.h"
+#include "Arena.h"
+#include "FormatDetector.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @brief ID3v1 genre names, indexed by genre number (including the Winamp
+ * extensions), used for numeric TCON values and ID3v1 tags.
+ */
+static const char *const kId3Genres[] = {
+    "Blues", "Classic Rock", "Country", "Dance", "Disco", "Funk", "Grunge",
+    "Hip-Hop", "Jazz", "Metal", "New Age", "Oldies", "Other", "Pop", "R&B",
+    "Rap", "Reggae", "Rock", "Techno", "Industrial", "Alternative", "Ska",
+    "Death Metal", "Pranks", "Soundtrack", "Euro-Techno", "Ambient",
+    "Trip-Hop", "Vocal", "Jazz-Funk", "Fusion", "Trance", "Classical",
+    "Instrumental", "Acid", "House", "Game", "Sound Clip", "Gospel", "Noise",
+    "Alternative Rock", "Bass", "Soul", "Punk", "Space", "Meditative",
+    "Instrumental Pop", "Instrumental Rock", "Ethnic", "Gothic", "Darkwave",
+    "Techno-Industrial", "Electronic", "Pop-Folk", "Eurodance", "Dream",
+    "Southern Rock", "Comedy", "Cult", "Gangsta", "Top 40", "Christian Rap",
+    "Pop/Funk", "Jungle", "Native American", "Cabaret", "New Wave",
+    "Psychedelic", "Rave", "Showtunes", "Trailer", "Lo-Fi", "Tribal",
+    "Acid Punk", "Acid Jazz", "Polka", "Retro", "Musical", "Rock & Roll",
+    "Hard Rock", "Folk", "Folk/Rock", "National Folk", "Swing", "Fast-Fusion",
+    "Bebop", "Latin", "Revival", "Celtic", "Bluegrass", "Avant-garde",
+    "Gothic Rock", "Progressive Rock", "Psychedelic Rock", "Symphonic Rock",
+    "Slow Rock", "Big Band", "Chorus", "Easy Listening", "Acoustic", "Humour",
+    "Speech", "Chanson", "Opera", "Chamber Music", "Sonata", "Symphony",
+    "Booty Bass", "Primus", "Porn Groove", "Satire", "Slow Jam", "Club",
+    "Tango", "Samba", "Folklore", "Ballad", "Power Ballad", "Rhythmic Soul",
+    "Freestyle", "Duet", "Punk Rock", "Drum Solo", "A Cappella", "Euro-House",
+    "Dance Hall", "Goa", "Drum & Bass", "Club-House", "Hardcore", "Terror",
+    "Indie", "BritPop", "Afro-Punk", "Polsk Punk", "Beat",
+    "Christian Gangsta Rap", "Heavy Metal", "Black Metal", "Crossover",
+    "Contemporary Christian", "Christian Rock", "Merengue", "Salsa",
+    "Thrash Metal", "Anime", "Jpop", "Synthpop", "Abstract", "Art Rock",
+    "Baroque", "Bhangra", "Big Beat", "Breakbeat", "Chillout", "Downtempo",
+    "Dub", "EBM", "Eclectic", "Electro", "Electroclash", "Emo", "Experimental",
+    "Garage", "Global", "IDM", "Illbient", "Industro-Goth", "Jam Band",
+    "Krautrock", "Leftfield", "Lounge", "Math Rock", "New Romantic",
+    "Nu-Breakz", "Post-Punk", "Post-Rock", "Psytrance", "Shoegaze",
+    "Space Rock", "Trop Rock", "World Music", "Neoclassical", "Audiobook",
+    "Audio Theatre", "Neue Deutsche Welle", "Podcast", "Indie Rock", "G-Funk",
+    "Dubstep", "Garage Rock", "Psybient"};
+
+static const char *GenreName(long index) {
+  const long count = (long)(sizeof(kId3Genres) / sizeof(kId3Genres[0]));
+  return (index >= 0 && index < count) ? kId3Genres[index] : nullptr;
+}
+
+/**
+ * @class Source
+ * @brief Bounded random-access reader over an open file, which stays owned
+ * by the caller.
+ *
+ * The first kHeadSize bytes are read once. Later requests inside that window
+ * are served from memory; anything else results in one pread() of exactly
+ * the requested range.
+ *
+ * The head buffer, decoded strings and other per-file temporaries are
+ * carved from the scratch arena, which the caller resets between files.
+ */
+class Source {
+public:
+  Source(int fd, Arena &scratch) : fScratch(scratch), fFd(fd) {
+    if (fFd < 0)
+      return;
+
+    struct stat st{};
+    if (fstat(fFd, &st) != 0)
+      return;
+    fSize = st.st_size;
+
+    const size_t want =
+        (size_t)std::min<off_t>(fSize, FastTagReader::kHeadSize);
+    fHead = static_cast<uint8 *>(scratch.Allocate(want, 1));
+    ssize_t got = pread(fFd, fHead, want, 0);
+    fHeadSize = got < 0 ? 0 : (size_t)got;
+  }
+
+  bool IsValid() const { return fFd >= 0 && fHeadSize > 0; }
+  off_t Size() const { return fSize; }
+  const uint8 *Head() const { return fHead; }
+  size_t HeadSize() const { return fHeadSize; }
+
+  /** @brief Memory that lives as long as the file is being parsed. */
+  Arena &Scratch() { return fScratch; }
+
+  /**
+   * @brief Returns @p length bytes at @p offset, or nullptr on short read.
+   *
+   * The returned pointer stays valid until the next call with the same
+   * @p scratch buffer.
+   */
+  const uint8 *Fetch(off_t offset, size_t length, std::vector<uint8> &scratch) {
+    if (offset < 0 || offset + (off_t)length > fSize)
+      return nullptr;
+    if (offset + (off_t)length <= (off_t)fHeadSize)
+      return fHead + offset;
+
+    scratch.resize(length);
+    if (pread(fFd, scratch.data(), length, offset) != (ssize_t)length)
+      return nullptr;
+    return scratch.data();
+  }
+
+private:
+  Arena &fScratch;
+  int fFd = -1;
+  off_t fSize = 0;
+  uint8 *fHead = nullptr;
+  size_t fHeadSize = 0;
+};
+
+/** @name Byte helpers */
+///@{
+static inline uint32 BE32(const uint8 *p) {
+  return ((uint32)p[0] << 24) | ((uint32)p[1] << 16) | ((uint32)p[2] << 8) |
+         p[3];
+}
+
+static inline uint32 BE24(const uint8 *p) {
+  return ((uint32)p[0] << 16) | ((uint32)p[1] << 8) | p[2];
+}
+
+static inline uint32 LE32(const uint8 *p) {
+  return ((uint32)p[3] << 24) | ((uint32)p[2] << 16) | ((uint32)p[1] << 8) |
+         p[0];
+}
+
+static inline uint32 SyncSafe32(const uint8 *p) {
+  return ((uint32)(p[0] & 0x7F) << 21) | ((uint32)(p[1] & 0x7F) << 14) |
+         ((uint32)(p[2] & 0x7F) << 7) | (p[3] & 0x7F);
+}
+///@}
+
+/** @name Text helpers */
+///@{
+/** @brief Writes @p cp as UTF-8 at @p out and advances it. */
+static void AppendUtf8(char *&out, uint32 cp) {
+  if (cp < 0x80) {
+    *out++ = (char)cp;
+  } else if (cp < 0x800) {
+    *out++ = (char)(0xC0 | (cp >> 6));
+    *out++ = (char)(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    *out++ = (char)(0xE0 | (cp >> 12));
+    *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+    *out++ = (char)(0x80 | (cp & 0x3F));
+  } else {
+    *out++ = (char)(0xF0 | (cp >> 18));
+    *out++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+    *out++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+    *out++ = (char)(0x80 | (cp & 0x3F));
+  }
+}
+
+/**
+ * @brief Decodes one NUL-terminated ID3v2 string into @p arena.
+ * @param enc ID3v2 text encoding byte (0 Latin-1, 1 UTF-16+BOM, 2 UTF-16BE,
+ * 3 UTF-8).
+ * @param p Start of the string.
+ * @param n Bytes available.
+ * @param consumed Receives the number of bytes used, including terminator.
+ * @return The UTF-8 text, valid until the arena is reset.
+ */
+static const char *DecodeId3String(Arena &arena, uint8 enc, const uint8 *p,
+                                   size_t n, size_t *consumed = nullptr) {
+  // In UTF-8, Latin-1 and UTF-16 take at most twice as many bytes
+  char *const text = static_cast<char *>(arena.Allocate(2 * n + 1, 1));
+  char *out = text;
+  size_t i = 0;
+
+  if (enc == 0 || enc == 3) {
+    while (i < n && p[i] != 0) {
+      if (enc == 0)
+        AppendUtf8(out, p[i]);
+      else
+        *out++ = (char)p[i];
+      i++;
+    }
+    if (i < n)
+      i++;
+  } else {
+    bool bigEndian = (enc == 2);
+    if (enc == 1 && n >= 2) {
+      if (p[0] == 0xFE && p[1] == 0xFF) {
+        bigEndian = true;
+        i = 2;
+      } else if (p[0] == 0xFF && p[1] == 0xFE) {
+        i = 2;
+      }
+    }
+
+    while (i + 1 < n) {
+      uint32 u = bigEndian ? ((uint32)p[i] << 8 | p[i + 1])
+                           : ((uint32)p[i + 1] << 8 | p[i]);
+      i += 2;
+      if (u == 0)
+        break;
+      if (u >= 0xD800 && u < 0xDC00 && i + 1 < n) {
+        uint32 lo = bigEndian ? ((uint32)p[i] << 8 | p[i + 1])
+                              : ((uint32)p[i + 1] << 8 | p[i]);
+        if (lo >= 0xDC00 && lo < 0xE000) {
+          u = 0x10000 + ((u - 0xD800) << 10) + (lo - 0xDC00);
+          i += 2;
+        }
+      }
+      AppendUtf8(out, u);
+    }
+  }
+
+  *out = '\0';
+  if (consumed)
+    *consumed = i;
+  return text;
+}
+
+/** @brief Parses "n" or "n/total" into its two numbers. */
+static void ParsePair(const char *s, uint32 &first, uint32 &second) {
+  char *end = nullptr;
+  long a = strtol(s, &end, 10);
+  first = (a > 0) ? (uint32)a : 0;
+  if (end && *end == '/') {
+    long b = strtol(end + 1, nullptr, 10);
+    if (b > 0)
+      second = (uint32)b;
+  }
+}
+
+static uint32 ParseYear(const char *s) {
+  long y = strtol(s, nullptr, 10);
+  return (y > 0) ? (uint32)y : 0;
+}
+
+/**
+ * @brief Resolves TCON values such as "(17)", "(17)Rock", "17" or "Rock".
+ */
+static BString ParseGenre(const char *cs) {
+  if (cs[0] == '(') {
+    char *end = nullptr;
+    long idx = strtol(cs + 1, &end, 10);
+    if (end && end != cs + 1 && *end == ')') {
+      if (end[1] != '\0')
+        return BString(end + 1);
+      if (const char *name = GenreName(idx))
+        return BString(name);
+    }
+  } else if (cs[0] != '\0') {
+    char *end = nullptr;
+    long idx = strtol(cs, &end, 10);
+    if (end && *end == '\0')
+      if (const char *name = GenreName(idx))
+        return BString(name);
+  }
+  return BString(cs);
+}
+///@}
+
+/**
+ * @brief Applies one MusicBrainz or AcoustID value keyed by its ID3/Vorbis
+ * name.
+ */
+static void ApplyUserText(const char *key, const char *value, TagData &out) {
+  if (strcasecmp(key, "MusicBrainz Album Id") == 0 ||
+      strcasecmp(key, "MUSICBRAINZ_ALBUMID") == 0)
+    out.mbAlbumID = value;
+  else if (strcasecmp(key, "MusicBrainz Artist Id") == 0 ||
+           strcasecmp(key, "MUSICBRAINZ_ARTISTID") == 0)
+    out.mbArtistID = value;
+  else if (strcasecmp(key, "MusicBrainz Track Id") == 0 ||
+           strcasecmp(key, "MUSICBRAINZ_TRACKID") == 0)
+    out.mbTrackID = value;
+  else if (strcasecmp(key, "AcoustID Id") == 0 ||
+           strcasecmp(key, "ACOUSTID_ID") == 0)
+    out.acoustId = value;
+  else if (strcasecmp(key, "AcoustID Fingerprint") == 0 ||
+           strcasecmp(key, "ACOUSTID_FINGERPRINT") == 0)
+    out.acoustIdFp = value;
+}
+
+/**
+ * @brief Decodes a single ID3v2 frame body into @p out.
+ * @param arena Receives the decoded text until it is copied into @p out.
+ */
+static void ApplyId3Frame(const char *id, const uint8 *d, size_t n,
+                          TagData &out, Arena &arena) {
+  if (n < 1)
+    return;
+
+  if (id[0] == 'T' && strcmp(id, "TXXX") != 0) {
+    const char *v = DecodeId3String(arena, d[0], d + 1, n - 1);
+    if (strcmp(id, "TIT2") == 0)
+      out.title = v;
+    else if (strcmp(id, "TPE1") == 0)
+      out.artist = v;
+    else if (strcmp(id, "TALB") == 0)
+      out.album = v;
+    else if (strcmp(id, "TPE2") == 0)
+      out.albumArtist = v;
+    else if (strcmp(id, "TCOM") == 0)
+      out.composer = v;
+    else if (strcmp(id, "TCON") == 0)
+      out.genre = ParseGenre(v);
+    else if (strcmp(id, "TRCK") == 0)
+      ParsePair(v, out.track, out.trackTotal);
+    else if (strcmp(id, "TPOS") == 0)
+      ParsePair(v, out.disc, out.discTotal);
+    else if (strcmp(id, "TDRC") == 0 || strcmp(id, "TYER") == 0) {
+      if (out.year == 0)
+        out.year = ParseYear(v);
+    }
+    return;
+  }
+
+  if (strcmp(id, "TXXX") == 0) {
+    size_t used = 0;
+    const char *desc = DecodeId3String(arena, d[0], d + 1, n - 1, &used);
+    if (used >= n - 1)
+      return;
+    ApplyUserText(desc,
+                  DecodeId3String(arena, d[0], d + 1 + used, n - 1 - used),
+                  out);
+    return;
+  }
+
+  if (strcmp(id, "COMM") == 0) {
+    if (n < 4 || !out.comment.IsEmpty())
+      return;
+    size_t used = 0;
+    const char *desc = DecodeId3String(arena, d[0], d + 4, n - 4, &used);
+    if (desc[0] != '\0' || used >= n - 4)
+      return;
+    out.comment = DecodeId3String(arena, d[0], d + 4 + used, n - 4 - used);
+    return;
+  }
+
+  if (strcmp(id, "UFID") == 0) {
+    static const char kOwner[] = "http://musicbrainz.org";
+    if (n > sizeof(kOwner) && memcmp(d, kOwner, sizeof(kOwner)) == 0 &&
+        out.mbTrackID.IsEmpty())
+      out.mbTrackID.SetTo((const char *)d + sizeof(kOwner),
+                          (int32)(n - sizeof(kOwner)));
+  }
+}
+
+/** @brief Frames whose contents ApplyId3Frame() looks at. */
+static bool IsWantedFrame(const char *id) {
+  static const char *const kWanted[] = {"TIT2", "TPE1", "TALB", "TPE2",
+                                        "TCOM", "TCON", "TRCK", "TPOS",
+                                        "TDRC", "TYER", "TXXX", "COMM",
+                                        "UFID"};
+  for (const char *w : kWanted)
+    if (memcmp(id, w, 4) == 0)
+      return true;
+  return false;
+}
+
+/**
+ * @brief Records where the image data of an APIC frame starts.
+ *
+ * Only the frame header (encoding, MIME type, picture type, description) is
+ * read, at most kPictureHeaderMax bytes of it.
+ */
+static bool LocateApic(Source &src, off_t pos, size_t len, CoverInfo &cover) {
+  static constexpr size_t kPictureHeaderMax = 1024;
+
+  std::vector<uint8> scratch;
+  const size_t n = std::min(len, kPictureHeaderMax);
+  const uint8 *d = src.Fetch(pos, n, scratch);
+  if (!d || n < 4)
+    return false;
+
+  const uint8 *mimeEnd = (const uint8 *)memchr(d + 1, 0, n - 1);
+  if (!mimeEnd)
+    return false;
+  BString mime((const char *)d + 1, (int32)(mimeEnd - (d + 1)));
+
+  size_t used = 0;
+  const size_t descStart = (mimeEnd - d) + 2; // NUL and picture type
+  if (descStart >= n)
+    return false;
+  DecodeId3String(src.Scratch(), d[0], d + descStart, n - descStart, &used);
+
+  const size_t header = descStart + used;
+  if (header >= len)
+    return false;
+
+  cover.present = true;
+  cover.offset = (uint64)(pos + (off_t)header);
+  cover.size = (uint32)(len - header);
+  cover.mime = mime;
+  return true;
+}
+
+/** @brief Reverses ID3v2 unsynchronisation (0xFF 0x00 -> 0xFF). */
+static size_t Resync(uint8 *d, size_t n) {
+  size_t w = 0;
+  for (size_t r = 0; r < n; r++) {
+    d[w++] = d[r];
+    if (d[r] == 0xFF && r + 1 < n && d[r + 1] == 0x00)
+      r++;
+  }
+  return w;
+}
+
+/**
+ * @brief Parses an ID3v2.3/2.4 tag at the start of the file.
+ * @param cover Receives the location of the first APIC picture.
+ * @param tagEnd Receives the offset of the first byte after the tag.
+ * @return False if the tag uses features this parser does not handle.
+ */
+static bool ParseId3v2(Source &src, TagData &out, CoverInfo &cover,
+                       off_t &tagEnd) {
+  const uint8 *h = src.Head();
+  if (src.HeadSize() < 10)
+    return false;
+
+  const uint8 major = h[3];
+  const uint8 flags = h[5];
+  if (major != 3 && major != 4)
+    return false;
+  if (flags & 0x80)
+    return false; // tag-level unsynchronisation
+
+  const uint32 tagSize = SyncSafe32(h + 6);
+  tagEnd = 10 + (off_t)tagSize + ((flags & 0x10) ? 10 : 0);
+
+  off_t pos = 10;
+  if (flags & 0x40) {
+    std::vector<uint8> scratch;
+    const uint8 *ext = src.Fetch(pos, 4, scratch);
+    if (!ext)
+      return false;
+    pos += (major == 4) ? SyncSafe32(ext) : BE32(ext) + 4;
+  }
+
+  const off_t framesEnd = 10 + (off_t)tagSize;
+  std::vector<uint8> scratch;
+  std::vector<uint8> body;
+
+  while (pos + 10 <= framesEnd) {
+    const uint8 *fh = src.Fetch(pos, 10, scratch);
+    if (!fh || fh[0] == 0)
+      break; // padding
+
+    char id[5];
+    memcpy(id, fh, 4);
+    id[4] = '\0';
+
+    const uint32 size = (major == 4) ? SyncSafe32(fh + 4) : BE32(fh + 4);
+    const uint8 fflags = fh[9];
+    const off_t bodyPos = pos + 10;
+    pos = bodyPos + size;
+    if (pos > framesEnd)
+      break;
+
+    const bool isPicture = memcmp(id, "APIC", 4) == 0 && !cover.present;
+    if ((!IsWantedFrame(id) && !isPicture) || size == 0)
+      continue;
+
+    bool unsync = false;
+    off_t dataPos = bodyPos;
+    size_t dataLen = size;
+    if (major == 4) {
+      if (fflags & 0x0C)
+        return false; // compressed or encrypted
+      unsync = (fflags & 0x02) != 0;
+      if (fflags & 0x01) {
+        if (dataLen < 4)
+          continue;
+        dataPos += 4;
+        dataLen -= 4;
+      }
+    } else if (fflags & 0xC0) {
+      return false; // compressed or encrypted
+    }
+
+    if (isPicture) {
+      // Pictures are only located here; their data is read on request
+      if (unsync)
+        return false;
+      if (!LocateApic(src, dataPos, dataLen, cover))
+        break;
+      continue;
+    }
+
+    const uint8 *d = src.Fetch(dataPos, dataLen, body);
+    if (!d)
+      break;
+
+    if (unsync) {
+      uint8 *copy = static_cast<uint8 *>(src.Scratch().Allocate(dataLen, 1));
+      memcpy(copy, d, dataLen);
+      dataLen = Resync(copy, dataLen);
+      ApplyId3Frame(id, copy, dataLen, out, src.Scratch());
+    } else {
+      ApplyId3Frame(id, d, dataLen, out, src.Scratch());
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Fills empty basic fields from a trailing ID3v1 tag, if present.
+ */
+static void ParseId3v1(Source &src, TagData &out) {
+  std::vector<uint8> scratch;
+  const uint8 *t = src.Fetch(src.Size() - 128, 128, scratch);
+  if (!t || memcmp(t, "TAG", 3) != 0)
+    return;
+
+  Arena &arena = src.Scratch();
+  auto field = [&arena](const uint8 *p, size_t n) {
+    char *const text = static_cast<char *>(arena.Allocate(2 * n + 1, 1));
+    char *end = text;
+    for (size_t i = 0; i < n && p[i]; i++)
+      AppendUtf8(end, p[i]);
+    while (end > text && end[-1] == ' ')
+      end--;
+    *end = '\0';
+    return (const char *)text;
+  };
+
+  if (out.title.IsEmpty())
+    out.title = field(t + 3, 30);
+  if (out.artist.IsEmpty())
+    out.artist = field(t + 33, 30);
+  if (out.album.IsEmpty())
+    out.album = field(t + 63, 30);
+  if (out.year == 0)
+    out.year = (uint32)atoi(field(t + 93, 4));
+  if (out.comment.IsEmpty())
+    out.comment = field(t + 97, t[125] == 0 ? 28 : 30);
+  if (out.track == 0 && t[125] == 0)
+    out.track = t[126];
+  if (out.genre.IsEmpty())
+    if (const char *name = GenreName(t[127]))
+      out.genre = name;
+}
+
+/**
+ * @struct MpegHeader
+ * @brief Decoded fields of an MPEG audio frame header.
+ */
+struct MpegHeader {
+  int version;     ///< 1 = MPEG-1, 2 = MPEG-2, 25 = MPEG-2.5.
+  int layer;       ///< 1, 2 or 3.
+  uint32 bitrate;  ///< kbps.
+  uint32 sampleRate;
+  uint32 channels;
+  uint32 frameLength;
+  uint32 samplesPerFrame;
+};
+
+static bool DecodeMpegHeader(const uint8 *p, MpegHeader &h) {
+  if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0)
+    return false;
+
+  static const uint32 kBitrates[2][3][16] = {
+      {{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+       {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},
+       {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320}},
+      {{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+       {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+       {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}}};
+  static const uint32 kSampleRates[3] = {44100, 48000, 32000};
+
+  const int versionBits = (p[1] >> 3) & 0x03;
+  const int layerBits = (p[1] >> 1) & 0x03;
+  const int bitrateIdx = (p[2] >> 4) & 0x0F;
+  const int rateIdx = (p[2] >> 2) & 0x03;
+  const int padding = (p[2] >> 1) & 0x01;
+
+  if (versionBits == 1 || layerBits == 0 || bitrateIdx == 0 ||
+      bitrateIdx == 15 || rateIdx == 3)
+    return false;
+
+  h.version = (versionBits == 3) ? 1 : (versionBits == 2 ? 2 : 25);
+  h.layer = 4 - layerBits;
+  h.bitrate = kBitrates[h.version == 1 ? 0 : 1][h.layer - 1][bitrateIdx];
+  h.sampleRate = kSampleRates[rateIdx];
+  if (h.version == 2)
+    h.sampleRate /= 2;
+  else if (h.version == 25)
+    h.sampleRate /= 4;
+  h.channels = ((p[3] >> 6) == 3) ? 1 : 2;
+
+  if (h.layer == 1) {
+    h.samplesPerFrame = 384;
+    h.frameLength = (12 * h.bitrate * 1000 / h.sampleRate + padding) * 4;
+  } else {
+    h.samplesPerFrame = (h.layer == 3 && h.version != 1) ? 576 : 1152;
+    h.frameLength = h.samplesPerFrame / 8 * h.bitrate * 1000 / h.sampleRate +
+                    padding;
+  }
+  return h.frameLength > 4;
+}
+
+/**
+ * @brief Derives duration and bitrate from the first MPEG frame.
+ *
+ * Uses the Xing/Info or VBRI header when present, otherwise assumes CBR at
+ * the first frame's bitrate.
+ */
+static bool ParseMpegAudio(Source &src, off_t audioStart, TagData &out) {
+  static constexpr size_t kSyncWindow = 4096;
+
+  std::vector<uint8> scratch;
+  const off_t avail = src.Size() - audioStart;
+  if (avail < 4)
+    return false;
+  const size_t window = (size_t)std::min<off_t>(avail, kSyncWindow);
+  const uint8 *buf = src.Fetch(audioStart, window, scratch);
+  if (!buf)
+    return false;
+
+  for (size_t i = 0; i + 4 <= window; i++) {
+    MpegHeader h;
+    if (!DecodeMpegHeader(buf + i, h))
+      continue;
+
+    // Require a matching second header where we can see one, to avoid false
+    // syncs inside leftover tag data
+    const size_t next = i + h.frameLength;
+    if (next + 4 <= window) {
+      MpegHeader h2;
+      if (!DecodeMpegHeader(buf + next, h2) || h2.sampleRate != h.sampleRate ||
+          h2.layer != h.layer)
+        continue;
+    }
+
+    out.sampleRate = h.sampleRate;
+    out.channels = h.channels;
+
+    const off_t streamBytes = src.Size() - (audioStart + (off_t)i);
+    const size_t sideInfo = (h.version == 1) ? (h.channels == 1 ? 17 : 32)
+                                             : (h.channels == 1 ? 9 : 17);
+    const size_t xingPos = i + 4 + sideInfo;
+    const size_t vbriPos = i + 4 + 32;
+
+    uint32 frames = 0;
+    uint32 bytes = 0;
+    if (xingPos + 16 <= window && (memcmp(buf + xingPos, "Xing", 4) == 0 ||
+                                   memcmp(buf + xingPos, "Info", 4) == 0)) {
+      const uint32 xflags = BE32(buf + xingPos + 4);
+      size_t field = xingPos + 8;
+      if (xflags & 0x01) {
+        frames = BE32(buf + field);
+        field += 4;
+      }
+      if ((xflags & 0x02) && field + 4 <= window)
+        bytes = BE32(buf + field);
+    } else if (vbriPos + 18 <= window &&
+               memcmp(buf + vbriPos, "VBRI", 4) == 0) {
+      bytes = BE32(buf + vbriPos + 10);
+      frames = BE32(buf + vbriPos + 14);
+    }
+
+    if (frames > 0) {
+      const double seconds =
+          (double)frames * h.samplesPerFrame / (double)h.sampleRate;
+      out.lengthSec = (uint32)seconds;
+      const double payload = bytes > 0 ? (double)bytes : (double)streamBytes;
+      out.bitrate =
+          seconds > 0 ? (uint32)(payload * 8.0 / seconds / 1000.0 + 0.5) : 0;
+    } else {
+      out.bitrate = h.bitrate;
+      out.lengthSec = (uint32)(streamBytes * 8 / ((off_t)h.bitrate * 1000));
+    }
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Parses a VORBIS_COMMENT block body.
+ * @param arena Receives the NUL-terminated keys and values.
+ */
+static void ParseVorbisComment(const uint8 *d, size_t n, TagData &out,
+                               Arena &arena) {
+  if (n < 8)
+    return;
+  size_t pos = 4 + LE32(d);
+  if (pos + 4 > n)
+    return;
+  uint32 count = LE32(d + pos);
+  pos += 4;
+
+  for (uint32 c = 0; c < count && pos + 4 <= n; c++) {
+    const uint32 len = LE32(d + pos);
+    pos += 4;
+    if (len > n - pos)
+      break;
+
+    const char *entry = (const char *)d + pos;
+    pos += len;
+
+    const char *eq = (const char *)memchr(entry, '=', len);
+    if (!eq)
+      continue;
+
+    const char *k = arena.CopyString(entry, eq - entry);
+    const char *value = arena.CopyString(eq + 1, entry + len - (eq + 1));
+
+    auto setOnce = [&](BString &target) {
+      if (target.IsEmpty())
+        target = value;
+    };
+
+    if (strcasecmp(k, "TITLE") == 0)
+      setOnce(out.title);
+    else if (strcasecmp(k, "ARTIST") == 0)
+      setOnce(out.artist);
+    else if (strcasecmp(k, "ALBUM") == 0)
+      setOnce(out.album);
+    else if (strcasecmp(k, "ALBUMARTIST") == 0 ||
+             strcasecmp(k, "ALBUM ARTIST") == 0)
+      setOnce(out.albumArtist);
+    else if (strcasecmp(k, "COMPOSER") == 0)
+      setOnce(out.composer);
+    else if (strcasecmp(k, "GENRE") == 0)
+      setOnce(out.genre);
+    else if (strcasecmp(k, "COMMENT") == 0 ||
+             strcasecmp(k, "DESCRIPTION") == 0)
+      setOnce(out.comment);
+    else if (strcasecmp(k, "DATE") == 0 || strcasecmp(k, "YEAR") == 0) {
+      if (out.year == 0)
+        out.year = ParseYear(value);
+    } else if (strcasecmp(k, "TRACKNUMBER") == 0)
+      ParsePair(value, out.track, out.trackTotal);
+    else if (strcasecmp(k, "TRACKTOTAL") == 0 ||
+             strcasecmp(k, "TOTALTRACKS") == 0)
+      out.trackTotal = (uint32)atoi(value);
+    else if (strcasecmp(k, "DISCNUMBER") == 0)
+      ParsePair(value, out.disc, out.discTotal);
+    else if (strcasecmp(k, "DISCTOTAL") == 0 ||
+             strcasecmp(k, "TOTALDISCS") == 0)
+      out.discTotal = (uint32)atoi(value);
+    else
+      ApplyUserText(k, value, out);
+  }
+}
+
+/**
+ * @brief Records where the image data of a FLAC PICTURE block starts.
+ */
+static void LocateFlacPicture(Source &src, off_t pos, uint32 len,
+                              CoverInfo &cover) {
+  std::vector<uint8> scratch;
+  const off_t end = pos + len;
+
+  const uint8 *p = src.Fetch(pos, 8, scratch);
+  if (!p)
+    return;
+  const uint32 mimeLen = BE32(p + 4);
+  off_t at = pos + 8;
+  if (at + (off_t)mimeLen + 4 > end)
+    return;
+
+  p = src.Fetch(at, mimeLen + 4, scratch);
+  if (!p)
+    return;
+  BString mime((const char *)p, (int32)mimeLen);
+  const uint32 descLen = BE32(p + mimeLen);
+  at += mimeLen + 4 + descLen + 16; // description, size, depth, colors
+  if (at + 4 > end)
+    return;
+
+  p = src.Fetch(at, 4, scratch);
+  if (!p)
+    return;
+  const uint32 dataLen = BE32(p);
+  at += 4;
+  if (dataLen == 0 || at + (off_t)dataLen > end)
+    return;
+
+  cover.present = true;
+  cover.offset = (uint64)at;
+  cover.size = dataLen;
+  cover.mime = mime;
+}
+
+/**
+ * @brief Walks the FLAC metadata blocks starting at @p start ("fLaC").
+ */
+static bool ParseFlac(Source &src, off_t start, TagData &out,
+                      CoverInfo &cover) {
+  std::vector<uint8> scratch;
+  std::vector<uint8> body;
+
+  off_t pos = start + 4;
+  bool haveInfo = false;
+  uint64 totalSamples = 0;
+
+  for (;;) {
+    const uint8 *bh = src.Fetch(pos, 4, scratch);
+    if (!bh)
+      return false;
+
+    const bool last = (bh[0] & 0x80) != 0;
+    const uint8 type = bh[0] & 0x7F;
+    const uint32 len = BE24(bh + 1);
+    const off_t bodyPos = pos + 4;
+    pos = bodyPos + len;
+
+    if (type == 0) {
+      if (len < 34)
+        return false;
+      const uint8 *si = src.Fetch(bodyPos, 34, body);
+      if (!si)
+        return false;
+      out.sampleRate = ((uint32)si[10] << 12) | ((uint32)si[11] << 4) |
+                       (si[12] >> 4);
+      out.channels = ((si[12] >> 1) & 0x07) + 1;
+      totalSamples = ((uint64)(si[13] & 0x0F) << 32) | BE32(si + 14);
+      haveInfo = out.sampleRate > 0;
+    } else if (type == 4) {
+      const uint8 *vc = src.Fetch(bodyPos, len, body);
+      if (vc)
+        ParseVorbisComment(vc, len, out, src.Scratch());
+    } else if (type == 6 && !cover.present) {
+      LocateFlacPicture(src, bodyPos, len, cover);
+    }
+
+    if (last || type == 127)
+      break;
+  }
+
+  if (!haveInfo)
+    return false;
+
+  if (totalSamples > 0) {
+    const double seconds = (double)totalSamples / out.sampleRate;
+    out.lengthSec = (uint32)seconds;
+    const off_t audioBytes = src.Size() - pos;
+    if (seconds > 0 && audioBytes > 0)
+      out.bitrate = (uint32)(audioBytes * 8.0 / seconds / 1000.0 + 0.5);
+  }
+  return true;
+}
+
+/**
+ * @brief Parses tags and audio properties; see FastTagReader::ReadTags().
+ */
+static bool ParseFile(Source &src, TagData &td, CoverInfo &cover) {
+  // Detect from the head buffer, or from one small read past a large tag
+  const off_t tagSize = FormatDetector::Id3v2Size(src.Head(), src.HeadSize());
+  if (tagSize >= src.Size())
+    return false;
+
+  std::vector<uint8> scratch;
+  const size_t probeSize =
+      (size_t)std::min<off_t>(FormatDetector::kProbeSize, src.Size() - tagSize);
+  const uint8 *probe = src.Fetch(tagSize, probeSize, scratch);
+  if (!probe)
+    return false;
+  td.format = FormatDetector::Detect(probe, probeSize, tagSize > 0);
+
+  // FLAC may carry a (non-standard) ID3v2 prefix, which is skipped
+  if (td.format.container == AudioContainer::FLAC)
+    return ParseFlac(src, tagSize, td, cover);
+  if (td.format.container != AudioContainer::MPEG)
+    return false; // left to TagLib
+
+  off_t audioStart = 0;
+  if (tagSize > 0 && !ParseId3v2(src, td, cover, audioStart))
+    return false;
+
+  if (!ParseMpegAudio(src, audioStart, td))
+    return false;
+
+  if (td.title.IsEmpty() || td.artist.IsEmpty() || td.album.IsEmpty())
+    ParseId3v1(src, td);
+
+  return true;
+}
+
+bool FastTagReader::ReadTags(const BPath &path, TagData &out,
+                             CoverInfo *coverOut, CoverBlob *coverData) {
+  if (path.InitCheck() != B_OK)
+    return false;
+
+  out.format = AudioFormat();
+  const int fd = open(path.Path(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  const bool handled = ReadTags(fd, out, coverOut, coverData);
+  close(fd);
+  return handled;
+}
+
+bool FastTagReader::ReadTags(int fd, TagData &out, CoverInfo *coverOut,
+                             CoverBlob *coverData) {
+  out.format = AudioFormat();
+
+  // Every buffer and string of a file comes from this arena, and is dropped
+  // in one go when the thread parses its next file
+  static thread_local Arena sScratch(kHeadSize + Arena::kDefaultBlockSize);
+  sScratch.Reset();
+
+  Source src(fd, sScratch);
+  if (!src.IsValid() || src.HeadSize() < 4)
+    return false;
+
+  TagData td;
+  CoverInfo cover;
+  if (!ParseFile(src, td, cover)) {
+    out.format = td.format;
+    return false;
+  }
+
+  if (coverData) {
+    coverData->clear();
+    if (cover.present) {
+      std::vector<uint8> scratch;
+      const uint8 *d = src.Fetch((off_t)cover.offset, cover.size, scratch);
+      if (!d)
+        return false;
+      coverData->assign(d, cover.size);
+    }
+  }
+
+  out = td;
+  if (coverOut)
+    *coverOut = cover;
+  return true;
+}
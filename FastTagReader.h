@@ -0,0 +1,59 @@
+#ifndef FAST_TAG_READER_H
+#define FAST_TAG_READER_H
+
+#include "TagData.h"
+
+#include <Path.h>
+#include <SupportDefs.h>
+
+/**
+ * @namespace FastTagReader
+ * @brief Minimal tag parser for the two most common library formats.
+ *
+ * Handles MP3 (ID3v2.3/2.4 with ID3v1 fallback, duration from the Xing/Info
+ * or VBRI header or the first frame's bitrate) and FLAC (STREAMINFO plus
+ * VORBIS_COMMENT). Only the leading tag blocks are read, normally in a single
+ * bounded read, and only the fields the library needs are decoded.
+ *
+ * Anything unusual (other formats, ID3v2.2, tag-level unsynchronisation,
+ * compressed or encrypted frames, missing MPEG sync) is rejected so the
+ * caller can fall back to TagLib.
+ */
+namespace FastTagReader {
+
+/** @brief Size of the initial bounded read at the start of the file. */
+static constexpr size_t kHeadSize = 64 * 1024;
+
+/**
+ * @brief Reads tags and audio properties without TagLib.
+ *
+ * Fills title, artist, album, albumArtist, composer, genre, comment, year,
+ * track/trackTotal, disc/discTotal, the MusicBrainz and AcoustID IDs,
+ * lengthSec, bitrate, sampleRate and channels.
+ *
+ * @param path The audio file.
+ * @param out Receives the metadata. Only valid if true is returned, except
+ * for out.format, which is always set from the bytes already read so that a
+ * TagLib fallback needs no detection read of its own.
+ * @param coverOut Optional; receives the location of the first embedded
+ * picture (APIC frame or FLAC PICTURE block).
+ * @param coverData Optional; receives the picture bytes, read from the same
+ * open file.
+ * @return True if the file was fully handled, false if the caller should use
+ * TagLib instead.
+ */
+bool ReadTags(const BPath &path, TagData &out, CoverInfo *coverOut = nullptr,
+              CoverBlob *coverData = nullptr);
+
+/**
+ * @brief Like ReadTags() above, on a file the caller has open.
+ *
+ * Only positioned reads are used, so the offset of @p fd is left alone and
+ * the caller can hand the same descriptor to TagLib afterwards.
+ */
+bool ReadTags(int fd, TagData &out, CoverInfo *coverOut = nullptr,
+              CoverBlob *coverData = nullptr);
+
+} // namespace FastTagReader
+
+#endif // FAST_TAG_READER_H
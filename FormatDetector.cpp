@@ -0,0 +1,131 @@
+#include "FormatDetector.h"
+
+#include <string.h>
+
+namespace {
+
+/**
+ * @struct MagicPattern
+ * @brief Bytes expected at a fixed offset, optionally under a bit mask.
+ */
+struct MagicPattern {
+  uint8 offset;
+  uint8 length; ///< 0 for an unused pattern.
+  const char *bytes;
+  const char *mask; ///< nullptr to compare the bytes exactly.
+};
+
+/**
+ * @struct Signature
+ * @brief One table row: all patterns must match.
+ */
+struct Signature {
+  MagicPattern first;
+  MagicPattern second;
+  AudioContainer container;
+  AudioCodec codec;
+};
+
+constexpr MagicPattern kNone = {0, 0, nullptr, nullptr};
+
+/**
+ * @brief Known signatures, most specific first.
+ *
+ * ADTS precedes MPEG audio because its sync word also passes the MPEG mask,
+ * and the Ogg codec rows precede the generic Ogg row. The Ogg codec rows
+ * assume a first page with a single segment, which is what every encoder
+ * writes for the identification header.
+ */
+constexpr Signature kSignatures[] = {
+    {{0, 4, "fLaC", nullptr}, kNone, AudioContainer::FLAC, AudioCodec::FLAC},
+    {{0, 4, "OggS", nullptr},
+     {28, 7, "\x01vorbis", nullptr},
+     AudioContainer::Ogg,
+     AudioCodec::Vorbis},
+    {{0, 4, "OggS", nullptr},
+     {28, 8, "OpusHead", nullptr},
+     AudioContainer::Ogg,
+     AudioCodec::Opus},
+    {{0, 4, "OggS", nullptr},
+     {28, 5, "\x7F" "FLAC", nullptr},
+     AudioContainer::Ogg,
+     AudioCodec::FLAC},
+    {{0, 4, "OggS", nullptr}, kNone, AudioContainer::Ogg, AudioCodec::Unknown},
+    {{0, 4, "RIFF", nullptr},
+     {8, 4, "WAVE", nullptr},
+     AudioContainer::WAV,
+     AudioCodec::PCM},
+    {{0, 4, "FORM", nullptr},
+     {8, 4, "AIFF", nullptr},
+     AudioContainer::AIFF,
+     AudioCodec::PCM},
+    {{4, 4, "ftyp", nullptr},
+     {8, 3, "M4A", nullptr},
+     AudioContainer::MP4,
+     AudioCodec::AAC},
+    {{4, 4, "ftyp", nullptr}, kNone, AudioContainer::MP4, AudioCodec::Unknown},
+    {{0, 16,
+      "\x30\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C",
+      nullptr},
+     kNone,
+     AudioContainer::ASF,
+     AudioCodec::WMA},
+    {{0, 2, "\xFF\xF0", "\xFF\xF6"}, kNone, AudioContainer::ADTS,
+     AudioCodec::AAC},
+    // Frame sync plus a valid layer (the reserved layer 00 is ADTS)
+    {{0, 2, "\xFF\xE0", "\xFF\xE0"}, kNone, AudioContainer::MPEG,
+     AudioCodec::MP3},
+};
+
+bool Matches(const MagicPattern &p, const uint8 *data, size_t size) {
+  if (p.length == 0)
+    return true;
+  if ((size_t)p.offset + p.length > size)
+    return false;
+
+  const uint8 *d = data + p.offset;
+  const uint8 *want = reinterpret_cast<const uint8 *>(p.bytes);
+  if (!p.mask)
+    return memcmp(d, want, p.length) == 0;
+
+  const uint8 *mask = reinterpret_cast<const uint8 *>(p.mask);
+  for (uint8 i = 0; i < p.length; i++) {
+    if ((d[i] & mask[i]) != want[i])
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+off_t FormatDetector::Id3v2Size(const uint8 *data, size_t size) {
+  if (size < 10 || memcmp(data, "ID3", 3) != 0)
+    return 0;
+
+  const off_t tagSize = ((off_t)(data[6] & 0x7F) << 21) |
+                        ((off_t)(data[7] & 0x7F) << 14) |
+                        ((off_t)(data[8] & 0x7F) << 7) | (data[9] & 0x7F);
+  return 10 + tagSize + ((data[5] & 0x10) ? 10 : 0);
+}
+
+AudioFormat FormatDetector::Detect(const uint8 *data, size_t size,
+                                   bool afterId3) {
+  AudioFormat format;
+  for (const Signature &sig : kSignatures) {
+    if (Matches(sig.first, data, size) && Matches(sig.second, data, size)) {
+      if (sig.container == AudioContainer::MPEG &&
+          (data[1] & 0x06) == 0) // layer 00 is reserved
+        continue;
+      format.container = sig.container;
+      format.codec = sig.codec;
+      return format;
+    }
+  }
+
+  // An ID3v2 tag followed by padding or junk is still an MP3
+  if (afterId3) {
+    format.container = AudioContainer::MPEG;
+    format.codec = AudioCodec::MP3;
+  }
+  return format;
+}
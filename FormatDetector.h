@@ -0,0 +1,78 @@
+#ifndef FORMAT_DETECTOR_H
+#define FORMAT_DETECTOR_H
+
+#include <SupportDefs.h>
+
+/**
+ * @brief Container formats recognised by their magic bytes.
+ *
+ * `Other` marks files without a known signature that TagLib could still
+ * open; `Unknown` files are not treated as audio.
+ */
+enum class AudioContainer : uint8 {
+  Unknown,
+  Other,
+  MPEG,
+  ADTS,
+  FLAC,
+  Ogg,
+  WAV,
+  AIFF,
+  MP4,
+  ASF
+};
+
+/** @brief Audio codecs that can be told from the leading bytes. */
+enum class AudioCodec : uint8 {
+  Unknown,
+  MP3,
+  AAC,
+  FLAC,
+  Vorbis,
+  Opus,
+  PCM,
+  WMA
+};
+
+/**
+ * @struct AudioFormat
+ * @brief Container and (if known) codec of a file.
+ */
+struct AudioFormat {
+  AudioContainer container = AudioContainer::Unknown;
+  AudioCodec codec = AudioCodec::Unknown;
+
+  bool IsAudio() const { return container != AudioContainer::Unknown; }
+};
+
+/**
+ * @namespace FormatDetector
+ * @brief Identifies audio files from their first bytes.
+ *
+ * Works on bytes the caller has already read (normally FastTagReader's head
+ * buffer), so detection costs no I/O of its own. Signatures come from a
+ * compile-time table; a leading ID3v2 tag is skipped first, since it can
+ * precede both MPEG audio and (non-standard) FLAC streams.
+ */
+namespace FormatDetector {
+
+/** @brief Bytes at the start of the audio data that Detect() looks at. */
+static constexpr size_t kProbeSize = 64;
+
+/**
+ * @brief Size of a leading ID3v2 tag, including its footer.
+ * @return The offset of the audio data, or 0 if there is no ID3v2 tag.
+ */
+off_t Id3v2Size(const uint8 *data, size_t size);
+
+/**
+ * @brief Matches the bytes at the start of the audio data against the table.
+ * @param data Up to kProbeSize bytes at offset Id3v2Size().
+ * @param size Number of valid bytes in @p data.
+ * @param afterId3 True if the data follows an ID3v2 tag.
+ */
+AudioFormat Detect(const uint8 *data, size_t size, bool afterId3 = false);
+
+} // namespace FormatDetector
+
+#endif // FORMAT_DETECTOR_H
@@ -0,0 +1,104 @@
+#include "LibraryFilter.h"
+#include "Trace.h"
+
+void LibraryFilter::SetGenre(Mode mode, const BString &genre) {
+  fGenreMode = mode;
+  fGenre = genre;
+}
+
+void LibraryFilter::SetArtist(Mode mode, const BString &artist) {
+  fArtistMode = mode;
+  fArtist = artist;
+}
+
+void LibraryFilter::SetAlbum(Mode mode, const BString &album, int32 year) {
+  fAlbumMode = mode;
+  fAlbum = album;
+  fAlbumYear = year;
+}
+
+bool LibraryFilter::_GenreMatches(const MediaItem &item) const {
+  switch (fGenreMode) {
+  case kUntagged:
+    return item.genre.IsEmpty();
+  case kValue:
+    return item.genre == fGenre;
+  default:
+    return true;
+  }
+}
+
+bool LibraryFilter::_ArtistMatches(const MediaItem &item) const {
+  switch (fArtistMode) {
+  case kUntagged:
+    return item.artist.IsEmpty();
+  case kValue:
+    return item.artist == fArtist;
+  default:
+    return true;
+  }
+}
+
+bool LibraryFilter::_AlbumMatches(const MediaItem &item) const {
+  switch (fAlbumMode) {
+  case kUntagged:
+    return item.album.IsEmpty();
+  case kValue:
+    return item.album == fAlbum && (fAlbumYear < 0 || item.year == fAlbumYear);
+  default:
+    return true;
+  }
+}
+
+bool LibraryFilter::_TextMatches(const MediaItem &item) const {
+  if (fText.IsEmpty())
+    return true;
+  return item.title.IFindFirst(fText) >= 0 ||
+         item.artist.IFindFirst(fText) >= 0 ||
+         item.album.IFindFirst(fText) >= 0;
+}
+
+void LibraryFilter::Apply(const std::vector<MediaItem> &items,
+                          LibraryFilterResult &result) const {
+  TRACE_SCOPE_ARG("filter", "LibraryFilter::Apply", "items", items.size());
+  result = LibraryFilterResult();
+
+  // Column contents
+  for (const auto &it : items) {
+    if (!_TextMatches(it))
+      continue;
+
+    if (it.genre.IsEmpty())
+      result.untaggedGenre = true;
+    else
+      result.genres.insert(it.genre);
+
+    if (!_GenreMatches(it))
+      continue;
+
+    if (it.artist.IsEmpty())
+      result.untaggedArtist = true;
+    else
+      result.artists.insert(it.artist);
+
+    if (!_ArtistMatches(it))
+      continue;
+
+    if (it.album.IsEmpty())
+      result.untaggedAlbum = true;
+    else
+      result.albums[it.album].insert(it.year);
+  }
+
+  // Tracks
+  result.items.reserve(items.size());
+  for (size_t i = 0; i < items.size(); i++) {
+    const MediaItem &it = items[i];
+    if (!(_GenreMatches(it) && _ArtistMatches(it) && _AlbumMatches(it)))
+      continue;
+    if (!_TextMatches(it))
+      continue;
+    result.items.push_back((int32)i);
+    result.duration += it.duration;
+  }
+}
@@ -0,0 +1,94 @@
+#ifndef LIBRARY_FILTER_H
+#define LIBRARY_FILTER_H
+
+#include "MediaItem.h"
+#include <String.h>
+#include <SupportDefs.h>
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * @struct LibraryFilterResult
+ * @brief Everything the column browser shows for one selection.
+ */
+struct LibraryFilterResult {
+  /** @name Column Contents */
+  ///@{
+  std::set<BString> genres; ///< Genres of all items matching the text.
+  bool untaggedGenre = false;
+
+  std::set<BString> artists; ///< Artists within the selected genre.
+  bool untaggedArtist = false;
+
+  /// Albums within the selected genre and artist, with their years.
+  std::map<BString, std::set<int32>> albums;
+  bool untaggedAlbum = false;
+  ///@}
+
+  /** @name Tracks */
+  ///@{
+  /// Indices (into the vector given to Apply()) of the items matching every
+  /// column and the text, in their original order.
+  std::vector<int32> items;
+  int64 duration = 0; ///< Total duration of items in seconds.
+  ///@}
+};
+
+/**
+ * @class LibraryFilter
+ * @brief The Genre -> Artist -> Album -> Text filter of the column browser.
+ *
+ * Holds no UI state: the LibraryViewManager translates the selected rows
+ * into a filter and fills its views from the result, and the benchmarks run
+ * it on synthetic libraries.
+ */
+class LibraryFilter {
+public:
+  /** @brief How a column restricts the items. */
+  enum Mode {
+    kAny,      ///< No selection or "Show all".
+    kUntagged, ///< Only items without a value ("No Genre", ...).
+    kValue     ///< Only items with the given value.
+  };
+
+  void SetGenre(Mode mode, const BString &genre = "");
+  void SetArtist(Mode mode, const BString &artist = "");
+
+  /**
+   * @brief Restricts the album column.
+   * @param year Only items of this year (for albums shown once per year), or
+   * -1 for any year.
+   */
+  void SetAlbum(Mode mode, const BString &album = "", int32 year = -1);
+
+  /** @brief Case-insensitive search in title, artist and album. */
+  void SetText(const BString &text) { fText = text; }
+
+  /**
+   * @brief Filters @p items.
+   *
+   * The genre list only honours the text, the artist list also the genre,
+   * the album list also the artist; the tracks honour everything. Nothing
+   * is copied: the tracks are returned as indices into @p items.
+   */
+  void Apply(const std::vector<MediaItem> &items,
+             LibraryFilterResult &result) const;
+
+private:
+  bool _GenreMatches(const MediaItem &item) const;
+  bool _ArtistMatches(const MediaItem &item) const;
+  bool _AlbumMatches(const MediaItem &item) const;
+  bool _TextMatches(const MediaItem &item) const;
+
+  Mode fGenreMode = kAny;
+  BString fGenre;
+  Mode fArtistMode = kAny;
+  BString fArtist;
+  Mode fAlbumMode = kAny;
+  BString fAlbum;
+  int32 fAlbumYear = -1;
+  BString fText;
+};
+
+#endif // LIBRARY_FILTER_H
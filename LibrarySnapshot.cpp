@@ -0,0 +1,112 @@
+#include "LibrarySnapshot.h"
+#include "MediaBatch.h"
+
+#include <File.h>
+#include <Message.h>
+
+/** @brief Field names of the columns, indexed by LibrarySnapshot::Column. */
+static const char *const kColumnNames[LibrarySnapshot::kColumnCount] = {
+    "genre", "artist", "album"};
+
+status_t LibrarySnapshot::Load(const char *path) {
+  Clear();
+
+  BFile file(path, B_READ_ONLY);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  BMessage archive;
+  status = archive.Unflatten(&file);
+  if (status != B_OK)
+    return status;
+
+  if (archive.GetInt32("version", 0) != kVersion)
+    return B_BAD_DATA;
+
+  for (int32 c = 0; c < kColumnCount; c++) {
+    BMessage column;
+    if (archive.FindMessage(kColumnNames[c], &column) != B_OK)
+      continue;
+
+    ColumnState &state = columns[c];
+    BString text;
+    for (int32 i = 0; column.FindString("text", i, &text) == B_OK; i++) {
+      state.texts.push_back(text);
+      state.data.push_back(column.GetString("data", i, ""));
+    }
+    state.selection = column.GetInt32("selection", -1);
+    if (state.selection >= (int32)state.texts.size())
+      state.selection = -1;
+    state.scrollTop = column.GetFloat("scroll", 0);
+  }
+  filterText = archive.GetString("filter", "");
+
+  MediaBatchReader batch;
+  status = batch.SetTo(&archive);
+  if (status == B_OK) {
+    rows.resize(batch.CountItems());
+    for (int32 i = 0; i < batch.CountItems(); i++)
+      batch.ItemAt(i, rows[i]);
+  } else if (status != B_NAME_NOT_FOUND) {
+    Clear();
+    return status;
+  }
+
+  topIndex = archive.GetInt32("top", 0);
+  topOffset = archive.GetFloat("topOffset", 0);
+  scrollLeft = archive.GetFloat("scrollLeft", 0);
+  trackCount = archive.GetInt32("tracks", 0);
+  duration = archive.GetInt64("duration", 0);
+  return B_OK;
+}
+
+status_t LibrarySnapshot::Save(const char *path) const {
+  BMessage archive;
+  archive.AddInt32("version", kVersion);
+
+  for (int32 c = 0; c < kColumnCount; c++) {
+    const ColumnState &state = columns[c];
+    BMessage column;
+    for (size_t i = 0; i < state.texts.size(); i++) {
+      column.AddString("text", state.texts[i]);
+      column.AddString("data", i < state.data.size() ? state.data[i] : "");
+    }
+    column.AddInt32("selection", state.selection);
+    column.AddFloat("scroll", state.scrollTop);
+    archive.AddMessage(kColumnNames[c], &column);
+  }
+  archive.AddString("filter", filterText);
+
+  if (!rows.empty()) {
+    MediaBatchWriter writer;
+    writer.Reserve(rows.size());
+    for (const MediaItem &item : rows)
+      writer.Add(item);
+    writer.AddToMessage(archive);
+  }
+
+  archive.AddInt32("top", topIndex);
+  archive.AddFloat("topOffset", topOffset);
+  archive.AddFloat("scrollLeft", scrollLeft);
+  archive.AddInt32("tracks", trackCount);
+  archive.AddInt64("duration", duration);
+
+  BFile file(path, B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+  return archive.Flatten(&file);
+}
+
+void LibrarySnapshot::Clear() {
+  for (ColumnState &state : columns)
+    state = ColumnState();
+  filterText = "";
+  rows.clear();
+  topIndex = 0;
+  topOffset = 0;
+  scrollLeft = 0;
+  trackCount = 0;
+  duration = 0;
+}
@@ -0,0 +1,69 @@
+#ifndef LIBRARY_SNAPSHOT_H
+#define LIBRARY_SNAPSHOT_H
+
+#include "MediaItem.h"
+
+#include <String.h>
+#include <SupportDefs.h>
+#include <vector>
+
+/**
+ * @struct LibrarySnapshot
+ * @brief What the column browser showed when BeTon quit, painted at the next
+ * start before the cache is loaded.
+ *
+ * Only a screenful of tracks is kept (the rows from the first visible one
+ * on), so reading it takes the same few milliseconds for any library size.
+ * The LibraryViewManager shows it at the scroll positions it was taken at
+ * and replaces it with the real contents once the cache is there, keeping
+ * the track list where it was; selections made in between apply then.
+ */
+struct LibrarySnapshot {
+  /** @brief Version of the layout written by Save(). */
+  static constexpr int32 kVersion = 1;
+
+  /** @brief Tracks kept, starting at the first visible row. */
+  static constexpr int32 kMaxRows = 200;
+
+  /** @brief The filter columns, left to right. */
+  enum Column { kGenre, kArtist, kAlbum, kColumnCount };
+
+  /**
+   * @struct ColumnState
+   * @brief Rows, selection and scroll position of one SimpleColumnView.
+   */
+  struct ColumnState {
+    std::vector<BString> texts;
+    std::vector<BString> data; ///< Hidden data per row, e.g. "Album|Year".
+    int32 selection = -1;
+    float scrollTop = 0; ///< Vertical scroll offset in pixels.
+  };
+
+  ColumnState columns[kColumnCount];
+  BString filterText; ///< Contents of the search field.
+
+  /** @name Tracks */
+  ///@{
+  std::vector<MediaItem> rows; ///< In display order, from the top row on.
+  int32 topIndex = 0;   ///< Index of rows[0] in the full track list.
+  float topOffset = 0;  ///< Pixels of rows[0] scrolled out at the top.
+  float scrollLeft = 0; ///< Horizontal scroll offset in pixels.
+  int32 trackCount = 0; ///< Tracks matching the selection, for the status.
+  int64 duration = 0;   ///< Their total duration in seconds.
+  ///@}
+
+  /**
+   * @brief Replaces the contents with those of a snapshot file.
+   * @return B_OK, B_BAD_DATA for a snapshot of another version or
+   * MediaBatch layout, or the error from opening or unflattening the file.
+   * On error the snapshot is left empty.
+   */
+  status_t Load(const char *path);
+
+  /** @brief Writes the snapshot to @p path. */
+  status_t Save(const char *path) const;
+
+  void Clear();
+};
+
+#endif // LIBRARY_SNAPSHOT_H
@@ -0,0 +1,794 @@
+#include "LibraryStore.h"
+#include "Debug.h"
+#include "MediaBatch.h"
+#include "Trace.h"
+
+#include <ByteOrder.h>
+#include <Entry.h>
+#include <File.h>
+#include <Message.h>
+#include <OS.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace {
+
+/** @brief First bytes of a version 4 cache; version 1 is a BMessage. */
+const char kCacheMagic[8] = {'B', 'e', 'T', 'o', 'n', 'L', 'i', 'b'};
+
+/** @brief First bytes of a journal (see LibraryStore::AppendJournal()). */
+const char kJournalMagic[8] = {'B', 'e', 'T', 'o', 'n', 'J', 'n', 'l'};
+
+/** @name Block Types */
+///@{
+const uint32 kBatchBlock = 'MBAT';      ///< A MediaBatch blob.
+const uint32 kQuarantineBlock = 'QUAR'; ///< Quarantine records.
+///@}
+
+/**
+ * @struct CacheFileHeader
+ * @brief Start of a version 4 cache, followed by its blocks. Little-endian.
+ */
+struct CacheFileHeader {
+  char magic[8];  ///< kCacheMagic or kJournalMagic.
+  uint32 version; ///< LibraryStore::kVersion.
+  uint32 entries; ///< Entries in all kBatchBlock blocks.
+};
+
+/**
+ * @struct CacheBlockHeader
+ * @brief Start of a block of a version 4 cache. Little-endian.
+ *
+ * The payload follows, padded with zeros to a multiple of 8 bytes.
+ */
+struct CacheBlockHeader {
+  uint32 type;     ///< kBatchBlock or kQuarantineBlock.
+  uint32 size;     ///< Payload bytes, without the padding.
+  uint64 checksum; ///< BlockChecksum() of the payload.
+};
+
+/** @brief Entries per block when decoding a version 1 cache. */
+const int32 kEntryMessagesPerBlock = 1024;
+
+/**
+ * @brief FNV-1a over little-endian 64-bit words, for telling a damaged blob
+ * from a good one. Not meant to resist deliberate changes.
+ */
+uint64 BlockChecksum(const void *data, size_t size) {
+  const uint64 kPrime = 0x100000001b3ULL;
+  uint64 hash = 0xcbf29ce484222325ULL;
+  const uint8 *bytes = static_cast<const uint8 *>(data);
+  for (; size >= sizeof(uint64);
+       bytes += sizeof(uint64), size -= sizeof(uint64)) {
+    uint64 word;
+    memcpy(&word, bytes, sizeof(word));
+    hash = (hash ^ B_LENDIAN_TO_HOST_INT64(word)) * kPrime;
+  }
+  for (; size > 0; bytes++, size--)
+    hash = (hash ^ *bytes) * kPrime;
+  return hash;
+}
+
+/**
+ * @struct CacheBlock
+ * @brief A part of a cache file that is verified and decoded on its own:
+ * one MediaBatch blob, or a range of "entry" messages of a version 1 cache.
+ */
+struct CacheBlock {
+  /** @name Blob */
+  ///@{
+  const void *data = nullptr;
+  size_t size = 0;
+  uint64 checksum = 0;
+  ///@}
+
+  /** @name Entry messages */
+  ///@{
+  int32 firstEntry = 0;
+  int32 entryCount = 0;
+  ///@}
+
+  MediaBatchReader reader;
+  std::vector<MediaItem> items;
+  status_t status = B_OK;
+};
+
+/**
+ * @struct CacheDecodeJob
+ * @brief The blocks of one LibraryStore::Load(), shared by the decode
+ * threads.
+ *
+ * Each thread takes the next undecoded block until none are left; the
+ * loading thread waits for the blocks in file order and merges them.
+ */
+struct CacheDecodeJob {
+  const BMessage *archive = nullptr;
+  std::vector<CacheBlock> blocks;
+  std::vector<bool> done; ///< Per block, guarded by @c lock.
+  std::atomic<size_t> next{0};
+  std::mutex lock;
+  std::condition_variable decoded;
+};
+
+/**
+ * @brief Decodes one message of a version 1 cache.
+ *
+ * The message lacks most of the tag set, so the mtime is left at 0 and the
+ * next scan parses the file once more.
+ */
+void DecodeEntryMessage(const BMessage &item, MediaItem &entry) {
+  entry.path = item.GetString("path", "");
+  entry.base = item.GetString("base", "");
+  entry.title = item.GetString("title", "");
+  entry.artist = item.GetString("artist", "");
+  entry.album = item.GetString("album", "");
+  entry.genre = item.GetString("genre", "");
+  entry.year = item.GetInt32("year", 0);
+  entry.track = item.GetInt32("track", 0);
+  entry.disc = item.GetInt32("disc", 0);
+  entry.duration = item.GetInt32("duration", 0);
+  entry.bitrate = item.GetInt32("bitrate", 0);
+  entry.size = item.GetInt64("size", 0);
+  entry.mtime = 0;
+  entry.inode = item.GetInt64("inode", 0);
+  entry.missing = item.GetBool("missing", false);
+
+  entry.mbAlbumId = item.GetString("mbAlbumId", "");
+  entry.mbArtistId = item.GetString("mbArtistId", "");
+  entry.mbTrackId = item.GetString("mbTrackId", "");
+}
+
+/**
+ * @brief Verifies and decodes @p block into its items.
+ *
+ * A blob is checked against its checksum before its layout is, so a
+ * damaged cache fails here instead of decoding garbage.
+ */
+void DecodeBlock(const CacheDecodeJob &job, CacheBlock &block) {
+  if (block.data == nullptr) {
+    TRACE_SCOPE_ARG("cache", "DecodeEntries", "entries", block.entryCount);
+    block.items.resize(block.entryCount);
+    BMessage item;
+    for (int32 i = 0; i < block.entryCount; i++) {
+      if (job.archive->FindMessage("entry", block.firstEntry + i, &item) !=
+          B_OK) {
+        block.items.resize(i);
+        break;
+      }
+      DecodeEntryMessage(item, block.items[i]);
+    }
+    return;
+  }
+
+  TRACE_SCOPE_ARG("cache", "DecodeBlock", "bytes", block.size);
+  if (BlockChecksum(block.data, block.size) != block.checksum) {
+    block.status = B_BAD_DATA;
+    return;
+  }
+  block.status = block.reader.SetTo(block.data, block.size);
+  if (block.status != B_OK)
+    return;
+
+  const int32 count = block.reader.CountItems();
+  block.items.resize(count);
+  for (int32 i = 0; i < count; i++)
+    block.reader.ItemAt(i, block.items[i]);
+}
+
+/** @brief Body of a decode thread, also run inline without threads. */
+status_t DecodeBlocks(void *data) {
+  CacheDecodeJob *job = static_cast<CacheDecodeJob *>(data);
+  for (size_t i; (i = job->next.fetch_add(1)) < job->blocks.size();) {
+    DecodeBlock(*job, job->blocks[i]);
+
+    std::lock_guard<std::mutex> lock(job->lock);
+    job->done[i] = true;
+    job->decoded.notify_all();
+  }
+  return B_OK;
+}
+
+/**
+ * @brief Decodes the blocks of @p job on up to @p threadCount threads and
+ * merges them into @p entries in file order.
+ *
+ * Each block is freed once merged, so at most the blocks in flight are held
+ * twice.
+ */
+status_t DecodeInto(CacheDecodeJob &job, int32 threadCount, const char *path,
+                    int32 total, const LibraryStore::ChunkFunc &onChunk,
+                    std::map<BString, MediaItem> &entries) {
+  job.done.resize(job.blocks.size());
+
+  std::vector<thread_id> threads;
+  for (int32 i = 0; threadCount > 1 && i < threadCount; i++) {
+    thread_id thread = spawn_thread(DecodeBlocks, "LibraryStore Decode",
+                                    B_NORMAL_PRIORITY, &job);
+    if (thread < B_OK)
+      break;
+    resume_thread(thread);
+    threads.push_back(thread);
+  }
+  if (threads.empty())
+    DecodeBlocks(&job);
+
+  status_t status = B_OK;
+  for (size_t i = 0; i < job.blocks.size(); i++) {
+    {
+      std::unique_lock<std::mutex> lock(job.lock);
+      job.decoded.wait(lock, [&] { return job.done[i]; });
+    }
+
+    CacheBlock &block = job.blocks[i];
+    if (block.status != B_OK) {
+      DEBUG_PRINT("[LibraryStore] Block %zu of %s is damaged: %s\n", i, path,
+                  strerror(block.status));
+      status = block.status;
+      // Let the threads run out of blocks
+      job.next = job.blocks.size();
+      break;
+    }
+
+    // Blobs are written in path order, so each node goes to the end. A
+    // version 1 cache may repeat a path; the last entry wins, as it always
+    // did.
+    for (MediaItem &item : block.items) {
+      BString key = item.path;
+      entries.insert_or_assign(entries.end(), std::move(key),
+                               std::move(item));
+    }
+    std::vector<MediaItem>().swap(block.items);
+
+    if (onChunk && block.data != nullptr)
+      onChunk(block.reader, (int32)entries.size(), total);
+  }
+
+  for (thread_id thread : threads) {
+    status_t result;
+    wait_for_thread(thread, &result);
+  }
+  return status;
+}
+
+/** @brief Writes all of @p data, or fails. */
+status_t WriteAll(BDataIO &out, const void *data, size_t size) {
+  const ssize_t written = out.Write(data, size);
+  if (written < 0)
+    return (status_t)written;
+  return (size_t)written == size ? B_OK : B_IO_ERROR;
+}
+
+/** @brief Writes the header of a version 4 cache or journal. */
+status_t WriteFileHeader(BDataIO &out, const char *magic, uint32 entries) {
+  CacheFileHeader header;
+  memcpy(header.magic, magic, sizeof(header.magic));
+  header.version = B_HOST_TO_LENDIAN_INT32(LibraryStore::kVersion);
+  header.entries = B_HOST_TO_LENDIAN_INT32(entries);
+  return WriteAll(out, &header, sizeof(header));
+}
+
+/** @brief Writes one block of a version 4 cache, padding included. */
+status_t WriteBlock(BDataIO &out, uint32 type, const void *data,
+                    size_t size) {
+  static const uint8 kPadding[8] = {};
+  CacheBlockHeader header;
+  header.type = B_HOST_TO_LENDIAN_INT32(type);
+  header.size = B_HOST_TO_LENDIAN_INT32((uint32)size);
+  header.checksum = B_HOST_TO_LENDIAN_INT64(BlockChecksum(data, size));
+
+  status_t status = WriteAll(out, &header, sizeof(header));
+  if (status == B_OK)
+    status = WriteAll(out, data, size);
+  if (status == B_OK && size % 8 != 0)
+    status = WriteAll(out, kPadding, 8 - size % 8);
+  return status;
+}
+
+/**
+ * @brief Takes the block at the start of @p data off it.
+ *
+ * Only the framing is checked here; the checksum is verified when the block
+ * is decoded.
+ * @param type Receives the block type.
+ * @param block Receives the payload and its checksum.
+ * @return B_OK, or B_BAD_DATA if the block runs past the end of the file.
+ */
+status_t NextBlock(const uint8 *&data, size_t &size, uint32 &type,
+                   CacheBlock &block) {
+  CacheBlockHeader header;
+  if (size < sizeof(header))
+    return B_BAD_DATA;
+  memcpy(&header, data, sizeof(header));
+
+  const size_t payload = B_LENDIAN_TO_HOST_INT32(header.size);
+  const size_t padded = (payload + 7) & ~(size_t)7;
+  if (size - sizeof(header) < padded)
+    return B_BAD_DATA;
+
+  type = B_LENDIAN_TO_HOST_INT32(header.type);
+  block.data = data + sizeof(header);
+  block.size = payload;
+  block.checksum = B_LENDIAN_TO_HOST_INT64(header.checksum);
+  data += sizeof(header) + padded;
+  size -= sizeof(header) + padded;
+  return B_OK;
+}
+
+/**
+ * @brief Reads a whole version 4 cache or journal and checks its header.
+ * @return B_OK, B_BAD_DATA if it is not one with @p magic and kVersion, or
+ * the error from reading it.
+ */
+status_t ReadBlockFile(BFile &file, const char *magic,
+                       std::unique_ptr<uint8[]> &data, size_t &size) {
+  off_t fileSize = 0;
+  status_t status = file.GetSize(&fileSize);
+  if (status != B_OK)
+    return status;
+  if (fileSize < (off_t)sizeof(CacheFileHeader))
+    return B_BAD_DATA;
+
+  size = (size_t)fileSize;
+  data.reset(new (std::nothrow) uint8[size]);
+  if (!data)
+    return B_NO_MEMORY;
+  const ssize_t bytes = file.ReadAt(0, data.get(), size);
+  if (bytes < 0)
+    return (status_t)bytes;
+  if ((size_t)bytes != size)
+    return B_IO_ERROR;
+
+  CacheFileHeader header;
+  memcpy(&header, data.get(), sizeof(header));
+  if (memcmp(header.magic, magic, sizeof(header.magic)) != 0 ||
+      B_LENDIAN_TO_HOST_INT32(header.version) !=
+          (uint32)LibraryStore::kVersion)
+    return B_BAD_DATA;
+  return B_OK;
+}
+
+/**
+ * @struct QuarantineRecord
+ * @brief One record of a kQuarantineBlock, followed by the path and the
+ * reason, without terminators. Little-endian.
+ */
+struct QuarantineRecord {
+  int64 size;
+  int64 mtime;
+  uint32 pathLength;
+  uint32 reasonLength;
+};
+
+/** @brief Appends the record for @p path to a kQuarantineBlock payload. */
+void AddQuarantineRecord(std::vector<uint8> &out, const BString &path,
+                         const QuarantinedFile &file) {
+  QuarantineRecord record;
+  record.size = (int64)B_HOST_TO_LENDIAN_INT64(file.size);
+  record.mtime = (int64)B_HOST_TO_LENDIAN_INT64(file.mtime);
+  record.pathLength = B_HOST_TO_LENDIAN_INT32(path.Length());
+  record.reasonLength = B_HOST_TO_LENDIAN_INT32(file.reason.Length());
+
+  const uint8 *bytes = reinterpret_cast<const uint8 *>(&record);
+  out.insert(out.end(), bytes, bytes + sizeof(record));
+  out.insert(out.end(), path.String(), path.String() + path.Length());
+  out.insert(out.end(), file.reason.String(),
+             file.reason.String() + file.reason.Length());
+}
+
+/** @brief Verifies a kQuarantineBlock and adds its records to @p out. */
+status_t ReadQuarantineBlock(const CacheBlock &block,
+                             std::map<BString, QuarantinedFile> &out) {
+  if (BlockChecksum(block.data, block.size) != block.checksum)
+    return B_BAD_DATA;
+
+  const uint8 *data = static_cast<const uint8 *>(block.data);
+  size_t size = block.size;
+  while (size > 0) {
+    QuarantineRecord record;
+    if (size < sizeof(record))
+      return B_BAD_DATA;
+    memcpy(&record, data, sizeof(record));
+    data += sizeof(record);
+    size -= sizeof(record);
+
+    const size_t pathLength = B_LENDIAN_TO_HOST_INT32(record.pathLength);
+    const size_t reasonLength = B_LENDIAN_TO_HOST_INT32(record.reasonLength);
+    if (size < pathLength + reasonLength)
+      return B_BAD_DATA;
+
+    const char *strings = reinterpret_cast<const char *>(data);
+    QuarantinedFile &file = out[BString(strings, (int32)pathLength)];
+    file.size = (int64)B_LENDIAN_TO_HOST_INT64(record.size);
+    file.mtime = (int64)B_LENDIAN_TO_HOST_INT64(record.mtime);
+    file.reason.SetTo(strings + pathLength, (int32)reasonLength);
+    data += pathLength + reasonLength;
+    size -= pathLength + reasonLength;
+  }
+  return B_OK;
+}
+
+} // namespace
+
+/**
+ * @brief Reads the cache, in whichever format it was written, and decodes
+ * its blocks on a few threads.
+ *
+ * Reading the file stays on the calling thread; the blocks are checked and
+ * turned into MediaItems concurrently, which is most of the work, while this
+ * thread moves the finished ones into the map.
+ */
+status_t LibraryStore::Load(const char *path, const ChunkFunc &onChunk) {
+  Clear();
+
+  BFile file(path, B_READ_ONLY);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  off_t size = 0;
+  status = file.GetSize(&size);
+  if (status != B_OK)
+    return status;
+
+  char magic[sizeof(kCacheMagic)];
+  if (size >= (off_t)sizeof(CacheFileHeader) &&
+      file.ReadAt(0, magic, sizeof(magic)) == (ssize_t)sizeof(magic) &&
+      memcmp(magic, kCacheMagic, sizeof(magic)) == 0) {
+    status = LoadBlocks(file, path, onChunk);
+  } else {
+    status = LoadArchive(file, path, onChunk);
+  }
+
+  if (status != B_OK)
+    Clear();
+  return status;
+}
+
+/**
+ * @brief Loads a version 4 cache, read into memory in one piece so that the
+ * blobs are decoded in place.
+ */
+status_t LibraryStore::LoadBlocks(BFile &file, const char *path,
+                                  const ChunkFunc &onChunk) {
+  std::unique_ptr<uint8[]> data;
+  size_t size = 0;
+  status_t status = ReadBlockFile(file, kCacheMagic, data, size);
+  if (status != B_OK)
+    return status;
+
+  CacheFileHeader header;
+  memcpy(&header, data.get(), sizeof(header));
+
+  CacheDecodeJob job;
+  std::vector<CacheBlock> quarantine;
+  const uint8 *next = data.get() + sizeof(header);
+  size_t left = size - sizeof(header);
+  while (left > 0) {
+    uint32 type;
+    CacheBlock block;
+    status = NextBlock(next, left, type, block);
+    if (status != B_OK)
+      return status;
+    // Blocks of other types are left for later versions
+    if (type == kBatchBlock)
+      job.blocks.push_back(std::move(block));
+    else if (type == kQuarantineBlock)
+      quarantine.push_back(std::move(block));
+  }
+
+  status = DecodeInto(job, DecodeThreadCount(job.blocks.size()), path,
+                      (int32)B_LENDIAN_TO_HOST_INT32(header.entries), onChunk,
+                      fEntries);
+  for (size_t i = 0; status == B_OK && i < quarantine.size(); i++)
+    status = ReadQuarantineBlock(quarantine[i], fQuarantine);
+  return status;
+}
+
+/**
+ * @brief Loads a version 1 cache, a flattened BMessage with one "entry"
+ * message per entry.
+ *
+ * Only readable where it was written, since Haiku and port/ flatten
+ * messages differently; elsewhere this fails and the next scan rebuilds
+ * the cache.
+ */
+status_t LibraryStore::LoadArchive(BFile &file, const char *path,
+                                   const ChunkFunc &onChunk) {
+  BMessage archive;
+  status_t status = archive.Unflatten(&file);
+  if (status != B_OK)
+    return status;
+
+  CacheDecodeJob job;
+  job.archive = &archive;
+  int32 count = 0;
+  archive.GetInfo("entry", nullptr, &count);
+  for (int32 first = 0; first < count; first += kEntryMessagesPerBlock) {
+    CacheBlock &block = job.blocks.emplace_back();
+    block.firstEntry = first;
+    block.entryCount = std::min(kEntryMessagesPerBlock, count - first);
+  }
+
+  return DecodeInto(job, DecodeThreadCount(job.blocks.size()), path, count,
+                    onChunk, fEntries);
+}
+
+status_t LibraryStore::Save(const char *path) const {
+  BFile file(path, B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  status = WriteFileHeader(file, kCacheMagic, (uint32)fEntries.size());
+
+  MediaBatchWriter writer;
+  writer.Reserve(kMediaBatchMaxItems);
+  std::vector<uint8> blob;
+  auto writeBlob = [&]() {
+    writer.Encode(blob);
+    writer.Clear();
+    status = WriteBlock(file, kBatchBlock, blob.data(), blob.size());
+  };
+  for (auto it = fEntries.begin(); status == B_OK && it != fEntries.end();
+       ++it) {
+    writer.Add(it->second);
+    if ((size_t)writer.CountItems() == kMediaBatchMaxItems)
+      writeBlob();
+  }
+  if (status == B_OK && writer.CountItems() > 0)
+    writeBlob();
+
+  if (status == B_OK && !fQuarantine.empty()) {
+    blob.clear();
+    for (const auto &[badPath, bad] : fQuarantine)
+      AddQuarantineRecord(blob, badPath, bad);
+    status = WriteBlock(file, kQuarantineBlock, blob.data(), blob.size());
+  }
+  return status;
+}
+
+/**
+ * @brief Appends the entries of @p paths as batch blocks, and their
+ * quarantine records as one quarantine block.
+ *
+ * The file is created with a header of its own when missing.
+ */
+status_t LibraryStore::AppendJournal(const char *path,
+                                     const std::vector<BString> &paths) const {
+  BFile file(path, B_WRITE_ONLY | B_CREATE_FILE | B_OPEN_AT_END);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  off_t size = 0;
+  status = file.GetSize(&size);
+  if (status == B_OK && size == 0)
+    status = WriteFileHeader(file, kJournalMagic, 0);
+
+  MediaBatchWriter writer;
+  std::vector<uint8> blob;
+  std::vector<uint8> quarantine;
+  auto writeBlob = [&]() {
+    writer.Encode(blob);
+    writer.Clear();
+    status = WriteBlock(file, kBatchBlock, blob.data(), blob.size());
+  };
+  for (size_t i = 0; status == B_OK && i < paths.size(); i++) {
+    auto entry = fEntries.find(paths[i]);
+    if (entry != fEntries.end()) {
+      writer.Add(entry->second);
+      if ((size_t)writer.CountItems() == kMediaBatchMaxItems)
+        writeBlob();
+    }
+
+    auto bad = fQuarantine.find(paths[i]);
+    if (bad != fQuarantine.end())
+      AddQuarantineRecord(quarantine, paths[i], bad->second);
+  }
+  if (status == B_OK && writer.CountItems() > 0)
+    writeBlob();
+  if (status == B_OK && !quarantine.empty()) {
+    status = WriteBlock(file, kQuarantineBlock, quarantine.data(),
+                        quarantine.size());
+  }
+  return status;
+}
+
+/**
+ * @brief Applies the blocks of a journal in the order they were appended.
+ *
+ * Stops at the first block that is cut short or fails its checksum, which
+ * is what an append interrupted by a crash leaves behind.
+ */
+status_t LibraryStore::ApplyJournal(const char *path) {
+  BFile file(path, B_READ_ONLY);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  std::unique_ptr<uint8[]> data;
+  size_t size = 0;
+  status = ReadBlockFile(file, kJournalMagic, data, size);
+  if (status != B_OK)
+    return status;
+
+  const uint8 *next = data.get() + sizeof(CacheFileHeader);
+  size_t left = size - sizeof(CacheFileHeader);
+  while (left > 0) {
+    uint32 type;
+    CacheBlock block;
+    status = NextBlock(next, left, type, block);
+    if (status != B_OK)
+      break;
+
+    if (type == kBatchBlock) {
+      if (BlockChecksum(block.data, block.size) != block.checksum ||
+          block.reader.SetTo(block.data, block.size) != B_OK) {
+        status = B_BAD_DATA;
+        break;
+      }
+      AddBatch(block.reader, nullptr);
+    } else if (type == kQuarantineBlock) {
+      // Records before a damaged one are kept, like the blocks before it
+      status = ReadQuarantineBlock(block, fQuarantine);
+      if (status != B_OK)
+        break;
+    }
+  }
+
+  if (status != B_OK) {
+    DEBUG_PRINT("[LibraryStore] Journal %s ends in a damaged block\n", path);
+  }
+  return status;
+}
+
+void LibraryStore::SetDecodeThreads(int32 count) {
+  fDecodeThreads = std::max(count, (int32)0);
+}
+
+int32 LibraryStore::DecodeThreadCount(size_t blocks) const {
+  int32 count = fDecodeThreads;
+  if (count == 0) {
+    system_info info;
+    count = get_system_info(&info) == B_OK ? (int32)info.cpu_count : 1;
+  }
+  return (int32)std::min((size_t)std::max(count, (int32)1), blocks);
+}
+
+void LibraryStore::Clear() {
+  fEntries.clear();
+  fQuarantine.clear();
+}
+
+const MediaItem *LibraryStore::Find(const BString &path) const {
+  auto it = fEntries.find(path);
+  return it == fEntries.end() ? nullptr : &it->second;
+}
+
+void LibraryStore::AddOrUpdate(MediaItem entry) {
+  // A file that parsed fine is no longer suspicious
+  fQuarantine.erase(entry.path);
+
+  auto it = fEntries.find(entry.path);
+  if (it == fEntries.end()) {
+    BString key = entry.path;
+    fEntries.emplace_hint(it, std::move(key), std::move(entry));
+    return;
+  }
+
+  if (!it->second.mbTrackId.IsEmpty() && entry.mbTrackId.IsEmpty()) {
+    DEBUG_PRINT("[LibraryStore] WARNING: Overwriting existing MB Track ID "
+                "for %s with empty value!\n",
+                entry.path.String());
+  }
+  it->second = std::move(entry);
+}
+
+/**
+ * @brief Decodes every item straight into its map node.
+ *
+ * Unlike AddOrUpdate() with a temporary MediaItem, an entry that already
+ * exists (a rescan) has its strings overwritten in place, which reuses their
+ * buffers instead of allocating new ones.
+ */
+int32 LibraryStore::AddBatch(const MediaBatchReader &batch, const char *base) {
+  const int32 count = batch.CountItems();
+  for (int32 i = 0; i < count; i++) {
+    const BString path(batch.PathAt(i));
+    // A file that parsed fine is no longer suspicious
+    fQuarantine.erase(path);
+
+    auto [it, added] = fEntries.try_emplace(path);
+    MediaItem &entry = it->second;
+    if (added)
+      entry.path = it->first;
+    if (!added && !entry.mbTrackId.IsEmpty() &&
+        batch.RecordAt(i).mbTrackId.length == 0) {
+      DEBUG_PRINT("[LibraryStore] WARNING: Overwriting existing MB Track ID "
+                  "for %s with empty value!\n",
+                  path.String());
+    }
+
+    batch.ItemAt(i, entry);
+    // Entries are grouped by scan root, not by their parent folder
+    if (base)
+      entry.base = base;
+  }
+  return count;
+}
+
+void LibraryStore::RemoveOtherBases(const std::set<BString> &bases) {
+  for (auto it = fEntries.begin(); it != fEntries.end();) {
+    if (bases.find(it->second.base) == bases.end())
+      it = fEntries.erase(it);
+    else
+      ++it;
+  }
+}
+
+void LibraryStore::MarkMissingBelow(const BString &prefix) {
+  for (auto &[path, entry] : fEntries) {
+    if (path.StartsWith(prefix))
+      entry.missing = true;
+  }
+}
+
+void LibraryStore::MarkMissingFiles(std::vector<BString> *outMissing) {
+  for (auto &[path, entry] : fEntries) {
+    if (entry.missing || BEntry(path.String()).Exists())
+      continue;
+    entry.missing = true;
+    if (outMissing)
+      outMissing->push_back(path);
+  }
+}
+
+std::vector<MediaItem> LibraryStore::AllEntries() const {
+  std::vector<MediaItem> out;
+  out.reserve(fEntries.size());
+  for (const auto &kv : fEntries)
+    out.push_back(kv.second);
+  return out;
+}
+
+void LibraryStore::AddToQuarantine(const BString &path,
+                                   const QuarantinedFile &file) {
+  fQuarantine[path] = file;
+}
+
+int32 LibraryStore::Compact() {
+  int32 removed = 0;
+  for (auto it = fEntries.begin(); it != fEntries.end();) {
+    if (it->second.missing) {
+      it = fEntries.erase(it);
+      removed++;
+    } else {
+      ++it;
+    }
+  }
+
+  for (auto it = fQuarantine.begin(); it != fQuarantine.end();) {
+    if (!BEntry(it->first.String()).Exists()) {
+      it = fQuarantine.erase(it);
+      removed++;
+    } else {
+      ++it;
+    }
+  }
+  return removed;
+}
+
+size_t LibraryStore::MemoryUsage() const {
+  size_t bytes = 0;
+  for (const auto &[path, entry] : fEntries) {
+    // Key copy and map node
+    bytes += entry.MemoryUsage() + path.Length() + 1 + 4 * sizeof(void *);
+  }
+  return bytes;
+}
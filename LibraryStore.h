@@ -0,0 +1,173 @@
+#ifndef LIBRARY_STORE_H
+#define LIBRARY_STORE_H
+
+#include "MediaItem.h"
+
+#include <String.h>
+#include <SupportDefs.h>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+
+class BFile;
+class MediaBatchReader;
+
+/**
+ * @class LibraryStore
+ * @brief All known media files and the quarantine, and the 'media.cache'
+ * format they are stored in.
+ *
+ * The data half of the CacheManager, without the looper, the scanners or
+ * any messaging, so that it is part of libbeton-core and can be used from
+ * tools and benchmarks on any platform. Not thread safe; the CacheManager
+ * only touches it from its own thread.
+ */
+class LibraryStore {
+public:
+  /**
+   * @brief Version of the layout written by Save().
+   *
+   * Version 1 is a flattened BMessage with one "entry" message per entry,
+   * which Haiku and port/ flatten differently. Version 4 is a file of its
+   * own: a header with the magic "BeTonLib", the version and the number of
+   * entries, then blocks of a type, a size and a checksum, each holding the
+   * quarantine records or a MediaBatch blob of up to kMediaBatchMaxItems
+   * entries, so loading reads the strings in place from a few large
+   * buffers. Every field is little-endian, so the same file is written and
+   * read on Haiku and Linux.
+   */
+  static constexpr int32 kVersion = 4;
+
+  /**
+   * @brief Called by Load() after each chunk of a version 4 cache.
+   * @param chunk The chunk's entries, as stored in the file.
+   * @param loaded Entries stored so far, this chunk included.
+   * @param total Entries in the file, or 0 if the cache does not say.
+   */
+  typedef std::function<void(const MediaBatchReader &chunk, int32 loaded,
+                             int32 total)>
+      ChunkFunc;
+
+  /**
+   * @brief Replaces the contents with those of a cache file.
+   *
+   * The file is split into blocks (the blobs, or runs of entry messages of
+   * a version 1 cache) that are verified and decoded on up to
+   * SetDecodeThreads() threads and merged in file order. Entries of a
+   * version 1 cache lack most of the tags and get their mtime cleared, so
+   * the next scan parses every file once more. On error the store is left
+   * empty, but @p onChunk may already have seen some of the entries.
+   * @param onChunk Called on the calling thread as the entries come in, in
+   * path order, so a caller can show them before all are loaded. A version
+   * 1 cache is loaded without calling it.
+   * @return B_OK, B_BAD_DATA for a cache with a damaged block or written
+   * with another MediaBatch layout, or the error from opening, reading or
+   * unflattening the file.
+   */
+  status_t Load(const char *path, const ChunkFunc &onChunk = nullptr);
+
+  /**
+   * @brief Sets how many threads Load() decodes on.
+   * @param count 0 (the default) for one per CPU, 1 to decode on the
+   * calling thread.
+   */
+  void SetDecodeThreads(int32 count);
+
+  /** @brief Writes all entries and the quarantine to @p path. */
+  status_t Save(const char *path) const;
+
+  /**
+   * @brief Appends the entries and quarantine records of @p paths to the
+   * journal at @p path.
+   *
+   * The journal uses the blocks of the version 4 format under a magic of
+   * its own, so that a checkpoint writes only what changed since the last
+   * one instead of the whole cache. Paths without an entry or a record are
+   * skipped.
+   */
+  status_t AppendJournal(const char *path,
+                         const std::vector<BString> &paths) const;
+
+  /**
+   * @brief Applies the journal at @p path on top of the loaded entries.
+   * @return B_OK, B_ENTRY_NOT_FOUND if there is no journal, or B_BAD_DATA
+   * if it ends in a damaged block; the blocks before that are applied.
+   */
+  status_t ApplyJournal(const char *path);
+
+  void Clear();
+
+  /** @name Entries */
+  ///@{
+  const std::map<BString, MediaItem> &Entries() const { return fEntries; }
+
+  /** @return The entry for @p path, or null. */
+  const MediaItem *Find(const BString &path) const;
+
+  /**
+   * @brief Stores @p entry, replacing any entry with the same path, and
+   * takes the file out of the quarantine.
+   *
+   * Pass an rvalue to move the item into the store instead of copying it.
+   */
+  void AddOrUpdate(MediaItem entry);
+
+  /**
+   * @brief Stores every item of a scanner batch.
+   * @param base Scan root the items are grouped under, or null to keep the
+   * base stored in the batch.
+   * @return Number of items stored.
+   */
+  int32 AddBatch(const MediaBatchReader &batch, const char *base);
+
+  /** @brief Removes the entries whose base is not one of @p bases. */
+  void RemoveOtherBases(const std::set<BString> &bases);
+
+  /** @brief Marks every entry below @p prefix as missing. */
+  void MarkMissingBelow(const BString &prefix);
+
+  /**
+   * @brief Marks entries whose file is gone as missing.
+   * @param outMissing Receives the paths newly marked, if not null.
+   */
+  void MarkMissingFiles(std::vector<BString> *outMissing = nullptr);
+
+  /** @brief Returns a copy of all entries, sorted by path. */
+  std::vector<MediaItem> AllEntries() const;
+  ///@}
+
+  /** @name Quarantine */
+  ///@{
+  const std::map<BString, QuarantinedFile> &Quarantine() const {
+    return fQuarantine;
+  }
+
+  void AddToQuarantine(const BString &path, const QuarantinedFile &file);
+  ///@}
+
+  /**
+   * @brief Drops entries marked missing and quarantine records of files that
+   * no longer exist.
+   * @return Number of removed entries and records.
+   */
+  int32 Compact();
+
+  /** @brief Approximate heap bytes held by the entries. */
+  size_t MemoryUsage() const;
+
+private:
+  status_t LoadBlocks(BFile &file, const char *path,
+                      const ChunkFunc &onChunk);
+  status_t LoadArchive(BFile &file, const char *path,
+                       const ChunkFunc &onChunk);
+
+  /** @brief Decode threads for @p blocks blocks, at most one per block. */
+  int32 DecodeThreadCount(size_t blocks) const;
+
+  std::map<BString, MediaItem> fEntries;
+  std::map<BString, QuarantinedFile> fQuarantine;
+  int32 fDecodeThreads = 0;
+};
+
+#endif // LIBRARY_STORE_H
@@ -1,48 +1,66 @@
-#include "Debug.h"
-#include "MainWindow.h"
-#include <Application.h>
-#include <Catalog.h>
-#include <cstring>
-
-#undef B_TRANSLATION_CONTEXT
-#define B_TRANSLATION_CONTEXT "Application"
-
-bool gIsDebug = false;
-
-/**
- * @class BeTonApp
- * @brief The Application class.
- *
- * Initializes the application and creates the main window.
- */
-class BeTonApp : public BApplication {
-public:
-  BeTonApp() : BApplication("application/x-vnd.BeTon") {}
-
-  void ReadyToRun() override {
-    MainWindow *window = new MainWindow();
-    window->Show();
-  }
-};
-
-int main(int argc, char **argv) {
-  for (int i = 1; i < argc; ++i) {
-    if (strcmp(argv[i], "--debug") == 0) {
-      gIsDebug = true;
-    }
-  }
-
-  if (!gIsDebug) {
-
-    freopen("/dev/null", "w", stdout);
-    freopen("/dev/null", "w", stderr);
-  }
-
-  if (gIsDebug) {
-    printf("[Main] Starting in DEBUG mode\n");
-  }
-
-  BeTonApp app;
-  app.Run();
-  return 0;
-}
+#include "Debug.h"
+#include "MainWindow.h"
+#include "TagParserSandbox.h"
+#include "Trace.h"
+#include <Application.h>
+#include <Catalog.h>
+#include <cstdlib>
+#include <cstring>
+
+#undef B_TRANSLATION_CONTEXT
+#define B_TRANSLATION_CONTEXT "Application"
+
+bool gIsDebug = false;
+
+/**
+ * @class BeTonApp
+ * @brief The Application class.
+ *
+ * Initializes the application and creates the main window.
+ */
+class BeTonApp : public BApplication {
+public:
+  BeTonApp() : BApplication("application/x-vnd.BeTon") {}
+
+  void ReadyToRun() override {
+    MainWindow *window = new MainWindow();
+    window->Show();
+  }
+};
+
+int main(int argc, char **argv) {
+  // Tag parser helper spawned by a MediaScanner, see TagParserSandbox
+  if (argc == 3 && strcmp(argv[1], TagParserSandbox::kHelperArgument) == 0)
+    return TagParserSandbox::RunHelper(atoi(argv[2]));
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--debug") == 0) {
+      gIsDebug = true;
+    }
+#ifdef BETON_TRACE
+    // Record from the start; the trace is written on quit
+    if (strcmp(argv[i], "--trace") == 0)
+      Trace::SetEnabled(true);
+#endif
+  }
+
+  if (!gIsDebug) {
+
+    freopen("/dev/null", "w", stdout);
+    freopen("/dev/null", "w", stderr);
+  }
+
+  if (gIsDebug) {
+    printf("[Main] Starting in DEBUG mode\n");
+  }
+
+  BeTonApp app;
+  app.Run();
+
+#ifdef BETON_TRACE
+  BString tracePath;
+  if (Trace::IsEnabled() && Trace::ExportToLogDirectory(&tracePath) == B_OK)
+    DEBUG_PRINT("[Main] Trace written to %s\n", tracePath.String());
+#endif
+  return 0;
+}
@@ -1,99 +1,236 @@
-#ifndef MATCHING_UTILS_H
-#define MATCHING_UTILS_H
-
-#include <String.h>
-#include <SupportDefs.h>
-#include <algorithm>
-#include <ctype.h>
-#include <vector>
-
-/**
- * @class MatchingUtils
- * @brief Static helper class for string similarity and metadata extraction.
- *
- * Provides utility functions for:
- * - Levenshtein distance calculation.
- * - String similarity scoring.
- * - Extracting track numbers from filenames.
- */
-class MatchingUtils {
-public:
-  /**
-   * @brief Calculates the Levenshtein distance between two strings.
-   *
-   * The distance is the minimum number of single-character edits (insertions,
-   * deletions or substitutions) required to change one string into the other.
-   * Case-insensitive.
-   *
-   * @param s1 First string.
-   * @param s2 Second string.
-   * @return The edit distance.
-   */
-  static int LevenshteinDistance(const char *s1, const char *s2) {
-    int len1 = strlen(s1);
-    int len2 = strlen(s2);
-    std::vector<std::vector<int>> d(len1 + 1, std::vector<int>(len2 + 1));
-
-    for (int i = 0; i <= len1; i++)
-      d[i][0] = i;
-    for (int j = 0; j <= len2; j++)
-      d[0][j] = j;
-
-    for (int i = 1; i <= len1; i++) {
-      for (int j = 1; j <= len2; j++) {
-        int cost = (tolower(s1[i - 1]) == tolower(s2[j - 1])) ? 0 : 1;
-        d[i][j] = std::min(
-            {d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + cost});
-      }
-    }
-    return d[len1][len2];
-  }
-
-  /**
-   * @brief Extracts the first sequence of digits from a filename as a track
-   * number.
-   *
-   * Useful for guessing track numbers when metadata is missing.
-   *
-   * @param filename The filename to parse.
-   * @return The extracted number, or 0 if none found.
-   */
-  static int ExtractTrackNumber(const char *filename) {
-    BString s(filename);
-    int32 len = s.Length();
-    int32 i = 0;
-
-    // Skip non-digits
-    while (i < len && !isdigit(s[i]))
-      i++;
-
-    if (i >= len)
-      return 0;
-
-    BString numStr;
-    while (i < len && isdigit(s[i])) {
-      numStr += s[i];
-      i++;
-    }
-    return atoi(numStr.String());
-  }
-
-  /**
-   * @brief Calculates a normalized similarity score between two strings.
-   *
-   * Based on Levenshtein distance.
-   *
-   * @param s1 First string.
-   * @param s2 Second string.
-   * @return Float between 0.0 (no match) and 1.0 (perfect match).
-   */
-  static float Similarity(const char *s1, const char *s2) {
-    int maxLen = std::max(strlen(s1), strlen(s2));
-    if (maxLen == 0)
-      return 1.0f;
-    int dist = LevenshteinDistance(s1, s2);
-    return 1.0f - (float)dist / maxLen;
-  }
-};
-
-#endif // MATCHING_UTILS_H
+#ifndef MATCHING_UTILS_H
+#define MATCHING_UTILS_H
+
+#include <String.h>
+#include <SupportDefs.h>
+#include <algorithm>
+#include <ctype.h>
+#include <cstring>
+#include <stdlib.h>
+#include <vector>
+
+/**
+ * @class MatchingUtils
+ * @brief Static helper class for string similarity and metadata extraction.
+ *
+ * Provides utility functions for:
+ * - Levenshtein distance calculation.
+ * - String similarity scoring.
+ * - Extracting track numbers from filenames.
+ * - Matching local files to the tracks of a release (MatcherWindow).
+ */
+class MatchingUtils {
+public:
+  /**
+   * @struct FileCandidate
+   * @brief What the matcher knows about a local file.
+   */
+  struct FileCandidate {
+    int durationSec = 0; ///< Length from the tags, 0 if unknown.
+    int trackNum = 0;    ///< Track number from the tags or the file name.
+    BString cleanName;   ///< See CleanFileName().
+  };
+
+  /**
+   * @struct TrackCandidate
+   * @brief A track of the release the files are matched to.
+   */
+  struct TrackCandidate {
+    int durationSec = 0; ///< Length, 0 if unknown.
+    int index = 0;       ///< Position on the release.
+    BString name;
+  };
+
+  /**
+   * @brief Calculates the Levenshtein distance between two strings.
+   *
+   * The distance is the minimum number of single-character edits (insertions,
+   * deletions or substitutions) required to change one string into the other.
+   * Case-insensitive.
+   *
+   * @param s1 First string.
+   * @param s2 Second string.
+   * @return The edit distance.
+   */
+  static int LevenshteinDistance(const char *s1, const char *s2) {
+    int len1 = strlen(s1);
+    int len2 = strlen(s2);
+    std::vector<std::vector<int>> d(len1 + 1, std::vector<int>(len2 + 1));
+
+    for (int i = 0; i <= len1; i++)
+      d[i][0] = i;
+    for (int j = 0; j <= len2; j++)
+      d[0][j] = j;
+
+    for (int i = 1; i <= len1; i++) {
+      for (int j = 1; j <= len2; j++) {
+        int cost = (tolower(s1[i - 1]) == tolower(s2[j - 1])) ? 0 : 1;
+        d[i][j] = std::min(
+            {d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + cost});
+      }
+    }
+    return d[len1][len2];
+  }
+
+  /**
+   * @brief Extracts the first sequence of digits from a filename as a track
+   * number.
+   *
+   * Useful for guessing track numbers when metadata is missing.
+   *
+   * @param filename The filename to parse.
+   * @return The extracted number, or 0 if none found.
+   */
+  static int ExtractTrackNumber(const char *filename) {
+    BString s(filename);
+    int32 len = s.Length();
+    int32 i = 0;
+
+    // Skip non-digits
+    while (i < len && !isdigit(s[i]))
+      i++;
+
+    if (i >= len)
+      return 0;
+
+    BString numStr;
+    while (i < len && isdigit(s[i])) {
+      numStr += s[i];
+      i++;
+    }
+    return atoi(numStr.String());
+  }
+
+  /**
+   * @brief Calculates a normalized similarity score between two strings.
+   *
+   * Based on Levenshtein distance.
+   *
+   * @param s1 First string.
+   * @param s2 Second string.
+   * @return Float between 0.0 (no match) and 1.0 (perfect match).
+   */
+  static float Similarity(const char *s1, const char *s2) {
+    int maxLen = std::max(strlen(s1), strlen(s2));
+    if (maxLen == 0)
+      return 1.0f;
+    int dist = LevenshteinDistance(s1, s2);
+    return 1.0f - (float)dist / maxLen;
+  }
+
+  /**
+   * @brief Strips the extension and any leading track number, spaces, dots,
+   * dashes and underscores from a file name.
+   */
+  static BString CleanFileName(const char *leaf) {
+    BString name(leaf);
+    int32 lastDot = name.FindLast('.');
+    if (lastDot > 0)
+      name.Truncate(lastDot);
+
+    const char *p = name.String();
+    while (*p &&
+           (isdigit(*p) || isspace(*p) || *p == '-' || *p == '.' || *p == '_'))
+      p++;
+    return BString(p);
+  }
+
+  /**
+   * @brief Weighted score of @p file being @p track.
+   *
+   * 1. Duration: +50 within 1 s, +30 within 3 s, -20 within 10 s, -50 beyond.
+   * 2. Track number: +40 if it equals the position on the release.
+   * 3. Name: +25 if the track name is contained in the file name, otherwise
+   * +20 above 80% and +10 above 50% similarity.
+   */
+  static int MatchScore(const FileCandidate &file,
+                        const TrackCandidate &track) {
+    int score = 0;
+
+    if (track.durationSec > 0 && file.durationSec > 0) {
+      int diff = std::abs(track.durationSec - file.durationSec);
+      if (diff <= 1)
+        score += 50;
+      else if (diff <= 3)
+        score += 30;
+      else if (diff <= 10)
+        score -= 20;
+      else
+        score -= 50;
+    }
+
+    if (file.trackNum > 0 && file.trackNum == track.index)
+      score += 40;
+
+    if (!file.cleanName.IsEmpty() && !track.name.IsEmpty()) {
+      if (file.cleanName.IFindFirst(track.name) >= 0) {
+        score += 25;
+      } else {
+        float sim = Similarity(file.cleanName.String(), track.name.String());
+        if (sim > 0.8f)
+          score += 20;
+        else if (sim > 0.5f)
+          score += 10;
+      }
+    }
+    return score;
+  }
+
+  /**
+   * @brief Assigns a track to every file.
+   *
+   * Pairs are taken greedily by descending MatchScore(), ignoring negative
+   * scores. Files left over get the remaining tracks in order.
+   *
+   * @return For every file the index into @p tracks, or -1 if there are more
+   * files than tracks.
+   */
+  static std::vector<int>
+  AssignTracks(const std::vector<FileCandidate> &files,
+               const std::vector<TrackCandidate> &tracks) {
+    struct Score {
+      int score;
+      size_t fileIdx;
+      size_t trackIdx;
+    };
+
+    std::vector<Score> allScores;
+    allScores.reserve(files.size() * tracks.size());
+    for (size_t i = 0; i < files.size(); i++) {
+      for (size_t k = 0; k < tracks.size(); k++)
+        allScores.push_back({MatchScore(files[i], tracks[k]), i, k});
+    }
+
+    std::sort(allScores.begin(), allScores.end(),
+              [](const Score &a, const Score &b) { return a.score > b.score; });
+
+    std::vector<int> assignments(files.size(), -1);
+    std::vector<bool> trackUsed(tracks.size(), false);
+
+    for (const auto &s : allScores) {
+      if (s.score < 0)
+        break;
+
+      if (assignments[s.fileIdx] < 0 && !trackUsed[s.trackIdx]) {
+        assignments[s.fileIdx] = (int)s.trackIdx;
+        trackUsed[s.trackIdx] = true;
+      }
+    }
+
+    // Fill gaps sequentially for unmatched files
+    size_t trackIdx = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+      if (assignments[i] >= 0)
+        continue;
+      while (trackIdx < tracks.size() && trackUsed[trackIdx])
+        trackIdx++;
+      if (trackIdx < tracks.size()) {
+        assignments[i] = (int)trackIdx;
+        trackUsed[trackIdx] = true;
+      }
+    }
+    return assignments;
+  }
+};
+
+#endif // MATCHING_UTILS_H
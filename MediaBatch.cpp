@@ -0,0 +1,306 @@
+#include "MediaBatch.h"
+
+#include <ByteOrder.h>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * @name Byte Order
+ * Convert between host and little-endian order; the same operation serves
+ * both directions, and is a no-op on little-endian hosts.
+ */
+///@{
+static void SwapLittleEndian(MediaBatchHeader &h) {
+  h.magic = B_HOST_TO_LENDIAN_INT32(h.magic);
+  h.version = B_HOST_TO_LENDIAN_INT16(h.version);
+  h.recordSize = B_HOST_TO_LENDIAN_INT16(h.recordSize);
+  h.count = B_HOST_TO_LENDIAN_INT32(h.count);
+  h.arenaSize = B_HOST_TO_LENDIAN_INT32(h.arenaSize);
+}
+
+static void SwapLittleEndian(MediaBatchString &s) {
+  s.offset = B_HOST_TO_LENDIAN_INT32(s.offset);
+  s.length = B_HOST_TO_LENDIAN_INT32(s.length);
+}
+
+static void SwapLittleEndian(MediaBatchRecord &r) {
+  for (MediaBatchString *s : {&r.path, &r.base, &r.title, &r.artist,
+                              &r.album, &r.albumArtist, &r.composer,
+                              &r.genre, &r.comment, &r.mbTrackId,
+                              &r.mbAlbumId, &r.mbArtistId})
+    SwapLittleEndian(*s);
+  for (int32 *n : {&r.year, &r.track, &r.trackTotal, &r.disc, &r.discTotal,
+                   &r.duration, &r.bitrate, &r.sampleRate, &r.channels,
+                   &r.flags})
+    *n = (int32)B_HOST_TO_LENDIAN_INT32(*n);
+  for (int64 *n : {&r.size, &r.mtime, &r.inode})
+    *n = (int64)B_HOST_TO_LENDIAN_INT64(*n);
+}
+///@}
+
+/**
+ * @brief Reserves record and arena capacity up front.
+ */
+void MediaBatchWriter::Reserve(size_t count, size_t arenaBytes) {
+  fRecords.reserve(count);
+  fArena.reserve(arenaBytes > 0 ? arenaBytes : count * 256);
+}
+
+/**
+ * @brief Copies a string into the arena and returns its reference.
+ *
+ * Strings are always NUL-terminated in the arena so readers can use them in
+ * place as C strings.
+ */
+MediaBatchString MediaBatchWriter::_AddString(const BString &s) {
+  MediaBatchString ref;
+  ref.offset = (uint32)fArena.size();
+  ref.length = (uint32)s.Length();
+  fArena.insert(fArena.end(), s.String(), s.String() + s.Length());
+  fArena.push_back('\0');
+  return ref;
+}
+
+/**
+ * @brief Appends one MediaItem as a record plus its strings.
+ */
+void MediaBatchWriter::Add(const MediaItem &item) {
+  MediaBatchRecord r{};
+  r.path = _AddString(item.path);
+  r.base = _AddString(item.base);
+  r.title = _AddString(item.title);
+  r.artist = _AddString(item.artist);
+  r.album = _AddString(item.album);
+  r.albumArtist = _AddString(item.albumArtist);
+  r.composer = _AddString(item.composer);
+  r.genre = _AddString(item.genre);
+  r.comment = _AddString(item.comment);
+  r.mbTrackId = _AddString(item.mbTrackId);
+  r.mbAlbumId = _AddString(item.mbAlbumId);
+  r.mbArtistId = _AddString(item.mbArtistId);
+
+  r.year = item.year;
+  r.track = item.track;
+  r.trackTotal = item.trackTotal;
+  r.disc = item.disc;
+  r.discTotal = item.discTotal;
+  r.duration = item.duration;
+  r.bitrate = item.bitrate;
+  r.sampleRate = item.sampleRate;
+  r.channels = item.channels;
+  r.flags = item.missing ? kMediaBatchMissing : 0;
+  r.size = item.size;
+  r.mtime = item.mtime;
+  r.inode = item.inode;
+
+  fRecords.push_back(r);
+}
+
+size_t MediaBatchWriter::EncodedSize() const {
+  return sizeof(MediaBatchHeader) +
+         fRecords.size() * sizeof(MediaBatchRecord) + fArena.size();
+}
+
+size_t MediaBatchWriter::EncodedSizeOf(const MediaItem &item) {
+  // One NUL terminator per string field
+  return sizeof(MediaBatchRecord) + 12 + item.path.Length() +
+         item.base.Length() + item.title.Length() + item.artist.Length() +
+         item.album.Length() + item.albumArtist.Length() +
+         item.composer.Length() + item.genre.Length() +
+         item.comment.Length() + item.mbTrackId.Length() +
+         item.mbAlbumId.Length() + item.mbArtistId.Length();
+}
+
+void MediaBatchWriter::Clear() {
+  fRecords.clear();
+  fArena.clear();
+}
+
+/**
+ * @brief Joins header, records and arena into one blob.
+ */
+void MediaBatchWriter::Encode(std::vector<uint8> &blob) const {
+  MediaBatchHeader header;
+  header.magic = kMediaBatchMagic;
+  header.version = kMediaBatchVersion;
+  header.recordSize = (uint16)sizeof(MediaBatchRecord);
+  header.count = (uint32)fRecords.size();
+  header.arenaSize = (uint32)fArena.size();
+  SwapLittleEndian(header);
+
+  blob.resize(EncodedSize());
+  uint8 *p = blob.data();
+  memcpy(p, &header, sizeof(header));
+  p += sizeof(header);
+#if B_HOST_IS_BENDIAN
+  for (MediaBatchRecord r : fRecords) {
+    SwapLittleEndian(r);
+    memcpy(p, &r, sizeof(r));
+    p += sizeof(r);
+  }
+#else
+  if (!fRecords.empty()) {
+    memcpy(p, fRecords.data(), fRecords.size() * sizeof(MediaBatchRecord));
+    p += fRecords.size() * sizeof(MediaBatchRecord);
+  }
+#endif
+  if (!fArena.empty())
+    memcpy(p, fArena.data(), fArena.size());
+}
+
+status_t MediaBatchWriter::AddToMessage(BMessage &msg) const {
+  std::vector<uint8> blob;
+  Encode(blob);
+  return msg.AddData(kMediaBatchField, B_RAW_TYPE, blob.data(),
+                     (ssize_t)blob.size(), false);
+}
+
+status_t MediaBatchReader::SetTo(const BMessage *msg) {
+  fData = nullptr;
+  fSize = 0;
+  fRecords = nullptr;
+  fArena = nullptr;
+  fCount = 0;
+
+  if (!msg)
+    return B_BAD_VALUE;
+
+  const void *data = nullptr;
+  ssize_t size = 0;
+  if (msg->FindData(kMediaBatchField, B_RAW_TYPE, &data, &size) != B_OK)
+    return B_NAME_NOT_FOUND;
+
+  return SetTo(data, (size_t)size);
+}
+
+/**
+ * @brief Validates the header and sets up pointers into @p data.
+ *
+ * All record string references are bounds-checked once here so the per-item
+ * accessors can stay branch-free.
+ */
+status_t MediaBatchReader::SetTo(const void *data, size_t size) {
+  fData = nullptr;
+  fSize = 0;
+  fRecords = nullptr;
+  fArena = nullptr;
+  fCount = 0;
+
+  if (!data || size < sizeof(MediaBatchHeader))
+    return B_BAD_DATA;
+
+  MediaBatchHeader header;
+  memcpy(&header, data, sizeof(header));
+  SwapLittleEndian(header);
+  if (header.magic != kMediaBatchMagic ||
+      header.version != kMediaBatchVersion ||
+      header.recordSize != sizeof(MediaBatchRecord))
+    return B_BAD_DATA;
+
+  const size_t recordBytes = (size_t)header.count * sizeof(MediaBatchRecord);
+  if (size < sizeof(header) + recordBytes + header.arenaSize)
+    return B_BAD_DATA;
+
+  const uint8 *base = static_cast<const uint8 *>(data);
+  const uint8 *records = base + sizeof(header);
+  const char *arena = reinterpret_cast<const char *>(records + recordBytes);
+
+  if (header.arenaSize == 0 && header.count > 0)
+    return B_BAD_DATA;
+  if (header.arenaSize > 0 && arena[header.arenaSize - 1] != '\0')
+    return B_BAD_DATA;
+
+  static const size_t kStringFields[] = {
+      offsetof(MediaBatchRecord, path),
+      offsetof(MediaBatchRecord, base),
+      offsetof(MediaBatchRecord, title),
+      offsetof(MediaBatchRecord, artist),
+      offsetof(MediaBatchRecord, album),
+      offsetof(MediaBatchRecord, albumArtist),
+      offsetof(MediaBatchRecord, composer),
+      offsetof(MediaBatchRecord, genre),
+      offsetof(MediaBatchRecord, comment),
+      offsetof(MediaBatchRecord, mbTrackId),
+      offsetof(MediaBatchRecord, mbAlbumId),
+      offsetof(MediaBatchRecord, mbArtistId)};
+
+  for (uint32 i = 0; i < header.count; i++) {
+    const uint8 *rec = records + (size_t)i * sizeof(MediaBatchRecord);
+    for (size_t field : kStringFields) {
+      MediaBatchString ref;
+      memcpy(&ref, rec + field, sizeof(ref));
+      SwapLittleEndian(ref);
+      if ((uint64)ref.offset + ref.length >= header.arenaSize ||
+          arena[ref.offset + ref.length] != '\0')
+        return B_BAD_DATA;
+    }
+  }
+
+  fData = data;
+  fSize = sizeof(header) + recordBytes + header.arenaSize;
+  fRecords = records;
+  fArena = arena;
+  fCount = (int32)header.count;
+  return B_OK;
+}
+
+MediaBatchRecord MediaBatchReader::RecordAt(int32 index) const {
+  MediaBatchRecord r;
+  memcpy(&r, fRecords + (size_t)index * sizeof(MediaBatchRecord), sizeof(r));
+  SwapLittleEndian(r);
+  return r;
+}
+
+const char *MediaBatchReader::PathAt(int32 index) const {
+  MediaBatchString ref;
+  memcpy(&ref,
+         fRecords + (size_t)index * sizeof(MediaBatchRecord) +
+             offsetof(MediaBatchRecord, path),
+         sizeof(ref));
+  SwapLittleEndian(ref);
+  return StringAt(ref);
+}
+
+/**
+ * @brief Materializes item @p index as a MediaItem.
+ *
+ * Uses the stored lengths so no strlen() is needed per field. The path is
+ * left alone if @p out already has it, so an entry decoded into the map node
+ * for its path keeps sharing the key's buffer.
+ */
+void MediaBatchReader::ItemAt(int32 index, MediaItem &out) const {
+  const MediaBatchRecord r = RecordAt(index);
+
+  auto assign = [&](BString &target, const MediaBatchString &ref) {
+    target.SetTo(StringAt(ref), (int32)ref.length);
+  };
+
+  if (out.path.Length() != (int32)r.path.length ||
+      memcmp(out.path.String(), StringAt(r.path), r.path.length) != 0)
+    assign(out.path, r.path);
+  assign(out.base, r.base);
+  assign(out.title, r.title);
+  assign(out.artist, r.artist);
+  assign(out.album, r.album);
+  assign(out.albumArtist, r.albumArtist);
+  assign(out.composer, r.composer);
+  assign(out.genre, r.genre);
+  assign(out.comment, r.comment);
+  assign(out.mbTrackId, r.mbTrackId);
+  assign(out.mbAlbumId, r.mbAlbumId);
+  assign(out.mbArtistId, r.mbArtistId);
+
+  out.year = r.year;
+  out.track = r.track;
+  out.trackTotal = r.trackTotal;
+  out.disc = r.disc;
+  out.discTotal = r.discTotal;
+  out.duration = r.duration;
+  out.bitrate = r.bitrate;
+  out.sampleRate = r.sampleRate;
+  out.channels = r.channels;
+  out.size = r.size;
+  out.mtime = r.mtime;
+  out.inode = r.inode;
+  out.missing = (r.flags & kMediaBatchMissing) != 0;
+}
@@ -0,0 +1,239 @@
+#ifndef MEDIA_BATCH_H
+#define MEDIA_BATCH_H
+
+#include "MediaItem.h"
+
+#include <Message.h>
+#include <String.h>
+#include <SupportDefs.h>
+#include <vector>
+
+/**
+ * @file MediaBatch.h
+ * @brief Compact binary encoding for MSG_MEDIA_BATCH payloads.
+ *
+ * A batch is a single contiguous blob stored in the "batch" field of the
+ * message:
+ *
+ *     [MediaBatchHeader][MediaBatchRecord x count][string arena]
+ *
+ * Records are fixed-width. Every string field is an offset/length pair into
+ * the arena, and every string in the arena is NUL-terminated, so consumers can
+ * hand out `const char *` pointers straight from the message buffer without
+ * copying anything.
+ *
+ * Numbers are little-endian on every host: the writer converts them when
+ * encoding and the reader when it copies a header, record or string
+ * reference out. With the record layout pinned below, a blob (and the cache
+ * file made of them) reads the same on any platform.
+ */
+
+/** @brief Name of the BMessage field that carries the encoded batch. */
+static constexpr const char *kMediaBatchField = "batch";
+
+/** @brief Magic value at the start of every encoded batch ('MBAT'). */
+static constexpr uint32 kMediaBatchMagic = 'MBAT';
+
+/**
+ * @brief Layout version, bumped whenever MediaBatchRecord changes.
+ *
+ * The cache file stores its entries as batches too (see LibraryStore), so a
+ * bump also makes existing caches unreadable and costs one full scan.
+ */
+static constexpr uint16 kMediaBatchVersion = 3;
+
+/** @brief MediaBatchRecord::flags bit for MediaItem::missing. */
+static constexpr int32 kMediaBatchMissing = 0x1;
+
+/** @name Batch Size Limits
+ * A scanner sends its batch once either limit is reached.
+ */
+///@{
+static constexpr size_t kMediaBatchMaxItems = 1000;
+static constexpr size_t kMediaBatchMaxBytes = 512 * 1024;
+///@}
+
+/**
+ * @struct MediaBatchString
+ * @brief Reference to a NUL-terminated string inside the batch arena.
+ */
+struct MediaBatchString {
+  uint32 offset; ///< Byte offset from the start of the arena.
+  uint32 length; ///< Length in bytes, excluding the terminating NUL.
+};
+
+/**
+ * @struct MediaBatchHeader
+ * @brief Fixed header at the start of an encoded batch.
+ */
+struct MediaBatchHeader {
+  uint32 magic;      ///< Always kMediaBatchMagic.
+  uint16 version;    ///< Always kMediaBatchVersion.
+  uint16 recordSize; ///< sizeof(MediaBatchRecord) of the writer.
+  uint32 count;      ///< Number of records following the header.
+  uint32 arenaSize;  ///< Size of the string arena in bytes.
+};
+
+/**
+ * @struct MediaBatchRecord
+ * @brief Fixed-width per-item record. Strings live in the arena.
+ */
+struct MediaBatchRecord {
+  /** @name Strings */
+  ///@{
+  MediaBatchString path;
+  MediaBatchString base;
+  MediaBatchString title;
+  MediaBatchString artist;
+  MediaBatchString album;
+  MediaBatchString albumArtist;
+  MediaBatchString composer;
+  MediaBatchString genre;
+  MediaBatchString comment;
+  MediaBatchString mbTrackId;
+  MediaBatchString mbAlbumId;
+  MediaBatchString mbArtistId;
+  ///@}
+
+  /** @name Numbers */
+  ///@{
+  int32 year;
+  int32 track;
+  int32 trackTotal;
+  int32 disc;
+  int32 discTotal;
+  int32 duration;
+  int32 bitrate;
+  int32 sampleRate;
+  int32 channels;
+  int32 flags; ///< kMediaBatchMissing.
+  int64 size;
+  int64 mtime;
+  int64 inode;
+  ///@}
+};
+
+static_assert(sizeof(MediaBatchHeader) == 16 &&
+                  sizeof(MediaBatchRecord) == 160,
+              "the batch layout is part of the cache file format");
+
+/**
+ * @class MediaBatchWriter
+ * @brief Serializes MediaItems into a single binary batch blob.
+ *
+ * Records and arena are accumulated in two growing buffers and only joined
+ * once, when the batch is attached to a message.
+ */
+class MediaBatchWriter {
+public:
+  MediaBatchWriter() = default;
+
+  /**
+   * @brief Pre-allocates space for a known number of items.
+   * @param count Expected number of items.
+   * @param arenaBytes Expected total string payload in bytes.
+   */
+  void Reserve(size_t count, size_t arenaBytes = 0);
+
+  /** @brief Appends one item to the batch. */
+  void Add(const MediaItem &item);
+
+  /** @brief Number of items written so far. */
+  int32 CountItems() const { return (int32)fRecords.size(); }
+
+  /** @brief Size in bytes the encoded blob will have. */
+  size_t EncodedSize() const;
+
+  /**
+   * @brief Number of bytes @p item will add to an encoded batch.
+   *
+   * Lets producers enforce a byte budget without encoding anything.
+   */
+  static size_t EncodedSizeOf(const MediaItem &item);
+
+  /** @brief Drops all items so the writer can be reused. */
+  void Clear();
+
+  /** @brief Encodes the batch into @p blob, replacing its contents. */
+  void Encode(std::vector<uint8> &blob) const;
+
+  /**
+   * @brief Encodes the batch and stores it in @p msg under kMediaBatchField.
+   * @return B_OK on success, or the error from BMessage::AddData().
+   */
+  status_t AddToMessage(BMessage &msg) const;
+
+private:
+  MediaBatchString _AddString(const BString &s);
+
+  std::vector<MediaBatchRecord> fRecords;
+  std::vector<char> fArena;
+};
+
+/**
+ * @class MediaBatchReader
+ * @brief Read-only view onto an encoded batch.
+ *
+ * The reader never copies the blob. Strings are returned as pointers into the
+ * original buffer, which must outlive the reader (usually the BMessage the
+ * batch came in).
+ */
+class MediaBatchReader {
+public:
+  MediaBatchReader() = default;
+
+  /**
+   * @brief Attaches the reader to the batch stored in @p msg.
+   * @return B_OK, B_NAME_NOT_FOUND if the message carries no batch, or
+   * B_BAD_DATA if the blob is malformed.
+   */
+  status_t SetTo(const BMessage *msg);
+
+  /**
+   * @brief Attaches the reader to a raw batch buffer.
+   * @return B_OK or B_BAD_DATA if the blob is malformed.
+   */
+  status_t SetTo(const void *data, size_t size);
+
+  int32 CountItems() const { return fCount; }
+
+  /** @name Encoded Blob
+   * The batch as attached, e.g. to forward it in another message.
+   */
+  ///@{
+  const void *Data() const { return fData; }
+  size_t Size() const { return fSize; }
+  ///@}
+
+  /**
+   * @brief Copies the fixed-width record at @p index, in host byte order.
+   *
+   * Records are copied out rather than referenced because the message buffer
+   * makes no alignment guarantees for the 64-bit fields.
+   */
+  MediaBatchRecord RecordAt(int32 index) const;
+
+  /** @brief Resolves a string reference to a pointer into the arena. */
+  const char *StringAt(const MediaBatchString &ref) const {
+    return fArena + ref.offset;
+  }
+
+  /** @brief Convenience accessor for the path of item @p index. */
+  const char *PathAt(int32 index) const;
+
+  /**
+   * @brief Decodes item @p index into a MediaItem.
+   *
+   * Overwrites every field of @p out, so it may be an existing entry.
+   */
+  void ItemAt(int32 index, MediaItem &out) const;
+
+private:
+  const void *fData = nullptr;
+  size_t fSize = 0;
+  const uint8 *fRecords = nullptr;
+  const char *fArena = nullptr;
+  int32 fCount = 0;
+};
+
+#endif // MEDIA_BATCH_H
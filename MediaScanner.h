@@ -1,99 +1,113 @@
-#ifndef MEDIA_SCANNER_H
-#define MEDIA_SCANNER_H
-
-#include "MediaItem.h"
-
-#include <Directory.h>
-#include <Entry.h>
-#include <File.h>
-#include <Locker.h>
-#include <Looper.h>
-#include <Message.h>
-#include <Messenger.h>
-#include <OS.h>
-#include <String.h>
-#include <atomic>
-#include <chrono>
-#include <map>
-#include <vector>
-
-/**
- * @class MediaScanner
- * @brief Background worker for recursive directory scanning and metadata
- * extraction.
- *
- * Runs in its own thread (via BLooper and a separate worker thread).
- * Scans a directory tree, identifies audio files, extracts metadata using
- * TagLib, and sends batches of `MediaItem`s to the `CacheManager` for storage.
- *
- * Supports incremental scanning by checking file modification times against
- * a provided cache map.
- */
-class MediaScanner : public BLooper {
-public:
-  /**
-   * @brief Constructs the scanner.
-   * @param startDir Root directory to scan.
-   * @param cacheTarget Messenger to receive batched MediaItems
-   * (MSG_MEDIA_BATCH).
-   * @param liveTarget Messenger to receive progress updates
-   * (MSG_SCAN_PROGRESS).
-   */
-  MediaScanner(const entry_ref &startDir, BMessenger cacheTarget,
-               BMessenger liveTarget);
-  virtual ~MediaScanner();
-
-  void MessageReceived(BMessage *msg) override;
-
-  /**
-   * @brief Pre-loads the cache to enable incremental scanning.
-   * @param cache Map of existing file paths to MediaItems.
-   */
-  void SetCache(const std::map<BString, MediaItem> &cache) { fCache = cache; }
-
-private:
-  void ProcessFile(BEntry &entry);
-  void FlushBatch();
-  void ReportProgress();
-
-  static status_t WorkerEntry(void *data);
-  void WorkerMethod();
-
-  /** @name Configuration & Messaging */
-  ///@{
-  entry_ref fStartRef;
-  BMessenger fCacheTarget;
-  BMessenger fLiveTarget;
-  BString fBasePath;
-  ///@}
-
-  /** @name Data */
-  ///@{
-  std::map<BString, MediaItem> fCache;
-  std::vector<MediaItem> fBatchBuffer;
-  BLocker fBatchLock;
-  ///@}
-
-  /** @name Threading */
-  ///@{
-  thread_id fWorkerThread;
-  sem_id fControlSem;
-  ///@}
-
-  /** @name State Flags */
-  ///@{
-  bool fScanRequested;
-  std::atomic<bool> fStopRequested;
-  std::atomic<bool> fIsScanning;
-  ///@}
-
-  /** @name Progress Tracking */
-  ///@{
-  std::atomic<int> fScannedDirs;
-  std::atomic<int> fFoundFiles;
-  std::chrono::steady_clock::time_point fLastUpdate;
-  std::chrono::steady_clock::time_point fStartTime;
-  ///@}
-};
-
-#endif // MEDIA_SCANNER_H
+#ifndef MEDIA_SCANNER_H
+#define MEDIA_SCANNER_H
+
+#include "MediaItem.h"
+#include "ScanEngine.h"
+#include "ScanFilter.h"
+
+#include <Entry.h>
+#include <Looper.h>
+#include <Message.h>
+#include <Messenger.h>
+#include <OS.h>
+#include <String.h>
+#include <atomic>
+#include <map>
+#include <memory>
+
+class ScanIOGovernor;
+
+/**
+ * @class MediaScanner
+ * @brief Background worker for recursive directory scanning and metadata
+ * extraction.
+ *
+ * Runs a ScanEngine on its own worker thread next to the BLooper and sends
+ * what it finds to the `CacheManager` (batches of `MediaItem`s, failed
+ * files, checkpoints) and to the UI (progress and the final report). The
+ * traversal, parsing, batching and checkpointing themselves are the
+ * engine's; see ScanEngine for how they work. Here, tags are read with
+ * TagSync::ReadAll(), and helper processes are TagParserSandboxes.
+ *
+ * Batches count towards the queue shared via SetBatchQueueCounter(), so the
+ * engine blocks while the CacheManager falls behind.
+ */
+class MediaScanner : public BLooper {
+public:
+  /**
+   * @brief Constructs the scanner.
+   * @param startDir Root directory to scan.
+   * @param cacheTarget Messenger to receive batched MediaItems
+   * (MSG_MEDIA_BATCH).
+   * @param liveTarget Messenger to receive progress updates
+   * (MSG_SCAN_PROGRESS).
+   */
+  MediaScanner(const entry_ref &startDir, BMessenger cacheTarget,
+               BMessenger liveTarget);
+  virtual ~MediaScanner();
+
+  void MessageReceived(BMessage *msg) override;
+
+  /** @name Scan Settings
+   * Forwarded to the ScanEngine; must be set before MSG_START_SCAN.
+   */
+  ///@{
+  void SetCache(const std::map<BString, MediaItem> &cache) {
+    fEngine->SetCache(cache);
+  }
+
+  void SetBatchQueueCounter(std::shared_ptr<std::atomic<int32>> counter) {
+    fEngine->SetBatchQueueCounter(counter);
+  }
+
+  void SetResumeState(const BMessage &checkpoint) {
+    fEngine->SetResumeState(checkpoint);
+  }
+
+  void SetFollowLinks(bool follow) { fEngine->SetFollowLinks(follow); }
+
+  void SetFilter(const ScanFilter &filter) { fEngine->SetFilter(filter); }
+
+  /**
+   * @brief Parses tags in @p count helper processes (see TagParserSandbox).
+   *
+   * 0 (the default) parses in-process, which is also the fallback if no
+   * helper can be started.
+   */
+  void SetParserHelpers(int32 count);
+
+  void SetQuarantine(const std::map<BString, QuarantinedFile> &files) {
+    fEngine->SetQuarantine(files);
+  }
+
+  void SetIOGovernor(std::shared_ptr<ScanIOGovernor> governor) {
+    fEngine->SetIOGovernor(governor);
+  }
+  ///@}
+
+private:
+  static status_t WorkerEntry(void *data);
+  void WorkerMethod();
+
+  /** @name Configuration & Messaging */
+  ///@{
+  BMessenger fCacheTarget;
+  BMessenger fLiveTarget;
+  std::unique_ptr<ScanEngine> fEngine;
+  ///@}
+
+  /** @name Threading */
+  ///@{
+  thread_id fWorkerThread;
+  sem_id fControlSem;
+  ///@}
+
+  /** @name State Flags */
+  ///@{
+  bool fScanRequested;
+  std::atomic<bool> fStopRequested;
+  std::atomic<bool> fIsScanning;
+  ///@}
+};
+
+#endif // MEDIA_SCANNER_H
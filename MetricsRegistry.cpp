@@ -0,0 +1,191 @@
+#include "MetricsRegistry.h"
+#include "MediaItem.h"
+
+#include <Autolock.h>
+#include <File.h>
+#include <FindDirectory.h>
+#include <Path.h>
+
+#include <time.h>
+
+void MetricHistogram::Record(int64 value) {
+  if (value < 0)
+    value = 0;
+
+  int32 bucket = 0;
+  while (bucket < kBuckets - 1 && (value >> bucket) != 0)
+    bucket++;
+  fBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  fCount.fetch_add(1, std::memory_order_relaxed);
+  fSum.fetch_add(value, std::memory_order_relaxed);
+
+  int64 max = fMax.load(std::memory_order_relaxed);
+  while (value > max &&
+         !fMax.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+}
+
+int64 MetricHistogram::Percentile(double fraction) const {
+  const int64 count = Count();
+  if (count == 0)
+    return 0;
+
+  const int64 rank = (int64)(fraction * count + 0.5);
+  int64 seen = 0;
+  for (int32 bucket = 0; bucket < kBuckets; bucket++) {
+    seen += fBuckets[bucket].load(std::memory_order_relaxed);
+    if (seen >= rank && seen > 0) {
+      const int64 limit = bucket == 0 ? 0 : (1LL << bucket) - 1;
+      return limit < Max() ? limit : Max();
+    }
+  }
+  return Max();
+}
+
+MetricsRegistry::MetricsRegistry()
+    : fLock("metrics registry"), fStart(system_time()) {}
+
+MetricsRegistry &MetricsRegistry::Default() {
+  static MetricsRegistry sRegistry;
+  return sRegistry;
+}
+
+MetricsRegistry::Entry &MetricsRegistry::_Find(const char *name, Kind kind,
+                                               const char *unit) {
+  BAutolock lock(fLock);
+  auto it = fMetrics.find(name);
+  if (it != fMetrics.end())
+    return it->second;
+
+  Entry &entry = fMetrics[name];
+  entry.kind = kind;
+  entry.unit = unit;
+  switch (kind) {
+  case kCounter:
+    entry.counter.reset(new MetricCounter);
+    break;
+  case kGauge:
+    entry.gauge.reset(new MetricGauge);
+    break;
+  case kHistogram:
+    entry.histogram.reset(new MetricHistogram);
+    break;
+  }
+  return entry;
+}
+
+MetricCounter *MetricsRegistry::Counter(const char *name, const char *unit) {
+  return _Find(name, kCounter, unit).counter.get();
+}
+
+MetricGauge *MetricsRegistry::Gauge(const char *name, const char *unit) {
+  return _Find(name, kGauge, unit).gauge.get();
+}
+
+MetricHistogram *MetricsRegistry::Histogram(const char *name,
+                                            const char *unit) {
+  return _Find(name, kHistogram, unit).histogram.get();
+}
+
+void MetricsRegistry::SampleProcess() {
+  int64 resident = 0;
+  int32 areas = 0;
+  ssize_t cookie = 0;
+  area_info info;
+  while (get_next_area_info(B_CURRENT_TEAM, &cookie, &info) == B_OK) {
+    resident += info.ram_size;
+    areas++;
+  }
+
+  Gauge("memory.resident", "MB")->Set(resident / (1024.0 * 1024.0));
+  Gauge("memory.areas", "areas")->Set(areas);
+#ifdef BETON_COPY_COUNT
+  Gauge("library.item_copies", "copies")->Set(MediaItem::Copies());
+#endif
+}
+
+BString MetricsRegistry::Describe() {
+  SampleProcess();
+
+  char stamp[32];
+  time_t now = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+  BString report;
+  report.SetToFormat("BeTon metrics, %s, up %.0f s\n", stamp,
+                     (system_time() - fStart) / 1000000.0);
+
+  BAutolock lock(fLock);
+  BString line;
+  BString group;
+  for (const auto &[name, entry] : fMetrics) {
+    // Blank line between prefixes
+    BString prefix;
+    int32 dot = name.FindFirst('.');
+    name.CopyInto(prefix, 0, dot < 0 ? name.Length() : dot);
+    if (prefix != group) {
+      report << "\n";
+      group = prefix;
+    }
+
+    switch (entry.kind) {
+    case kCounter:
+      line.SetToFormat("%-28s %12lld %s\n", name.String(),
+                       (long long)entry.counter->Value(), entry.unit.String());
+      break;
+    case kGauge: {
+      const double value = entry.gauge->Value();
+      line.SetToFormat("%-28s %12.*f %s\n", name.String(),
+                       value == (int64)value ? 0 : 1, value,
+                       entry.unit.String());
+      break;
+    }
+    case kHistogram: {
+      const MetricHistogram &h = *entry.histogram;
+      const bool micros = entry.unit == "us";
+      const double scale = micros ? 1000.0 : 1.0;
+      const char *unit = micros ? "ms" : entry.unit.String();
+      const int64 count = h.Count();
+      line.SetToFormat("%-28s %12lld x, mean %.1f, p50 <=%.1f, p95 <=%.1f, "
+                       "max %.1f %s\n",
+                       name.String(), (long long)count,
+                       count > 0 ? h.Sum() / scale / count : 0.0,
+                       h.Percentile(0.5) / scale, h.Percentile(0.95) / scale,
+                       h.Max() / scale, unit);
+      break;
+    }
+    }
+    report << line;
+  }
+  return report;
+}
+
+status_t MetricsRegistry::WriteSnapshot(const char *path) {
+  BFile file(path, B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  BString report = Describe();
+  ssize_t written = file.Write(report.String(), report.Length());
+  return written < 0 ? (status_t)written : B_OK;
+}
+
+status_t MetricsRegistry::WriteSnapshotToLogDirectory(BString *outPath) {
+  BPath path;
+  status_t status = find_directory(B_USER_LOG_DIRECTORY, &path, true);
+  if (status != B_OK)
+    return status;
+
+  char stamp[32];
+  time_t now = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&now));
+  BString name;
+  name << "BeTon-metrics-" << stamp << ".txt";
+  path.Append(name.String());
+
+  status = WriteSnapshot(path.Path());
+  if (status == B_OK && outPath)
+    *outPath = path.Path();
+  return status;
+}
@@ -0,0 +1,146 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <Locker.h>
+#include <OS.h>
+#include <String.h>
+#include <SupportDefs.h>
+#include <atomic>
+#include <map>
+#include <memory>
+
+/**
+ * @class MetricCounter
+ * @brief Monotonic count, e.g. rows materialized or playback underruns.
+ */
+class MetricCounter {
+public:
+  void Add(int64 count = 1) {
+    fValue.fetch_add(count, std::memory_order_relaxed);
+  }
+  int64 Value() const { return fValue.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int64> fValue{0};
+};
+
+/**
+ * @class MetricGauge
+ * @brief Current value, e.g. library size or the duration of the last
+ * filter pass.
+ */
+class MetricGauge {
+public:
+  void Set(double value) { fValue.store(value, std::memory_order_relaxed); }
+
+  /** @brief Adjusts the value, for totals kept by several owners. */
+  void Add(double delta) {
+    double value = fValue.load(std::memory_order_relaxed);
+    while (!fValue.compare_exchange_weak(value, value + delta,
+                                         std::memory_order_relaxed)) {
+    }
+  }
+
+  double Value() const { return fValue.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<double> fValue{0};
+};
+
+/**
+ * @class MetricHistogram
+ * @brief Distribution of non-negative values in power-of-two buckets.
+ *
+ * Bucket @c b holds the values that need @c b bits, so percentiles are only
+ * known to within a factor of two. Good enough to tell 5 ms from 500 ms.
+ */
+class MetricHistogram {
+public:
+  static constexpr int32 kBuckets = 40;
+
+  void Record(int64 value);
+
+  int64 Count() const { return fCount.load(std::memory_order_relaxed); }
+  int64 Sum() const { return fSum.load(std::memory_order_relaxed); }
+  int64 Max() const { return fMax.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Upper bound of the bucket holding the given fraction of values.
+   * @param fraction 0.5 for the median, 0.95 for the 95th percentile.
+   */
+  int64 Percentile(double fraction) const;
+
+private:
+  std::atomic<int64> fBuckets[kBuckets] = {};
+  std::atomic<int64> fCount{0};
+  std::atomic<int64> fSum{0};
+  std::atomic<int64> fMax{0};
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Named counters, gauges and histograms shown in the Performance
+ * window.
+ *
+ * Metrics are created on first use and never removed, so call sites keep
+ * the pointer in a function-local static and update it without locking:
+ *
+ *     static MetricCounter *sUnderruns =
+ *         MetricsRegistry::Default().Counter("playback.underruns", "buffers");
+ *     sUnderruns->Add();
+ *
+ * Names are grouped by their prefix (cache, filter, library, memory,
+ * musicbrainz, playback, rows, scan, startup). Histograms in "us" are
+ * reported in milliseconds.
+ */
+class MetricsRegistry {
+public:
+  /** @brief The registry of this process. */
+  static MetricsRegistry &Default();
+
+  MetricCounter *Counter(const char *name, const char *unit);
+  MetricGauge *Gauge(const char *name, const char *unit);
+  MetricHistogram *Histogram(const char *name, const char *unit);
+
+  /**
+   * @brief Updates the process-wide gauges: memory.resident (RAM committed
+   * to all areas of the team), memory.areas and, in builds with
+   * BETON_COPY_COUNT, library.item_copies (MediaItems copied so far, see
+   * CopyCounter).
+   */
+  void SampleProcess();
+
+  /** @brief Samples the process and formats every metric, one per line. */
+  BString Describe();
+
+  /** @brief Writes Describe() to @p path. */
+  status_t WriteSnapshot(const char *path);
+
+  /**
+   * @brief Writes a snapshot to a new BeTon-metrics-<time>.txt in the user's
+   * log directory (~/config/var/log).
+   * @param outPath Receives the path of the file written, if not null.
+   */
+  status_t WriteSnapshotToLogDirectory(BString *outPath = nullptr);
+
+private:
+  MetricsRegistry();
+
+  enum Kind { kCounter, kGauge, kHistogram };
+
+  struct Entry {
+    Kind kind;
+    BString unit;
+    std::unique_ptr<MetricCounter> counter;
+    std::unique_ptr<MetricGauge> gauge;
+    std::unique_ptr<MetricHistogram> histogram;
+  };
+
+  Entry &_Find(const char *name, Kind kind, const char *unit);
+
+  BLocker fLock;
+  std::map<BString, Entry> fMetrics;
+  bigtime_t fStart;
+};
+
+#endif // METRICS_REGISTRY_H
@@ -0,0 +1,94 @@
+#include "PerformanceWindow.h"
+#include "MetricsRegistry.h"
+
+#include <Catalog.h>
+
+#undef B_TRANSLATION_CONTEXT
+#define B_TRANSLATION_CONTEXT "PerformanceWindow"
+
+#include <LayoutBuilder.h>
+#include <ScrollBar.h>
+#include <ScrollView.h>
+
+static const uint32 MSG_PERF_REFRESH = 'pfrf';
+static const uint32 MSG_PERF_SAVE = 'pfsv';
+
+/** @brief Interval between two refreshes of the metrics. */
+static const bigtime_t kRefreshInterval = 500000;
+
+/**
+ * @brief Constructs the Performance window and starts the refresh timer.
+ */
+PerformanceWindow::PerformanceWindow()
+    : BWindow(BRect(120, 120, 700, 620), B_TRANSLATE("Performance"),
+              B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS) {
+  fMetricsView = new BTextView("metrics");
+  fMetricsView->MakeEditable(false);
+  fMetricsView->SetFontAndColor(be_fixed_font);
+  BScrollView *scroll =
+      new BScrollView("scroll", fMetricsView, 0, false, true);
+
+  fStatus = new BStringView("status", "");
+  fBtnSave = new BButton("Save", B_TRANSLATE("Save Snapshot"),
+                         new BMessage(MSG_PERF_SAVE));
+
+  BLayoutBuilder::Group<>(this, B_VERTICAL, 10)
+      .SetInsets(10, 10, 10, 10)
+      .Add(scroll)
+      .AddGroup(B_HORIZONTAL)
+      .Add(fStatus)
+      .AddGlue()
+      .Add(fBtnSave)
+      .End();
+
+  // Wide enough for one metric per line in the fixed font
+  font_height fh;
+  be_fixed_font->GetHeight(&fh);
+  float fontHeight = fh.ascent + fh.descent + fh.leading;
+  ResizeTo(be_fixed_font->StringWidth("m") * 100, fontHeight * 40);
+  CenterOnScreen();
+
+  Refresh();
+  BMessage refresh(MSG_PERF_REFRESH);
+  fRefreshRunner =
+      new BMessageRunner(BMessenger(this), &refresh, kRefreshInterval);
+}
+
+PerformanceWindow::~PerformanceWindow() { delete fRefreshRunner; }
+
+void PerformanceWindow::MessageReceived(BMessage *msg) {
+  switch (msg->what) {
+  case MSG_PERF_REFRESH:
+    Refresh();
+    break;
+
+  case MSG_PERF_SAVE: {
+    BString path;
+    BString text;
+    if (MetricsRegistry::Default().WriteSnapshotToLogDirectory(&path) ==
+        B_OK)
+      text.SetToFormat(B_TRANSLATE("Saved to %s"), path.String());
+    else
+      text = B_TRANSLATE("Could not save the snapshot.");
+    fStatus->SetText(text.String());
+    break;
+  }
+
+  default:
+    BWindow::MessageReceived(msg);
+    break;
+  }
+}
+
+/**
+ * @brief Replaces the text with a new snapshot, keeping the scroll position.
+ */
+void PerformanceWindow::Refresh() {
+  BString report = MetricsRegistry::Default().Describe();
+
+  BScrollBar *bar = fMetricsView->ScrollBar(B_VERTICAL);
+  const float offset = bar ? bar->Value() : 0;
+  fMetricsView->SetText(report.String());
+  if (bar)
+    bar->SetValue(offset);
+}
@@ -0,0 +1,38 @@
+#ifndef PERFORMANCE_WINDOW_H
+#define PERFORMANCE_WINDOW_H
+
+#include <Button.h>
+#include <MessageRunner.h>
+#include <StringView.h>
+#include <TextView.h>
+#include <Window.h>
+
+/**
+ * @class PerformanceWindow
+ * @brief Live view of the MetricsRegistry.
+ *
+ * Not in any menu; opened with Command+Shift+Option+P from the main window.
+ * Refreshes twice a second and writes a snapshot to ~/config/var/log on
+ * request, to be attached to "BeTon is slow" reports.
+ */
+class PerformanceWindow : public BWindow {
+public:
+  PerformanceWindow();
+  ~PerformanceWindow() override;
+
+  void MessageReceived(BMessage *msg) override;
+
+private:
+  void Refresh();
+
+  /** @name UI Components */
+  ///@{
+  BTextView *fMetricsView;
+  BStringView *fStatus;
+  BButton *fBtnSave;
+  ///@}
+
+  BMessageRunner *fRefreshRunner = nullptr;
+};
+
+#endif // PERFORMANCE_WINDOW_H
@@ -0,0 +1,41 @@
+#include "PlaylistFile.h"
+
+#include <File.h>
+
+status_t ReadPlaylistFile(const char *path, std::vector<BString> &outPaths) {
+  BFile file(path, B_READ_ONLY);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  BString line;
+  char ch;
+  while (file.Read(&ch, 1) == 1) {
+    if (ch == '\n') {
+      line.Trim();
+      if (!line.IsEmpty() && !line.StartsWith("#")) {
+        outPaths.push_back(line);
+      }
+      line.Truncate(0);
+    } else {
+      line += ch;
+    }
+  }
+
+  return B_OK;
+}
+
+status_t WritePlaylistFile(const char *path,
+                           const std::vector<BString> &paths) {
+  BFile file(path, B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  for (const auto &entry : paths) {
+    file.Write(entry.String(), entry.Length());
+    file.Write("\n", 1);
+  }
+
+  return B_OK;
+}
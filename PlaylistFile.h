@@ -0,0 +1,30 @@
+#ifndef PLAYLIST_FILE_H
+#define PLAYLIST_FILE_H
+
+#include <String.h>
+#include <SupportDefs.h>
+#include <vector>
+
+/**
+ * @brief Reads the entries of an .m3u file.
+ *
+ * Blank lines and comments (lines starting with '#') are skipped.
+ *
+ * @param path Path of the .m3u file.
+ * @param outPaths Receives one path per entry.
+ * @return B_OK, or the error from opening the file.
+ */
+status_t ReadPlaylistFile(const char *path, std::vector<BString> &outPaths);
+
+/**
+ * @brief Writes @p paths as an .m3u file, one entry per line.
+ *
+ * An existing file is replaced.
+ *
+ * @param path Path of the .m3u file.
+ * @param paths The entries to write.
+ * @return B_OK, or the error from opening the file.
+ */
+status_t WritePlaylistFile(const char *path, const std::vector<BString> &paths);
+
+#endif // PLAYLIST_FILE_H
@@ -0,0 +1,1178 @@
+#include "ScanEngine.h"
+#include "Debug.h"
+#include "FastTagReader.h"
+#include "MediaBatch.h"
+#include "Messages.h"
+#include "ScanIOGovernor.h"
+#include "TagParserPool.h"
+#include "Trace.h"
+
+#include <File.h>
+#include <FindDirectory.h>
+#include <Path.h>
+#include <algorithm>
+#include <condition_variable>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <mutex>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Constructor.
+ *
+ * Does NOT start the scan; that is what Run() is for.
+ *
+ * @param root The root directory this engine is responsible for.
+ */
+ScanEngine::ScanEngine(const char *root)
+    : fBasePath(root), fFollowLinks(true), fBatchesSent(0), fResumeDirs(0),
+      fResumeFiles(0), fParserHelpers(0), fNextSandboxId(0),
+      fTriedFallbackPool(false), fQuarantinedFiles(0), fSkippedFiles(0),
+      fThrottledTime(0), fPendingDirs(0), fPendingFiles(0), fCountThread(-1),
+      fCountStop(false), fStopRequested(false), fScannedDirs(0),
+      fFoundFiles(0) {
+  fLastUpdate = std::chrono::steady_clock::now();
+  fParse = [](const BString &path, TagData &out) {
+    FastTagReader::ReadTags(BPath(path.String()), out);
+  };
+}
+
+/**
+ * Parser threads still stuck in a read are left behind; they own their
+ * state and exit on their own if the read ever returns.
+ */
+ScanEngine::~ScanEngine() { ReapParsers(); }
+
+/**
+ * @brief Loads the traversal state of an interrupted scan.
+ *
+ * The pending directories are stored bottom-to-top, exactly as the DFS stack
+ * looked when the checkpoint was taken. They are kept as stored; Run()
+ * drops those outside the root unless links are followed, since followed
+ * links are stored resolved.
+ *
+ * @param checkpoint The persisted MSG_SCAN_CHECKPOINT message.
+ */
+void ScanEngine::SetResumeState(const BMessage &checkpoint) {
+  fResumeStack.clear();
+  fResumeVisited.clear();
+
+  const char *dir = nullptr;
+  for (int32 i = 0; checkpoint.FindString("pending", i, &dir) == B_OK; i++)
+    fResumeStack.push_back(dir);
+
+  const void *data = nullptr;
+  ssize_t size = 0;
+  if (checkpoint.FindData("visited", B_RAW_TYPE, &data, &size) == B_OK) {
+    const int64 *nodes = static_cast<const int64 *>(data);
+    for (size_t i = 0; i + 1 < size / sizeof(int64); i += 2)
+      fResumeVisited.insert(NodeId((dev_t)nodes[i], (ino_t)nodes[i + 1]));
+  }
+
+  fResumeDirs = checkpoint.GetInt32("dirs", 0);
+  fResumeFiles = checkpoint.GetInt32("files", 0);
+}
+
+/**
+ * @brief Cheap pre-filter deciding which files are worth opening.
+ *
+ * The actual format comes from the file's magic bytes (see FormatDetector);
+ * this only keeps obvious non-audio (covers, cue sheets, logs) from being
+ * read. Names without an extension are let through and sniffed.
+ *
+ * @param leaf The file name.
+ * @return True if the file may be audio.
+ */
+static bool MayBeAudioFile(const char *leaf) {
+  const char *dot = strrchr(leaf, '.');
+  if (!dot || dot == leaf)
+    return true;
+
+  static const char *exts[] = {"mp3", "wav", "flac", "ogg", "oga", "opus",
+                               "m4a", "aac", "wma", "aif", "aiff"};
+
+  for (auto ext : exts) {
+    if (strcasecmp(dot + 1, ext) == 0)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Joins a directory and an entry name, without a double slash below
+ * the root directory.
+ */
+static BString ChildPath(const BString &dir, const char *leaf) {
+  BString path(dir);
+  if (path.Length() == 0 || path.ByteAt(path.Length() - 1) != '/')
+    path << '/';
+  return path << leaf;
+}
+
+/**
+ * @brief Checks whether @p path is @p dir or below it, comparing whole path
+ * components so that "/music2" is not below "/music".
+ */
+bool ScanEngine::IsInDirectory(const BString &path, const BString &dir) {
+  if (!path.StartsWith(dir))
+    return false;
+  return path.Length() == dir.Length() ||
+         (dir.Length() > 0 && dir.ByteAt(dir.Length() - 1) == '/') ||
+         path.ByteAt(dir.Length()) == '/';
+}
+
+/**
+ * @brief Checks whether the cache already holds this exact file version.
+ */
+bool ScanEngine::IsUnchanged(const BString &path,
+                             const struct stat &st) const {
+  auto it = fCache.find(path);
+  return it != fCache.end() && it->second.mtime == st.st_mtime &&
+         it->second.size == st.st_size;
+}
+
+/**
+ * @brief Checks whether this exact file version failed to parse before.
+ */
+bool ScanEngine::IsQuarantined(const BString &path,
+                               const struct stat &st) const {
+  auto it = fQuarantine.find(path);
+  return it != fQuarantine.end() && it->second.mtime == st.st_mtime &&
+         it->second.size == st.st_size;
+}
+
+/**
+ * @brief Hints the kernel to start reading the tag area of @p file.
+ *
+ * Only the region FastTagReader reads up front is requested, and files the
+ * cache says are unchanged are skipped. Does nothing on Haiku (see
+ * kReadaheadFiles).
+ */
+void ScanEngine::Readahead(const PendingFile &file) const {
+#if defined(POSIX_FADV_WILLNEED) && !defined(__HAIKU__)
+  if (IsUnchanged(file.path, file.st))
+    return;
+
+  // Prefetching bunches reads together that a throttled scan spreads out
+  if (fIOGovernor &&
+      fIOGovernor->CurrentState() != ScanIOGovernor::kUnthrottled)
+    return;
+
+  int fd = open(file.path.String(), O_RDONLY);
+  if (fd < 0)
+    return;
+  posix_fadvise(fd, 0, FastTagReader::kHeadSize, POSIX_FADV_WILLNEED);
+  close(fd);
+#else
+  (void)file;
+#endif
+}
+
+/**
+ * @brief Waits until the I/O governor allows the next read.
+ *
+ * Sleeps in short steps so that a stop request or a progress update is never
+ * held up by a long wait.
+ * @param bytes Bytes about to be read.
+ * @param ops File operations about to be made.
+ */
+void ScanEngine::WaitForIOBudget(off_t bytes, int32 ops) {
+  if (!fIOGovernor)
+    return;
+
+  bigtime_t wait = fIOGovernor->Reserve(bytes, ops);
+  if (wait <= 0)
+    return;
+
+  TRACE_SCOPE_ARG("scan", "WaitForIOBudget", "wait", wait);
+  fThrottledTime += wait;
+  bigtime_t until = system_time() + wait;
+  while (!fStopRequested) {
+    bigtime_t left = until - system_time();
+    if (left <= 0)
+      break;
+    snooze(std::min<bigtime_t>(left, 100000));
+    ReportProgress();
+  }
+}
+
+/**
+ * @brief Processes a single file entry.
+ *
+ * Workflow:
+ * 1. FAST SKIP: Checks against `fCache` to see if file is unchanged
+ * (mtime/size), and skips files quarantined in an earlier scan.
+ * 2. METADATA: Waits for the I/O budget, then extracts tags (Title, Artist,
+ * Album, Year, MBIDs) using TagLib, either right here or in a helper process.
+ * 3. BATCHING: Adds the resulting `MediaItem` to `fBatch` (see
+ * AddParsedFile()).
+ *
+ * @param file A supported audio file and its stat data.
+ */
+void ScanEngine::ProcessFile(const PendingFile &file) {
+  TRACE_SCOPE("scan", "ProcessFile");
+
+  // 1. FAST SKIP: Check Cache
+  if (IsUnchanged(file.path, file.st)) {
+    // Unchanged -> Skip rigorous parsing
+    fMetrics.AddSkipped();
+    return;
+  }
+
+  if (IsQuarantined(file.path, file.st)) {
+    fMetrics.AddOther();
+    return;
+  }
+
+  fFoundFiles++;
+  ReportProgress();
+
+  // Open, head read and (usually small) tail read
+  const off_t readSize =
+      std::min<off_t>(file.st.st_size, FastTagReader::kHeadSize);
+  WaitForIOBudget(readSize, 2);
+  if (fStopRequested)
+    return;
+  fMetrics.AddBytes(readSize);
+
+  if (fSandbox && ParseInSandbox(file))
+    return;
+
+  ParseInProcess(file);
+}
+
+/**
+ * @struct ScanEngine::ParserState
+ * @brief Request handed to the parser thread and its answer.
+ *
+ * Owned jointly by the engine and the parser thread, so a thread that is
+ * abandoned while stuck in a read can still finish and clean up safely.
+ */
+struct ScanEngine::ParserState {
+  std::mutex lock;
+  std::condition_variable changed; ///< Signals every change below.
+  ParseFunc parse;
+  thread_id thread = -1;
+  BString path;
+  bool requested = false; ///< @c path waits for the parser thread.
+  bool done = false;      ///< @c tags hold the result for @c path.
+  bool abandoned = false;
+  bool exited = false; ///< The thread is done with the state.
+  TagData tags;
+};
+
+/**
+ * @brief Entry point of the parser thread.
+ *
+ * Parses one path per request until the engine abandons it.
+ * @param data Heap-allocated shared_ptr to the ParserState, deleted here.
+ */
+status_t ScanEngine::ParserEntry(void *data) {
+  auto *ref = static_cast<std::shared_ptr<ParserState> *>(data);
+  std::shared_ptr<ParserState> state = *ref;
+  delete ref;
+
+  std::unique_lock<std::mutex> lock(state->lock);
+  while (true) {
+    state->changed.wait(lock,
+                        [&] { return state->requested || state->abandoned; });
+    if (state->abandoned)
+      break;
+    state->requested = false;
+    const BString path = state->path;
+    lock.unlock();
+
+    TagData td;
+    try {
+      TRACE_SCOPE("scan", "ReadTags");
+      state->parse(path, td);
+    } catch (...) {
+      // TagLib failed -> ignore
+    }
+
+    lock.lock();
+    // The engine gave up on this file while we were reading it
+    if (state->abandoned)
+      break;
+
+    state->tags = std::move(td);
+    state->done = true;
+    state->changed.notify_all();
+  }
+  state->exited = true;
+  return B_OK;
+}
+
+/**
+ * @brief Parses @p file on the parser thread, waiting at most kParseTimeout.
+ *
+ * A parser thread that misses the deadline is abandoned and replaced by a
+ * new one for the next file.
+ * @return B_OK, B_TIMED_OUT or B_CANCELED if a stop was requested.
+ */
+status_t ScanEngine::ParseWithDeadline(const PendingFile &file,
+                                       TagData &td) {
+  if (!fParser) {
+    auto state = std::make_shared<ParserState>();
+    state->parse = fParse;
+
+    auto *ref = new std::shared_ptr<ParserState>(state);
+    thread_id thread =
+        spawn_thread(ParserEntry, "ScanEngine Parser", B_LOW_PRIORITY, ref);
+    if (thread < B_OK) {
+      delete ref;
+      // No parser thread: parse right here, without a deadline
+      try {
+        fParse(file.path, td);
+      } catch (...) {
+      }
+      return B_OK;
+    }
+
+    state->thread = thread;
+    resume_thread(thread);
+    fParser = state;
+  }
+
+  std::unique_lock<std::mutex> lock(fParser->lock);
+  fParser->path = file.path;
+  fParser->requested = true;
+  fParser->done = false;
+  fParser->changed.notify_all();
+
+  // Poll, so that a stop request does not wait for a slow file
+  const bigtime_t deadline = system_time() + kParseTimeout;
+  status_t err = B_TIMED_OUT;
+  while (true) {
+    if (fParser->done) {
+      err = B_OK;
+      break;
+    }
+    if (fStopRequested) {
+      err = B_CANCELED;
+      break;
+    }
+    if (system_time() >= deadline)
+      break;
+    fParser->changed.wait_for(lock, std::chrono::milliseconds(100));
+  }
+
+  if (err == B_OK) {
+    td = std::move(fParser->tags);
+    return B_OK;
+  }
+
+  // The parser thread exits on its own once the read returns, if ever
+  fParser->abandoned = true;
+  lock.unlock();
+  fAbandonedParsers.push_back(std::move(fParser));
+  return err;
+}
+
+/** @brief Lets the idle parser thread run into its exit and waits for it. */
+void ScanEngine::StopParser() {
+  if (!fParser)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(fParser->lock);
+    fParser->abandoned = true;
+    fParser->changed.notify_all();
+  }
+  status_t result;
+  wait_for_thread(fParser->thread, &result);
+  fParser.reset();
+}
+
+/** @brief Waits for the abandoned parser threads that have exited. */
+void ScanEngine::ReapParsers() {
+  for (auto it = fAbandonedParsers.begin(); it != fAbandonedParsers.end();) {
+    bool exited;
+    {
+      std::lock_guard<std::mutex> lock((*it)->lock);
+      exited = (*it)->exited;
+    }
+    if (!exited) {
+      ++it;
+      continue;
+    }
+
+    status_t result;
+    wait_for_thread((*it)->thread, &result);
+    it = fAbandonedParsers.erase(it);
+  }
+}
+
+/**
+ * @brief Starts a TagParserPool for the rest of the scan once too many
+ * parser threads are stuck.
+ *
+ * Tried once per scan.
+ * @return true if files can go to fSandbox.
+ */
+bool ScanEngine::StartFallbackPool() {
+  if (fTriedFallbackPool || !fPoolFactory)
+    return false;
+
+  fTriedFallbackPool = true;
+  fSandbox.reset(fPoolFactory(TagParserPool::kDefaultHelpers, kParseTimeout));
+  if (fSandbox && fSandbox->InitCheck() != B_OK)
+    fSandbox.reset();
+  DEBUG_PRINT("[ScanEngine] %zu parser threads stuck, %s\n",
+              fAbandonedParsers.size(),
+              fSandbox ? "parsing in helpers" : "quarantining new files");
+  return fSandbox != nullptr;
+}
+
+/**
+ * @brief Adds a parse time to the metrics and keeps track of the
+ * kSlowestFiles slowest files of this scan.
+ */
+void ScanEngine::RecordParseTime(const BString &path, bigtime_t elapsed) {
+  fMetrics.AddParsed(elapsed);
+
+  if (fSlowestFiles.size() >= kSlowestFiles &&
+      elapsed <= fSlowestFiles.back().first)
+    return;
+
+  auto pos = std::upper_bound(
+      fSlowestFiles.begin(), fSlowestFiles.end(), elapsed,
+      [](bigtime_t t, const std::pair<bigtime_t, BString> &e) {
+        return t > e.first;
+      });
+  fSlowestFiles.insert(pos, std::make_pair(elapsed, path));
+  if (fSlowestFiles.size() > kSlowestFiles)
+    fSlowestFiles.pop_back();
+}
+
+/**
+ * @brief Reads the tags of @p file without leaving the scanner process.
+ *
+ * Files exceeding kParseTimeout are quarantined. While kMaxAbandonedParsers
+ * parser threads are stuck, no new one is started: the file goes to a
+ * fallback pool, or is skipped for this scan only. Skipped files did nothing
+ * wrong, so they are not quarantined and the next scan tries them again.
+ */
+void ScanEngine::ParseInProcess(const PendingFile &file) {
+  TRACE_SCOPE("scan", "ParseInProcess");
+
+  ReapParsers();
+  if (!fParser && fAbandonedParsers.size() >= kMaxAbandonedParsers) {
+    // With a pool running, the file only gets here if the pool failed it
+    if (fSandbox || !StartFallbackPool() || !ParseInSandbox(file)) {
+      DEBUG_PRINT("[ScanEngine] Skipping %s, no parser left\n",
+                  file.path.String());
+      fSkippedFiles++;
+    }
+    return;
+  }
+
+  const bigtime_t start = system_time();
+
+  TagData td;
+  status_t status = ParseWithDeadline(file, td);
+  if (status == B_CANCELED)
+    return;
+
+  RecordParseTime(file.path, system_time() - start);
+
+  if (status == B_TIMED_OUT) {
+    ReportBadFile(file, "timeout");
+    return;
+  }
+
+  AddParsedFile(file, td);
+}
+
+/**
+ * @brief Hands @p file to a parser helper.
+ *
+ * Collects finished results while every helper queue is full.
+ * @return false if the file has to be parsed in-process instead.
+ */
+bool ScanEngine::ParseInSandbox(const PendingFile &file) {
+  const int32 id = fNextSandboxId++;
+
+  status_t status;
+  while ((status = fSandbox->Submit(id, file.path)) == B_WOULD_BLOCK) {
+    if (fStopRequested)
+      return true;
+    TRACE_SCOPE("scan", "WaitForSandbox");
+    CollectSandboxResult(B_INFINITE_TIMEOUT);
+  }
+
+  if (status != B_OK)
+    return false;
+
+  fSandboxFiles[id] = file;
+
+  // Pick up whatever is already done without waiting
+  while (CollectSandboxResult(0)) {
+  }
+  return true;
+}
+
+/**
+ * @brief Processes the next finished helper result.
+ *
+ * Files that crashed or hung their helper are reported and left out of the
+ * library. Any other failure falls back to in-process parsing.
+ * @param timeout Maximum time to wait for a result.
+ * @return false if no result arrived in time.
+ */
+bool ScanEngine::CollectSandboxResult(bigtime_t timeout) {
+  TagParserPool::Result result;
+  if (!fSandbox->Collect(result, timeout))
+    return false;
+
+  auto it = fSandboxFiles.find(result.id);
+  if (it == fSandboxFiles.end())
+    return true;
+
+  PendingFile file = it->second;
+  fSandboxFiles.erase(it);
+
+  if (result.status == B_OK || result.status == B_TIMED_OUT ||
+      result.status == B_ERROR)
+    RecordParseTime(file.path, result.elapsed);
+
+  switch (result.status) {
+  case B_OK:
+    AddParsedFile(file, result.tags);
+    break;
+  case B_TIMED_OUT:
+    ReportBadFile(file, "timeout");
+    break;
+  case B_ERROR:
+    ReportBadFile(file, "crash");
+    break;
+  default:
+    ParseInProcess(file);
+    break;
+  }
+  return true;
+}
+
+/**
+ * @brief Waits for all files still queued at the parser helpers.
+ *
+ * Gives up when a stop was requested; the abandoned files are picked up by
+ * the next scan.
+ */
+void ScanEngine::DrainSandbox() {
+  if (!fSandbox)
+    return;
+
+  TRACE_SCOPE("scan", "DrainSandbox");
+  while (!fStopRequested && fSandbox->CountPending() > 0 &&
+         CollectSandboxResult(B_INFINITE_TIMEOUT)) {
+  }
+}
+
+/**
+ * @brief Records a file that crashed or hung the parser.
+ *
+ * Sends MSG_SCAN_FILE_FAILED so the cache can store it, and skips it for
+ * the rest of this scan.
+ */
+void ScanEngine::ReportBadFile(const PendingFile &file, const char *reason) {
+  DEBUG_PRINT("[ScanEngine] Quarantining %s (%s)\n", file.path.String(),
+              reason);
+
+  fQuarantinedFiles++;
+
+  QuarantinedFile &bad = fQuarantine[file.path];
+  bad.size = file.st.st_size;
+  bad.mtime = file.st.st_mtime;
+  bad.reason = reason;
+
+  if (!fCacheTarget)
+    return;
+
+  BMessage msg(MSG_SCAN_FILE_FAILED);
+  msg.AddString("path", file.path);
+  msg.AddInt64("size", bad.size);
+  msg.AddInt64("mtime", bad.mtime);
+  msg.AddString("reason", bad.reason);
+  fCacheTarget(msg);
+}
+
+/**
+ * @brief Turns parsed tags into a MediaItem and adds it to the batch.
+ *
+ * Flushes once the item/byte budget is used up or the latency deadline has
+ * passed.
+ *
+ * Tracks shorter than the filter's minimum duration, and files whose content
+ * turned out not to be audio, are dropped.
+ *
+ * @param file The parsed file and its stat data.
+ * @param td Its tags; the strings are moved into the item.
+ */
+void ScanEngine::AddParsedFile(const PendingFile &file, TagData &td) {
+  if (!td.format.IsAudio() || fFilter.SkipDuration(td.lengthSec))
+    return;
+
+  const BString &filePath = file.path;
+  const struct stat &st = file.st;
+
+  // The traversal only produces absolute, normalized paths, so leaf and
+  // parent are split off directly instead of through two BPaths per file
+  const int32 slash = filePath.FindLast('/');
+
+  // Fallback: Use filename as title if tag is empty
+  if (td.title.IsEmpty()) {
+    td.title = filePath.String() + slash + 1;
+  }
+
+  // Build MediaItem
+  MediaItem item;
+  if (slash > 0) {
+    item.base.SetTo(filePath.String(), slash);
+  } else {
+    item.base = fBasePath;
+  }
+  item.path = filePath;
+  item.title = std::move(td.title);
+  item.artist = std::move(td.artist);
+  item.album = std::move(td.album);
+  item.albumArtist = std::move(td.albumArtist);
+  item.composer = std::move(td.composer);
+  item.genre = std::move(td.genre);
+  item.comment = std::move(td.comment);
+  item.year = td.year;
+  item.track = td.track;
+  item.trackTotal = td.trackTotal;
+  item.disc = td.disc;
+  item.discTotal = td.discTotal;
+  item.duration = td.lengthSec;
+  item.bitrate = td.bitrate;
+  item.sampleRate = td.sampleRate;
+  item.channels = td.channels;
+  item.size = st.st_size;
+  item.mtime = st.st_mtime;
+  item.inode = st.st_ino;
+  item.mbTrackId = std::move(td.mbTrackID);
+  item.mbAlbumId = std::move(td.mbAlbumID);
+  item.mbArtistId = std::move(td.mbArtistID);
+
+  // Batch Logic (send to CacheManager)
+  bool needsFlush = false;
+
+  fBatchLock.Lock();
+  if (fBatch.CountItems() == 0) {
+    // Deadline starts with the oldest item in the batch
+    fBatchDeadline =
+        std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(fBatchesSent == 0 ? kFirstBatchLatencyMs
+                                                    : kBatchLatencyMs);
+  }
+  fBatch.Add(item);
+  if ((size_t)fBatch.CountItems() >= kMediaBatchMaxItems ||
+      fBatch.EncodedSize() >= kMediaBatchMaxBytes ||
+      std::chrono::steady_clock::now() >= fBatchDeadline) {
+    needsFlush = true;
+  }
+  fBatchLock.Unlock();
+
+  if (needsFlush) {
+    FlushBatch();
+  }
+}
+
+/**
+ * @brief Flushes the pending batch if its latency deadline has expired.
+ *
+ * Called between directory entries so that items found on slow volumes
+ * (or followed by long runs of unchanged files) are not held back until the
+ * next parsed file.
+ */
+void ScanEngine::FlushBatchIfDue() {
+  bool due = false;
+
+  fBatchLock.Lock();
+  due = fBatch.CountItems() > 0 &&
+        std::chrono::steady_clock::now() >= fBatchDeadline;
+  fBatchLock.Unlock();
+
+  if (due)
+    FlushBatch();
+}
+
+/**
+ * @brief Blocks while the consumer has too many batches queued.
+ *
+ * Keeps a fast scan from flooding the cache looper (and, via forwarding,
+ * the UI) with messages it cannot process in time. Returns early on stop.
+ */
+void ScanEngine::WaitForCacheQueue() {
+  if (!fQueuedBatches || fQueuedBatches->load() < kMaxQueuedBatches)
+    return;
+
+  TRACE_SCOPE("scan", "WaitForCacheQueue");
+  while (!fStopRequested && fQueuedBatches->load() >= kMaxQueuedBatches)
+    snooze(5000);
+}
+
+/**
+ * @brief Sends the current batch of found items to the cache target.
+ *
+ * Uses MSG_MEDIA_BATCH with the items encoded as a single MediaBatch blob
+ * (see MediaBatch.h). Clears the buffer, then waits for room in the
+ * consumer's queue before sending.
+ */
+void ScanEngine::FlushBatch() {
+  fBatchLock.Lock();
+  if (fBatch.CountItems() == 0) {
+    fBatchLock.Unlock();
+    return;
+  }
+
+  TRACE_SCOPE_ARG("scan", "FlushBatch", "items", fBatch.CountItems());
+  BMessage msg(MSG_MEDIA_BATCH);
+  msg.AddString("base", fBasePath);
+
+  // Single binary blob instead of one message field per item attribute
+  fBatch.AddToMessage(msg);
+  fBatch.Clear();
+  fBatchesSent++;
+  fBatchLock.Unlock();
+
+  WaitForCacheQueue();
+
+  if (fCacheTarget) {
+    if (fQueuedBatches)
+      fQueuedBatches->fetch_add(1);
+    if (fCacheTarget(msg) != B_OK && fQueuedBatches)
+      fQueuedBatches->fetch_sub(1);
+  }
+}
+
+/**
+ * @brief Persists the current traversal position via the cache target.
+ *
+ * Flushes the pending batch first. Since the target gets its messages in
+ * order, every item found in the completed directories is in the cache by
+ * the time the checkpoint is written.
+ *
+ * @param pending The DFS stack of directories not yet visited.
+ */
+void ScanEngine::SendCheckpoint(const std::vector<BString> &pending) {
+  FlushBatch();
+
+  if (!fCacheTarget)
+    return;
+
+  BMessage msg(MSG_SCAN_CHECKPOINT);
+  msg.AddString("base", fBasePath);
+  for (const auto &dir : pending)
+    msg.AddString("pending", dir);
+  msg.AddInt32("dirs", fScannedDirs);
+  msg.AddInt32("files", fFoundFiles);
+
+  // (device, inode) pairs; the checkpoint never leaves this machine
+  std::vector<int64> visited;
+  visited.reserve(fVisitedDirs.size() * 2);
+  for (const NodeId &node : fVisitedDirs) {
+    visited.push_back((int64)node.first);
+    visited.push_back((int64)node.second);
+  }
+  if (!visited.empty()) {
+    msg.AddData("visited", B_RAW_TYPE, visited.data(),
+                visited.size() * sizeof(int64));
+  }
+
+  fCacheTarget(msg);
+  DEBUG_PRINT("[ScanEngine] Checkpoint: %zu dirs pending in %s\n",
+              pending.size(), fBasePath.String());
+}
+
+/**
+ * @brief Reports scan progress to the UI.
+ *
+ * Rates limited to avoid flooding the message queue.
+ * Sends MSG_SCAN_PROGRESS with dirs and files counts, the governor's
+ * ScanIOGovernor::State ("io_state"), the time spent waiting for it
+ * ("throttled_usec") and the ScanMetrics fields.
+ */
+void ScanEngine::ReportProgress() {
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now - fLastUpdate)
+          .count();
+
+  // Limit updates to ~10Hz to avoid flooding the message queue
+  if (elapsed > 100) {
+    fLastUpdate = now;
+    if (fLiveTarget) {
+      BMessage msg(MSG_SCAN_PROGRESS);
+      msg.AddInt32("dirs", fScannedDirs);
+      msg.AddInt32("files", fFoundFiles);
+
+      auto totalElapsed =
+          std::chrono::duration_cast<std::chrono::seconds>(now - fStartTime)
+              .count();
+      msg.AddInt64("elapsed_sec", totalElapsed);
+      msg.AddInt32("io_state", fIOGovernor ? fIOGovernor->CurrentState()
+                                           : ScanIOGovernor::kUnthrottled);
+      msg.AddInt64("throttled_usec", fThrottledTime);
+
+      ScanMetrics::QueueDepths depths;
+      depths.dirs = fPendingDirs;
+      depths.files = fPendingFiles;
+      depths.helpers = (int32)fSandboxFiles.size();
+      fBatchLock.Lock();
+      depths.batch = fBatch.CountItems();
+      fBatchLock.Unlock();
+      depths.cache = fQueuedBatches ? fQueuedBatches->load() : 0;
+      fMetrics.SetQueueDepths(depths);
+      fMetrics.AddTo(msg);
+
+      fLiveTarget(msg);
+    }
+  }
+}
+
+/**
+ * @brief Appends the final report of a scan to the scan log.
+ *
+ * The log lives in the user log directory and is started over once it grows
+ * beyond kMaxScanLogSize. Each report is written with a single call, so the
+ * reports of scanners finishing at the same time do not interleave.
+ * @param report The final MSG_SCAN_DONE of this scan.
+ */
+void ScanEngine::WriteScanLog(const BMessage &report) const {
+  BPath p;
+  if (find_directory(B_USER_LOG_DIRECTORY, &p, true) != B_OK)
+    return;
+  p.Append(kScanLogName);
+
+  BFile file(p.Path(), B_WRITE_ONLY | B_CREATE_FILE | B_OPEN_AT_END);
+  if (file.InitCheck() != B_OK)
+    return;
+
+  off_t size = 0;
+  if (file.GetSize(&size) == B_OK && size > kMaxScanLogSize)
+    file.SetSize(0);
+
+  const int64 elapsed = report.GetInt64("elapsed_sec", 0);
+  BString text;
+  text.SetToFormat("Scan of %s: %d folders in %02d:%02d, %.1f s throttled, "
+                   "%d quarantined, %d skipped\n",
+                   fBasePath.String(), (int)fScannedDirs, (int)(elapsed / 60),
+                   (int)(elapsed % 60), fThrottledTime / 1000000.0,
+                   (int)fQuarantinedFiles, (int)fSkippedFiles);
+  text << ScanMetrics::Describe(report);
+
+  BString line;
+  for (const auto &[usec, path] : fSlowestFiles) {
+    line.SetToFormat("  Slow: %lld ms %s\n", (long long)usec / 1000,
+                     path.String());
+    text << line;
+  }
+  text << "\n";
+
+  file.Write(text.String(), text.Length());
+}
+
+/**
+ * @brief Static entry point for the pre-count thread.
+ */
+status_t ScanEngine::CountEntry(void *data) {
+  static_cast<ScanEngine *>(data)->CountFiles();
+  return B_OK;
+}
+
+/**
+ * @brief Counts the candidate files below fCountRoots for the ETA.
+ *
+ * Applies the same name, size and filter rules as the scan but does not
+ * follow symbolic links, so it never needs loop detection. Directory reads
+ * draw from the I/O budget like the scan's own.
+ */
+void ScanEngine::CountFiles() {
+  TRACE_SCOPE("scan", "CountFiles");
+  std::vector<BString> stack(fCountRoots);
+  int32 total = 0;
+
+  while (!stack.empty()) {
+    if (fCountStop || fStopRequested)
+      return;
+
+    if (fIOGovernor) {
+      bigtime_t until = system_time() + fIOGovernor->Reserve(0, 1);
+      while (system_time() < until) {
+        if (fCountStop || fStopRequested)
+          return;
+        snooze(std::min<bigtime_t>(until - system_time(), 100000));
+      }
+    }
+
+    const BString dirPath = stack.back();
+    stack.pop_back();
+    DIR *dir = opendir(dirPath.String());
+    if (dir == nullptr)
+      continue;
+
+    while (struct dirent *entry = readdir(dir)) {
+      if (fCountStop || fStopRequested)
+        break;
+
+      const char *name = entry->d_name;
+      const BString path = ChildPath(dirPath, name);
+      struct stat st;
+      if (name[0] == '.' || lstat(path.String(), &st) != 0 ||
+          S_ISLNK(st.st_mode))
+        continue;
+
+      if (S_ISDIR(st.st_mode)) {
+        if (!fFilter.SkipDirectory(name))
+          stack.push_back(path);
+      } else if (MayBeAudioFile(name) && !fFilter.SkipSize(st.st_size)) {
+        total++;
+      }
+    }
+    closedir(dir);
+  }
+
+  if (fCountStop || fStopRequested)
+    return;
+  fMetrics.SetTotal(total);
+}
+
+/**
+ * @brief Lists one directory, queues its subdirectories on @p stack and
+ * processes its audio files.
+ *
+ * Directories already visited during this scan and files already seen under
+ * another path (hard links, followed symlinks) are skipped.
+ */
+void ScanEngine::ScanDirectory(const BString &path,
+                               std::vector<BString> &stack) {
+  WaitForIOBudget(0, 1);
+  DIR *dir = opendir(path.String());
+  if (dir == nullptr)
+    return;
+
+  // Loops through links or mounts lead back to a known directory
+  struct stat dirSt;
+  if (fstat(dirfd(dir), &dirSt) != 0 ||
+      !fVisitedDirs.insert(NodeId(dirSt.st_dev, dirSt.st_ino)).second) {
+    closedir(dir);
+    return;
+  }
+
+  fScannedDirs++;
+  ReportProgress();
+  TRACE_SCOPE("scan", "Directory");
+
+  // Collect the directory first, so its files can be parsed in on-disk
+  // order instead of directory order
+  std::vector<PendingFile> files;
+  while (struct dirent *entry = readdir(dir)) {
+    if (fStopRequested)
+      break;
+
+    // Ignore dotfiles
+    const char *leaf = entry->d_name;
+    if (leaf[0] == '.')
+      continue;
+
+    PendingFile file;
+    file.path = ChildPath(path, leaf);
+    if (lstat(file.path.String(), &file.st) != 0)
+      continue;
+
+    if (S_ISLNK(file.st.st_mode)) {
+      // Resolve to the link target, skipping dangling links
+      char target[PATH_MAX];
+      if (!fFollowLinks || realpath(file.path.String(), target) == nullptr ||
+          stat(target, &file.st) != 0)
+        continue;
+      file.path = target;
+    }
+
+    if (S_ISDIR(file.st.st_mode)) {
+      if (fFilter.SkipDirectory(leaf))
+        continue;
+      if (fVisitedDirs.find(NodeId(file.st.st_dev, file.st.st_ino)) ==
+          fVisitedDirs.end())
+        stack.push_back(file.path);
+      continue;
+    }
+
+    if (!MayBeAudioFile(leaf) || fFilter.SkipSize(file.st.st_size) ||
+        !fSeenFiles.insert(NodeId(file.st.st_dev, file.st.st_ino)).second)
+      continue;
+    files.push_back(file);
+  }
+  closedir(dir);
+
+  // BFS inode numbers are block addresses, so this is disk order
+  std::sort(files.begin(), files.end(),
+            [](const PendingFile &a, const PendingFile &b) {
+              return a.st.st_ino < b.st.st_ino;
+            });
+
+  for (size_t i = 0; i < std::min(kReadaheadFiles, files.size()); i++)
+    Readahead(files[i]);
+
+  for (size_t i = 0; i < files.size(); i++) {
+    if (fStopRequested)
+      break;
+
+    if (kReadaheadFiles > 0 && i + kReadaheadFiles < files.size())
+      Readahead(files[i + kReadaheadFiles]);
+
+    fPendingFiles = (int32)(files.size() - i - 1);
+
+    ProcessFile(files[i]);
+    FlushBatchIfDue();
+  }
+}
+
+/**
+ * @brief Performs an iterative DFS from the root, or from a resumed
+ * checkpoint if one was set.
+ *
+ * Sends a checkpoint after a directory has been completed when
+ * kCheckpointIntervalSec has passed since the last one, and MSG_SCAN_DONE
+ * when finished.
+ */
+status_t ScanEngine::Run() {
+  fScannedDirs = 0;
+  fFoundFiles = 0;
+  fBatchesSent = 0;
+  fStartTime = std::chrono::steady_clock::now();
+  fLastCheckpoint = fStartTime;
+  fVisitedDirs.clear();
+  fSeenFiles.clear();
+  fSlowestFiles.clear();
+  fQuarantinedFiles = 0;
+  fSkippedFiles = 0;
+  fTriedFallbackPool = false;
+
+  if (fParserHelpers > 0 && fPoolFactory) {
+    fSandbox.reset(fPoolFactory(fParserHelpers, kParseTimeout));
+    if (fSandbox && fSandbox->InitCheck() != B_OK)
+      fSandbox.reset();
+    if (!fSandbox)
+      DEBUG_PRINT("[ScanEngine] No parser helpers, parsing in-process\n");
+  }
+
+  std::vector<BString> stack;
+  if (!fFollowLinks) {
+    // Only followed links lead outside the root
+    fResumeStack.erase(std::remove_if(fResumeStack.begin(),
+                                      fResumeStack.end(),
+                                      [this](const BString &dir) {
+                                        return !IsInDirectory(dir, fBasePath);
+                                      }),
+                       fResumeStack.end());
+  }
+  if (!fResumeStack.empty()) {
+    DEBUG_PRINT("[ScanEngine] Resuming %s with %zu pending dirs\n",
+                fBasePath.String(), fResumeStack.size());
+    stack.swap(fResumeStack);
+    fVisitedDirs.swap(fResumeVisited);
+    fScannedDirs = fResumeDirs;
+    fFoundFiles = fResumeFiles;
+  } else {
+    stack.push_back(fBasePath);
+  }
+
+  // Count what is left to do alongside the scan, for the ETA
+  fMetrics.Start();
+  fCountRoots = stack;
+  fCountStop = false;
+  fCountThread = spawn_thread(CountEntry, "ScanEngine Counter",
+                              B_LOWEST_ACTIVE_PRIORITY, this);
+  if (fCountThread >= 0)
+    resume_thread(fCountThread);
+
+  while (!stack.empty() && !fStopRequested) {
+    const BString currentPath = stack.back();
+    stack.pop_back();
+    fPendingDirs = (int32)stack.size();
+
+    ScanDirectory(currentPath, stack);
+
+    // Checkpoint only at directory boundaries, so that a resumed scan
+    // never has to revisit a partially processed directory
+    auto now = std::chrono::steady_clock::now();
+    if (!fStopRequested && !stack.empty() &&
+        now - fLastCheckpoint >=
+            std::chrono::seconds(kCheckpointIntervalSec)) {
+      DrainSandbox();
+      SendCheckpoint(stack);
+      fLastCheckpoint = now;
+    }
+  }
+
+  if (fCountThread >= 0) {
+    fCountStop = true;
+    status_t countResult;
+    wait_for_thread(fCountThread, &countResult);
+    fCountThread = -1;
+  }
+
+  DrainSandbox();
+  fSandbox.reset();
+  fSandboxFiles.clear();
+  StopParser();
+  ReapParsers();
+  FlushBatch();
+
+  if (fStopRequested)
+    return B_CANCELED;
+
+  DEBUG_PRINT("[ScanEngine] Scan of %s finished\n", fBasePath.String());
+  SendDone();
+  return B_OK;
+}
+
+/**
+ * @brief Sends MSG_SCAN_DONE to both targets and writes the scan log.
+ *
+ * The cache target only gets the root in "base"; the live target gets the
+ * final report, followed by a last MSG_SCAN_PROGRESS with the final counts.
+ */
+void ScanEngine::SendDone() {
+  if (fCacheTarget) {
+    BMessage done(MSG_SCAN_DONE);
+    done.AddString("base", fBasePath);
+    fCacheTarget(done);
+  }
+
+  // Final detailed report
+  BMessage report(MSG_SCAN_DONE);
+  auto totalElapsed = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::steady_clock::now() - fStartTime)
+                          .count();
+  report.AddInt64("elapsed_sec", totalElapsed);
+  report.AddInt32("quarantined", fQuarantinedFiles);
+  report.AddInt32("skipped", fSkippedFiles);
+  for (const auto &[elapsed, path] : fSlowestFiles) {
+    report.AddString("slow_path", path);
+    report.AddInt64("slow_usec", elapsed);
+  }
+  report.AddString("base", fBasePath);
+  report.AddInt32("dirs", fScannedDirs);
+  report.AddInt64("throttled_usec", fThrottledTime);
+  fMetrics.AddTo(report);
+  WriteScanLog(report);
+
+  if (!fLiveTarget)
+    return;
+  fLiveTarget(report);
+
+  BMessage progress(MSG_SCAN_PROGRESS);
+  progress.AddInt32("dirs", fScannedDirs);
+  progress.AddInt32("files", fFoundFiles);
+  fMetrics.AddTo(progress);
+  fLiveTarget(progress);
+}
@@ -0,0 +1,399 @@
+#ifndef SCAN_ENGINE_H
+#define SCAN_ENGINE_H
+
+#include "MediaBatch.h"
+#include "MediaItem.h"
+#include "ScanFilter.h"
+#include "ScanMetrics.h"
+#include "TagData.h"
+
+#include <Locker.h>
+#include <Message.h>
+#include <OS.h>
+#include <String.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+class ScanIOGovernor;
+class TagParserPool;
+
+/**
+ * @class ScanEngine
+ * @brief Walks one scan root, reads the tags of the audio files below it and
+ * hands them out in batches.
+ *
+ * The scanner without the looper: Run() scans on the calling thread and
+ * reports through two SendFunc callbacks, with the same messages the
+ * MediaScanner sends its targets. It only uses POSIX and port/ calls, so it
+ * is part of libbeton-core and runs (and can be profiled and sanitized) on
+ * Linux as well.
+ *
+ * Supports incremental scanning by checking file modification times against
+ * a provided cache map.
+ *
+ * Batches are flushed adaptively: as soon as an item or byte budget is
+ * reached, or when the oldest buffered item has waited longer than a latency
+ * deadline (short for the very first batch so results show up quickly).
+ * Sending blocks while the consumer still has too many unprocessed batches
+ * queued (see SetBatchQueueCounter()).
+ *
+ * Within each directory, audio files are collected first and parsed in inode
+ * order, which on BFS follows the on-disk layout, so cold scans of spinning
+ * disks read mostly sequentially. Where the kernel acts on
+ * posix_fadvise() (not on Haiku), the tag area of the next few files is
+ * prefetched while the current one is parsed.
+ *
+ * Every directory and file is identified by its (device, inode) pair, so
+ * symlink or mount loops are walked only once and hard-linked files are
+ * parsed under the first path they are found at. Whether symbolic links are
+ * followed at all is configurable via SetFollowLinks().
+ *
+ * Directories excluded by the root's ScanFilter are never descended into,
+ * and files below its minimum size are never opened.
+ *
+ * With SetParserHelpers() and a pool factory, tags are read by a
+ * TagParserPool (helper processes on Haiku) instead of the scanning thread.
+ * Files that crash or hang a parser are reported with MSG_SCAN_FILE_FAILED
+ * and skipped by later scans until they change (see SetQuarantine()).
+ *
+ * In-process parsing happens on a separate parser thread, so the scan can
+ * give up on a file after kParseTimeout; the stuck thread is abandoned and
+ * the file quarantined like one that hung a helper. Once
+ * kMaxAbandonedParsers threads are stuck, further files go to a
+ * TagParserPool from the factory, or are skipped for this scan if there is
+ * none.
+ * Parse times are tracked
+ * and the kSlowestFiles slowest files are listed in the final MSG_SCAN_DONE.
+ *
+ * All file and directory reads are paced by a ScanIOGovernor shared with the
+ * other scans and the playback controller, which slows scans down while
+ * music plays. Its state is reported in every MSG_SCAN_PROGRESS.
+ *
+ * Progress messages also carry the ScanMetrics of the scan (rates, parse
+ * time histogram, queue depths and, once a low-priority pre-count of the
+ * tree has finished, an ETA). The final metrics are appended to the scan log
+ * (see kScanLogName).
+ *
+ * Long scans periodically flush their batch and send a MSG_SCAN_CHECKPOINT
+ * with the pending DFS stack. A checkpoint handed back via SetResumeState()
+ * lets the next scan continue where the previous one stopped instead of
+ * starting at the root.
+ */
+class ScanEngine {
+public:
+  /**
+   * @brief Receives a message of the scan, on the scanning thread.
+   * @return B_OK if the message was taken; for a MSG_MEDIA_BATCH anything
+   * else means it is not counted as queued.
+   */
+  typedef std::function<status_t(BMessage &msg)> SendFunc;
+
+  /**
+   * @brief Reads the tags of one file in-process.
+   * @param path Absolute path of the file.
+   * @param out Receives the tags; out.format decides whether it is audio.
+   */
+  typedef std::function<void(const BString &path, TagData &out)> ParseFunc;
+
+  /**
+   * @brief Creates the parsers SetParserHelpers() asks for.
+   * @param count Number of parsers.
+   * @param timeout Time a parser may spend on a single file.
+   * @return The pool, or null if none can be created on this platform.
+   */
+  typedef std::function<TagParserPool *(int32 count, bigtime_t timeout)>
+      PoolFactory;
+
+  /** @param root Root directory to scan, absolute. */
+  explicit ScanEngine(const char *root);
+  ~ScanEngine();
+
+  /** @brief The root directory, as passed to the constructor. */
+  const BString &Root() const { return fBasePath; }
+
+  /**
+   * @brief Sets where the results go.
+   * @param cache Receives MSG_MEDIA_BATCH, MSG_SCAN_FILE_FAILED,
+   * MSG_SCAN_CHECKPOINT and, once finished, MSG_SCAN_DONE with "base".
+   * @param live Receives MSG_SCAN_PROGRESS and the final MSG_SCAN_DONE with
+   * the full report. May be null.
+   */
+  void SetTargets(const SendFunc &cache, const SendFunc &live) {
+    fCacheTarget = cache;
+    fLiveTarget = live;
+  }
+
+  /**
+   * @brief Sets how files are parsed in-process.
+   *
+   * The default reads MP3 and FLAC with FastTagReader, without TagLib.
+   */
+  void SetParser(const ParseFunc &parse) { fParse = parse; }
+
+  /**
+   * @brief Pre-loads the cache to enable incremental scanning.
+   * @param cache Map of existing file paths to MediaItems.
+   */
+  void SetCache(const std::map<BString, MediaItem> &cache) { fCache = cache; }
+
+  /**
+   * @brief Shares the consumer's count of queued, unprocessed batches.
+   *
+   * The engine increments it for every batch it sends and holds back new
+   * batches while it is at or above kMaxQueuedBatches.
+   * @param counter Counter owned jointly with the consumer, which decrements
+   * it for every batch it has stored.
+   */
+  void SetBatchQueueCounter(std::shared_ptr<std::atomic<int32>> counter) {
+    fQueuedBatches = counter;
+  }
+
+  /**
+   * @brief Resumes traversal from a previously persisted checkpoint.
+   *
+   * Must be called before Run(). The directories visited before the
+   * checkpoint are not entered again, which keeps link loops closed across
+   * the restart.
+   * @param checkpoint A MSG_SCAN_CHECKPOINT message sent by an earlier scan of
+   * the same root.
+   */
+  void SetResumeState(const BMessage &checkpoint);
+
+  /**
+   * @brief Sets whether symbolic links below the root are followed.
+   *
+   * Links are followed by default; the root directory itself is always
+   * resolved.
+   */
+  void SetFollowLinks(bool follow) { fFollowLinks = follow; }
+
+  /** @brief Sets the exclude patterns and size/duration minimums. */
+  void SetFilter(const ScanFilter &filter) { fFilter = filter; }
+
+  /**
+   * @brief Parses tags in @p count parsers made by @p factory.
+   *
+   * 0 (the default) parses on the parser thread, which is also the fallback
+   * if the factory cannot start any.
+   */
+  void SetParserHelpers(int32 count, const PoolFactory &factory) {
+    fParserHelpers = count;
+    fPoolFactory = factory;
+  }
+
+  /**
+   * @brief Sets the files that crashed or hung the parser in earlier scans.
+   * @param files Quarantined files keyed by path.
+   */
+  void SetQuarantine(const std::map<BString, QuarantinedFile> &files) {
+    fQuarantine = files;
+  }
+
+  /**
+   * @brief Sets the I/O budget this scan draws from.
+   *
+   * Without one, reads are not paced.
+   */
+  void SetIOGovernor(std::shared_ptr<ScanIOGovernor> governor) {
+    fIOGovernor = governor;
+  }
+
+  /**
+   * @brief Scans the root (or what a checkpoint left of it).
+   *
+   * Returns when the scan is done or Stop() was called; a stopped scan
+   * sends no MSG_SCAN_DONE.
+   * @return B_OK, or B_CANCELED if the scan was stopped.
+   */
+  status_t Run();
+
+  /** @brief Makes Run() return soon. Safe to call from any thread. */
+  void Stop() { fStopRequested = true; }
+
+  /** @brief Minimum time between two checkpoints of a running scan. */
+  static constexpr int64 kCheckpointIntervalSec = 30;
+
+  /** @brief Time a single file may take to parse before it is given up. */
+  static constexpr bigtime_t kParseTimeout = 20000000;
+
+  /**
+   * @brief Abandoned parser threads that may still be stuck in a read
+   * before no new one is started.
+   */
+  static constexpr size_t kMaxAbandonedParsers = 4;
+
+  /** @brief Number of slowest files listed in the scan report. */
+  static constexpr size_t kSlowestFiles = 10;
+
+  /** @brief Name of the scan report file in the user log directory. */
+  static constexpr const char *kScanLogName = "BeTon-scan.log";
+
+  /** @brief Size beyond which the scan log is started over. */
+  static constexpr off_t kMaxScanLogSize = 256 * 1024;
+
+  /**
+   * @brief Number of upcoming files to prefetch; 0 disables readahead.
+   *
+   * Haiku's posix_fadvise() accepts the hint but does nothing with it, so
+   * there the extra open() per file is not spent.
+   */
+#ifdef __HAIKU__
+  static constexpr size_t kReadaheadFiles = 0;
+#else
+  static constexpr size_t kReadaheadFiles = 4;
+#endif
+
+  /** @name Batch Flush Policy */
+  ///@{
+  static constexpr int64 kFirstBatchLatencyMs = 100;
+  static constexpr int64 kBatchLatencyMs = 750;
+  static constexpr int32 kMaxQueuedBatches = 4;
+  ///@}
+
+  ScanEngine(const ScanEngine &) = delete;
+  ScanEngine &operator=(const ScanEngine &) = delete;
+
+private:
+  /**
+   * @struct PendingFile
+   * @brief An audio file of the current directory, waiting to be parsed.
+   */
+  struct PendingFile {
+    BString path;
+    struct stat st;
+  };
+
+  /// Identity of a node across all mounted volumes: (device, inode).
+  typedef std::pair<dev_t, ino_t> NodeId;
+
+  static bool IsInDirectory(const BString &path, const BString &dir);
+  bool IsUnchanged(const BString &path, const struct stat &st) const;
+  bool IsQuarantined(const BString &path, const struct stat &st) const;
+  void ScanDirectory(const BString &path, std::vector<BString> &stack);
+  void ProcessFile(const PendingFile &file);
+  void ParseInProcess(const PendingFile &file);
+  status_t ParseWithDeadline(const PendingFile &file, TagData &td);
+  void StopParser();
+  void ReapParsers();
+  bool StartFallbackPool();
+  void RecordParseTime(const BString &path, bigtime_t elapsed);
+  bool ParseInSandbox(const PendingFile &file);
+  bool CollectSandboxResult(bigtime_t timeout);
+  void DrainSandbox();
+  void AddParsedFile(const PendingFile &file, TagData &td);
+  void ReportBadFile(const PendingFile &file, const char *reason);
+  void Readahead(const PendingFile &file) const;
+  void WaitForIOBudget(off_t bytes, int32 ops);
+  void FlushBatch();
+  void FlushBatchIfDue();
+  void WaitForCacheQueue();
+  void ReportProgress();
+  void SendCheckpoint(const std::vector<BString> &pending);
+  void SendDone();
+  void WriteScanLog(const BMessage &report) const;
+
+  /// State shared with the in-process parser thread.
+  struct ParserState;
+
+  static status_t ParserEntry(void *data);
+  static status_t CountEntry(void *data);
+  void CountFiles();
+
+  /** @name Configuration & Messaging */
+  ///@{
+  BString fBasePath;
+  SendFunc fCacheTarget;
+  SendFunc fLiveTarget;
+  ParseFunc fParse;
+  bool fFollowLinks;
+  ScanFilter fFilter;
+  ///@}
+
+  /** @name Data */
+  ///@{
+  std::map<BString, MediaItem> fCache;
+  /// Items are encoded as they are parsed. The writer keeps its buffers
+  /// between batches, so steady-state batching does not allocate.
+  MediaBatchWriter fBatch;
+  BLocker fBatchLock;
+  ///@}
+
+  /** @name Traversal */
+  ///@{
+  std::set<NodeId> fVisitedDirs;
+  std::set<NodeId> fSeenFiles;
+  ///@}
+
+  /** @name Adaptive Batching */
+  ///@{
+  std::chrono::steady_clock::time_point fBatchDeadline;
+  int32 fBatchesSent;
+  std::shared_ptr<std::atomic<int32>> fQueuedBatches;
+  ///@}
+
+  /** @name Checkpointing */
+  ///@{
+  std::vector<BString> fResumeStack;
+  std::set<NodeId> fResumeVisited;
+  int32 fResumeDirs;
+  int32 fResumeFiles;
+  std::chrono::steady_clock::time_point fLastCheckpoint;
+  ///@}
+
+  /** @name Sandboxed Parsing */
+  ///@{
+  int32 fParserHelpers;
+  PoolFactory fPoolFactory;
+  std::unique_ptr<TagParserPool> fSandbox;
+  std::map<int32, PendingFile> fSandboxFiles; ///< Submitted, keyed by id.
+  int32 fNextSandboxId;
+  std::map<BString, QuarantinedFile> fQuarantine;
+  ///@}
+
+  /** @name Parse Deadlines */
+  ///@{
+  std::shared_ptr<ParserState> fParser;
+  /// Parser threads given up on, until they have exited and been waited for.
+  std::vector<std::shared_ptr<ParserState>> fAbandonedParsers;
+  bool fTriedFallbackPool;
+  /// Slowest files of this scan, slowest first: (parse time, path).
+  std::vector<std::pair<bigtime_t, BString>> fSlowestFiles;
+  int32 fQuarantinedFiles;
+  /// Files left unparsed because every parser was stuck; not quarantined.
+  int32 fSkippedFiles;
+  ///@}
+
+  /** @name I/O Budget */
+  ///@{
+  std::shared_ptr<ScanIOGovernor> fIOGovernor;
+  bigtime_t fThrottledTime; ///< Total time spent waiting for the budget.
+  ///@}
+
+  /** @name Metrics */
+  ///@{
+  ScanMetrics fMetrics;
+  int32 fPendingDirs;  ///< DFS stack size.
+  int32 fPendingFiles; ///< Files of the current directory not yet processed.
+  std::vector<BString> fCountRoots; ///< Where the pre-count starts.
+  thread_id fCountThread;
+  std::atomic<bool> fCountStop;
+  ///@}
+
+  /** @name Progress Tracking */
+  ///@{
+  std::atomic<bool> fStopRequested;
+  std::atomic<int> fScannedDirs;
+  std::atomic<int> fFoundFiles;
+  std::chrono::steady_clock::time_point fLastUpdate;
+  std::chrono::steady_clock::time_point fStartTime;
+  ///@}
+};
+
+#endif // SCAN_ENGINE_H
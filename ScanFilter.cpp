@@ -0,0 +1,173 @@
+#include "ScanFilter.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+void GlobSet::Add(const BString &pattern) {
+  BString lower(pattern);
+  lower.ToLower();
+  if (lower.IsEmpty())
+    return;
+
+  const bool hasStar = lower.FindFirst('*') >= 0;
+  const bool hasQuestion = lower.FindFirst('?') >= 0;
+
+  if (!hasStar && !hasQuestion) {
+    fLiterals.insert(lower);
+    return;
+  }
+
+  // "prefix*" with no other wildcard
+  if (!hasQuestion && lower.FindFirst('*') == lower.Length() - 1) {
+    int32 node = 0;
+    for (int32 i = 0; i < lower.Length() - 1; i++) {
+      char c = lower[i];
+      auto it = fTrie[node].children.find(c);
+      if (it == fTrie[node].children.end()) {
+        fTrie.push_back(TrieNode());
+        int32 child = (int32)fTrie.size() - 1;
+        fTrie[node].children[c] = child;
+        node = child;
+      } else {
+        node = it->second;
+      }
+    }
+    fTrie[node].terminal = true;
+    return;
+  }
+
+  std::vector<Token> glob;
+  for (int32 i = 0; i < lower.Length(); i++) {
+    char c = lower[i];
+    if (c == '*') {
+      // Consecutive stars are one
+      if (glob.empty() || glob.back().kind != Token::kAnyRun)
+        glob.push_back({Token::kAnyRun, ""});
+    } else if (c == '?') {
+      glob.push_back({Token::kAnyChar, ""});
+    } else if (!glob.empty() && glob.back().kind == Token::kLiteral) {
+      glob.back().text << c;
+    } else {
+      glob.push_back({Token::kLiteral, BString(lower.String() + i, 1)});
+    }
+  }
+  fGlobs.push_back(glob);
+}
+
+/**
+ * @brief Matches a compiled glob against a lowercased name.
+ *
+ * Iterative with a single backtrack point (the most recent `*`), so the cost
+ * stays linear in practice.
+ */
+bool GlobSet::_MatchGlob(const std::vector<Token> &glob, const char *name) {
+  size_t token = 0;
+  const char *p = name;
+  size_t starToken = SIZE_MAX;
+  const char *starPos = nullptr;
+
+  while (true) {
+    if (token < glob.size()) {
+      const Token &t = glob[token];
+      if (t.kind == Token::kAnyRun) {
+        starToken = token++;
+        starPos = p;
+        continue;
+      }
+      if (t.kind == Token::kAnyChar && *p) {
+        token++;
+        p++;
+        continue;
+      }
+      if (t.kind == Token::kLiteral &&
+          strncmp(p, t.text.String(), t.text.Length()) == 0) {
+        token++;
+        p += t.text.Length();
+        continue;
+      }
+    } else if (*p == '\0') {
+      return true;
+    }
+
+    // Mismatch: let the last star swallow one more character
+    if (starToken == SIZE_MAX || *starPos == '\0')
+      return false;
+    token = starToken + 1;
+    p = ++starPos;
+  }
+}
+
+bool GlobSet::Matches(const char *name) const {
+  BString lower(name);
+  lower.ToLower();
+
+  if (fLiterals.find(lower) != fLiterals.end())
+    return true;
+
+  int32 node = 0;
+  for (const char *p = lower.String();; p++) {
+    if (fTrie[node].terminal)
+      return true;
+    if (*p == '\0')
+      break;
+    auto it = fTrie[node].children.find(*p);
+    if (it == fTrie[node].children.end())
+      break;
+    node = it->second;
+  }
+
+  for (const auto &glob : fGlobs) {
+    if (_MatchGlob(glob, lower.String()))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Parses a size such as "512", "64K" or "2M" into bytes.
+ */
+static off_t ParseSize(const char *s) {
+  char *end = nullptr;
+  off_t value = strtoll(s, &end, 10);
+  switch (toupper(*end)) {
+  case 'K':
+    value *= 1024;
+    break;
+  case 'M':
+    value *= 1024 * 1024;
+    break;
+  case 'G':
+    value *= 1024 * 1024 * 1024LL;
+    break;
+  }
+  return value;
+}
+
+bool ScanFilter::ParseOption(const BString &line) {
+  int32 split = line.FindFirst(' ');
+  if (split < 0)
+    split = line.FindFirst('\t');
+  if (split < 0)
+    return false;
+
+  BString key, value;
+  line.CopyInto(key, 0, split);
+  line.CopyInto(value, split + 1, line.Length() - split - 1);
+  value.Trim();
+  if (value.IsEmpty())
+    return false;
+
+  if (key == "exclude")
+    fExclude.Add(value);
+  else if (key == "include")
+    fInclude.Add(value);
+  else if (key == "min-size")
+    fMinSize = ParseSize(value.String());
+  else if (key == "min-duration")
+    fMinDuration = (uint32)atoi(value.String());
+  else
+    return false;
+
+  return true;
+}
@@ -0,0 +1,109 @@
+#ifndef SCAN_FILTER_H
+#define SCAN_FILTER_H
+
+#include <String.h>
+#include <SupportDefs.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * @class GlobSet
+ * @brief A set of glob patterns compiled for matching many names quickly.
+ *
+ * Patterns support `*` (any run of characters) and `?` (any one character)
+ * and match case-insensitively against a whole name. They are sorted into
+ * three buckets when added:
+ * - plain literals (`@eaDir`) go into an ordered set,
+ * - pure prefixes (`_incomplete*`) go into a prefix trie,
+ * - everything else is compiled into a token list.
+ *
+ * A name is therefore checked with one set lookup, one walk of the trie and
+ * only the few remaining real globs.
+ */
+class GlobSet {
+public:
+  /** @brief Compiles @p pattern and adds it to the set. */
+  void Add(const BString &pattern);
+
+  /** @brief True if @p name matches any pattern. */
+  bool Matches(const char *name) const;
+
+  bool IsEmpty() const {
+    return fLiterals.empty() && fTrie.size() <= 1 && !fTrie[0].terminal &&
+           fGlobs.empty();
+  }
+
+private:
+  /**
+   * @struct Token
+   * @brief One element of a compiled glob.
+   */
+  struct Token {
+    enum Kind { kLiteral, kAnyChar, kAnyRun } kind;
+    BString text; ///< Lowercased text of a kLiteral token.
+  };
+
+  /**
+   * @struct TrieNode
+   * @brief Node of the prefix trie; children are indices into fTrie.
+   */
+  struct TrieNode {
+    std::map<char, int32> children;
+    bool terminal = false;
+  };
+
+  static bool _MatchGlob(const std::vector<Token> &glob, const char *name);
+
+  std::set<BString> fLiterals;
+  std::vector<TrieNode> fTrie{TrieNode()}; ///< fTrie[0] is the root.
+  std::vector<std::vector<Token>> fGlobs;
+};
+
+/**
+ * @class ScanFilter
+ * @brief Per-root rules deciding what the MediaScanner skips.
+ *
+ * Configured by indented option lines below a folder in directories.txt:
+ *
+ *     /boot/home/music
+ *         exclude @eaDir
+ *         exclude _incomplete*
+ *         include Artwork Scans
+ *         min-size 64K
+ *         min-duration 10
+ *
+ * Directories whose name matches an exclude pattern, and no include pattern,
+ * are not descended into. Files smaller than min-size are not parsed, and
+ * files shorter than min-duration seconds are left out of the library.
+ */
+class ScanFilter {
+public:
+  /**
+   * @brief Applies one option line (without indentation).
+   * @return false if the line is not a known option.
+   */
+  bool ParseOption(const BString &line);
+
+  /** @brief True if the directory @p name must not be scanned. */
+  bool SkipDirectory(const char *name) const {
+    return fExclude.Matches(name) && !fInclude.Matches(name);
+  }
+
+  /** @brief True if a file of @p size bytes is too small to be parsed. */
+  bool SkipSize(off_t size) const { return size < fMinSize; }
+
+  /** @brief True if a track of @p seconds is too short for the library. */
+  bool SkipDuration(uint32 seconds) const {
+    return seconds > 0 && seconds < fMinDuration;
+  }
+
+private:
+  GlobSet fExclude;
+  GlobSet fInclude;
+  off_t fMinSize = 0;
+  uint32 fMinDuration = 0;
+};
+
+#endif // SCAN_FILTER_H
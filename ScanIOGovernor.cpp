@@ -0,0 +1,87 @@
+#include "ScanIOGovernor.h"
+
+#include <Autolock.h>
+#include <algorithm>
+
+ScanIOGovernor::ScanIOGovernor()
+    : fBytesPerSec(0), fOpsPerSec(0), fNextByte(0), fNextOp(0),
+      fLastPlaybackRead(0), fLastSlowRead(0) {}
+
+void ScanIOGovernor::SetLimits(int64 bytesPerSec, int32 opsPerSec) {
+  BAutolock lock(fLock);
+  fBytesPerSec = std::max<int64>(bytesPerSec, 0);
+  fOpsPerSec = std::max<int32>(opsPerSec, 0);
+}
+
+/**
+ * @brief Charges @p cost to one rate limit (generic cell rate algorithm).
+ * @return Time until the charged amount is within the burst allowance.
+ */
+bigtime_t ScanIOGovernor::_Take(bigtime_t &theoretical, bigtime_t now,
+                                bigtime_t cost) {
+  bigtime_t start = std::max(theoretical, now);
+  theoretical = start + cost;
+  return std::max<bigtime_t>(0, theoretical - now - kBurstTime);
+}
+
+bigtime_t ScanIOGovernor::Reserve(off_t bytes, int32 ops) {
+  BAutolock lock(fLock);
+  bigtime_t now = system_time();
+
+  int64 bytesPerSec = fBytesPerSec;
+  int32 opsPerSec = fOpsPerSec;
+  switch (_CurrentState(now)) {
+  case kStarved:
+    bytesPerSec = kStarvedBytesPerSec;
+    opsPerSec = kStarvedOpsPerSec;
+    break;
+  case kPlayback:
+    if (bytesPerSec == 0 || bytesPerSec > kPlaybackBytesPerSec)
+      bytesPerSec = kPlaybackBytesPerSec;
+    if (opsPerSec == 0 || opsPerSec > kPlaybackOpsPerSec)
+      opsPerSec = kPlaybackOpsPerSec;
+    break;
+  default:
+    break;
+  }
+
+  bigtime_t wait = 0;
+  if (bytesPerSec > 0)
+    wait = _Take(fNextByte, now, bytes * 1000000 / bytesPerSec);
+  else
+    fNextByte = now;
+
+  if (opsPerSec > 0)
+    wait = std::max(wait, _Take(fNextOp, now, ops * 1000000LL / opsPerSec));
+  else
+    fNextOp = now;
+
+  return wait;
+}
+
+void ScanIOGovernor::NotePlaybackRead(bigtime_t readTime,
+                                      bigtime_t bufferTime) {
+  bigtime_t now = system_time();
+  fLastPlaybackRead.store(now, std::memory_order_relaxed);
+  if (readTime * 100 > bufferTime * kSlowReadPercent)
+    fLastSlowRead.store(now, std::memory_order_relaxed);
+}
+
+ScanIOGovernor::State ScanIOGovernor::CurrentState() const {
+  BAutolock lock(fLock);
+  return _CurrentState(system_time());
+}
+
+ScanIOGovernor::State ScanIOGovernor::_CurrentState(bigtime_t now) const {
+  bigtime_t slow = fLastSlowRead.load(std::memory_order_relaxed);
+  if (slow != 0 && now - slow < kStarvedHoldoff)
+    return kStarved;
+
+  bigtime_t played = fLastPlaybackRead.load(std::memory_order_relaxed);
+  if (played != 0 && now - played < kPlaybackHoldoff)
+    return kPlayback;
+
+  if (fBytesPerSec > 0 || fOpsPerSec > 0)
+    return kLimited;
+  return kUnthrottled;
+}
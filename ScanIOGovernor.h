@@ -0,0 +1,98 @@
+#ifndef SCAN_IO_GOVERNOR_H
+#define SCAN_IO_GOVERNOR_H
+
+#include <Locker.h>
+#include <OS.h>
+#include <SupportDefs.h>
+#include <atomic>
+
+/**
+ * @class ScanIOGovernor
+ * @brief Shared I/O budget of all running scanners.
+ *
+ * Scanners reserve the bytes and operations they are about to read with
+ * Reserve() and wait for the returned time. The budget is a pair of rate
+ * limits (bytes/s and IOPS), each allowing a short burst:
+ * - the limits from 'scan.settings' apply at all times (0 = unlimited),
+ * - while music plays they drop to kPlaybackBytesPerSec/kPlaybackOpsPerSec,
+ * - after the audio thread needed too long to decode a buffer they drop to
+ *   kStarvedBytesPerSec/kStarvedOpsPerSec for kStarvedHoldoff.
+ *
+ * The playback side only calls NotePlaybackRead(), which touches nothing but
+ * atomics and is safe to use from the real-time audio callback.
+ */
+class ScanIOGovernor {
+public:
+  /** @brief Why (and whether) scans are currently slowed down. */
+  enum State {
+    kUnthrottled = 0, ///< No limit applies.
+    kLimited,         ///< The configured limits apply.
+    kPlayback,        ///< Music is playing.
+    kStarved          ///< Playback recently came close to a dropout.
+  };
+
+  ScanIOGovernor();
+
+  /**
+   * @brief Sets the limits that apply while nothing is playing.
+   * @param bytesPerSec Maximum read rate, 0 for unlimited.
+   * @param opsPerSec Maximum number of file operations per second, 0 for
+   * unlimited.
+   */
+  void SetLimits(int64 bytesPerSec, int32 opsPerSec);
+
+  /**
+   * @brief Reserves budget for an upcoming read.
+   * @param bytes Bytes that will be read.
+   * @param ops File operations (open, read, directory listing) involved.
+   * @return Time in microseconds the caller has to wait before reading.
+   */
+  bigtime_t Reserve(off_t bytes, int32 ops);
+
+  /**
+   * @brief Reports one decoded playback buffer.
+   *
+   * Called from the audio callback.
+   * @param readTime Time the decoder took to fill the buffer.
+   * @param bufferTime Playing time of the buffer.
+   */
+  void NotePlaybackRead(bigtime_t readTime, bigtime_t bufferTime);
+
+  State CurrentState() const;
+
+  /** @name Playback Limits */
+  ///@{
+  static constexpr int64 kPlaybackBytesPerSec = 4 * 1024 * 1024;
+  static constexpr int32 kPlaybackOpsPerSec = 60;
+  static constexpr int64 kStarvedBytesPerSec = 256 * 1024;
+  static constexpr int32 kStarvedOpsPerSec = 8;
+  /// Time playback counts as active after the last decoded buffer.
+  static constexpr bigtime_t kPlaybackHoldoff = 1000000;
+  /// Time the starved limits apply after a slow decode.
+  static constexpr bigtime_t kStarvedHoldoff = 5000000;
+  /// Share of a buffer's playing time a decode may take before it counts as
+  /// slow, in percent.
+  static constexpr int32 kSlowReadPercent = 50;
+  ///@}
+
+  /** @brief Reads within this much budget pass without waiting. */
+  static constexpr bigtime_t kBurstTime = 100000;
+
+private:
+  State _CurrentState(bigtime_t now) const;
+  static bigtime_t _Take(bigtime_t &theoretical, bigtime_t now,
+                         bigtime_t cost);
+
+  mutable BLocker fLock;
+  int64 fBytesPerSec;
+  int32 fOpsPerSec;
+
+  /// Theoretical arrival times of the next byte and operation (GCRA).
+  bigtime_t fNextByte;
+  bigtime_t fNextOp;
+
+  std::atomic<bigtime_t> fLastPlaybackRead;
+  std::atomic<bigtime_t> fLastSlowRead;
+};
+
+#endif // SCAN_IO_GOVERNOR_H
@@ -0,0 +1,121 @@
+#include "ScanMetrics.h"
+#include "MetricsRegistry.h"
+
+#include <algorithm>
+
+void ScanMetrics::Start() {
+  fStart = system_time();
+  fParsed = 0;
+  fSkipped = 0;
+  fOther = 0;
+  fBytes = 0;
+  for (int32 &count : fHistogram)
+    count = 0;
+  fQueues = QueueDepths();
+  fPeakQueues = QueueDepths();
+  fTotal.store(-1);
+}
+
+bigtime_t ScanMetrics::BucketLimit(int32 bucket) {
+  if (bucket >= kHistogramBuckets - 1)
+    return B_INFINITE_TIMEOUT;
+  return 1000LL << bucket;
+}
+
+void ScanMetrics::AddParsed(bigtime_t parseTime) {
+  static MetricHistogram *sParseTime =
+      MetricsRegistry::Default().Histogram("scan.parse", "us");
+  sParseTime->Record(parseTime);
+  fParsed++;
+
+  int32 bucket = 0;
+  while (parseTime >= BucketLimit(bucket))
+    bucket++;
+  fHistogram[bucket]++;
+}
+
+void ScanMetrics::SetQueueDepths(const QueueDepths &depths) {
+  fQueues = depths;
+  fPeakQueues.dirs = std::max(fPeakQueues.dirs, depths.dirs);
+  fPeakQueues.files = std::max(fPeakQueues.files, depths.files);
+  fPeakQueues.helpers = std::max(fPeakQueues.helpers, depths.helpers);
+  fPeakQueues.batch = std::max(fPeakQueues.batch, depths.batch);
+  fPeakQueues.cache = std::max(fPeakQueues.cache, depths.cache);
+}
+
+void ScanMetrics::AddTo(BMessage &msg) const {
+  const float seconds = (system_time() - fStart) / 1000000.0f;
+  const int32 examined = Examined();
+
+  msg.AddInt32("examined", examined);
+  msg.AddInt32("parsed", fParsed);
+  msg.AddInt32("skipped", fSkipped);
+  msg.AddFloat("files_per_sec", seconds > 0 ? examined / seconds : 0);
+  msg.AddFloat("mb_per_sec",
+               seconds > 0 ? fBytes / (1024.0f * 1024.0f) / seconds : 0);
+  for (int32 count : fHistogram)
+    msg.AddInt32("parse_hist", count);
+
+  msg.AddInt32("queue_dirs", fQueues.dirs);
+  msg.AddInt32("queue_files", fQueues.files);
+  msg.AddInt32("queue_helpers", fQueues.helpers);
+  msg.AddInt32("queue_batch", fQueues.batch);
+  msg.AddInt32("queue_cache", fQueues.cache);
+  msg.AddInt32("peak_queue_dirs", fPeakQueues.dirs);
+  msg.AddInt32("peak_queue_files", fPeakQueues.files);
+  msg.AddInt32("peak_queue_helpers", fPeakQueues.helpers);
+  msg.AddInt32("peak_queue_batch", fPeakQueues.batch);
+  msg.AddInt32("peak_queue_cache", fPeakQueues.cache);
+
+  // The estimate needs the pre-count and a few seconds of history
+  const int32 total = fTotal.load();
+  if (total >= 0) {
+    msg.AddInt32("total", total);
+    if (examined > 0 && seconds >= 2) {
+      int32 left = total > examined ? total - examined : 0;
+      msg.AddInt64("eta_sec", (int64)(left * seconds / examined));
+    }
+  }
+}
+
+BString ScanMetrics::Describe(const BMessage &msg) {
+  BString report;
+  const int32 parsed = msg.GetInt32("parsed", 0);
+  const int32 skipped = msg.GetInt32("skipped", 0);
+
+  report.SetToFormat(
+      "  %d files examined: %d parsed, %d unchanged (%.1f%% skipped)\n",
+      (int)msg.GetInt32("examined", 0), (int)parsed, (int)skipped,
+      parsed + skipped > 0 ? 100.0 * skipped / (parsed + skipped) : 0.0);
+
+  BString line;
+  line.SetToFormat("  %.1f files/s, %.2f MB/s\n",
+                   msg.GetFloat("files_per_sec", 0),
+                   msg.GetFloat("mb_per_sec", 0));
+  report << line;
+
+  report << "  Parse times:";
+  for (int32 i = 0; i < kHistogramBuckets; i++) {
+    int32 count = msg.GetInt32("parse_hist", i, 0);
+    if (count == 0)
+      continue;
+    if (i == kHistogramBuckets - 1)
+      line.SetToFormat(" >=%lldms: %d", (long long)BucketLimit(i - 1) / 1000,
+                       (int)count);
+    else
+      line.SetToFormat(" <%lldms: %d", (long long)BucketLimit(i) / 1000,
+                       (int)count);
+    report << line;
+  }
+  report << "\n";
+
+  line.SetToFormat("  Peak queues: %d dirs, %d files, %d in helpers, "
+                   "%d in batch, %d batches in cache\n",
+                   (int)msg.GetInt32("peak_queue_dirs", 0),
+                   (int)msg.GetInt32("peak_queue_files", 0),
+                   (int)msg.GetInt32("peak_queue_helpers", 0),
+                   (int)msg.GetInt32("peak_queue_batch", 0),
+                   (int)msg.GetInt32("peak_queue_cache", 0));
+  report << line;
+  return report;
+}
@@ -0,0 +1,93 @@
+#ifndef SCAN_METRICS_H
+#define SCAN_METRICS_H
+
+#include <Message.h>
+#include <OS.h>
+#include <String.h>
+#include <SupportDefs.h>
+#include <atomic>
+
+/**
+ * @class ScanMetrics
+ * @brief Throughput counters of one running scan.
+ *
+ * Updated by the scanner's worker thread, except for the total file count,
+ * which the pre-count thread sets once it has walked the tree. AddTo()
+ * stores a snapshot in MSG_SCAN_PROGRESS/MSG_SCAN_DONE:
+ *
+ * | Field            | Type    | Meaning                                  |
+ * |------------------|---------|------------------------------------------|
+ * | examined         | int32   | Candidate files handled so far           |
+ * | parsed           | int32   | Files whose tags were read               |
+ * | skipped          | int32   | Files unchanged since the last scan      |
+ * | files_per_sec    | float   | Examined files per second                |
+ * | mb_per_sec       | float   | MB of tag data read per second           |
+ * | parse_hist       | int32[] | Parse times, see BucketLimit()           |
+ * | queue_dirs       | int32   | Directories waiting to be listed         |
+ * | queue_files      | int32   | Files of the current directory left      |
+ * | queue_helpers    | int32   | Files handed to parser helpers           |
+ * | queue_batch      | int32   | Items waiting for the next batch         |
+ * | queue_cache      | int32   | Batches waiting in the CacheManager      |
+ * | peak_queue_*     | int32   | Highest value of each queue_* so far     |
+ * | total            | int32   | Pre-counted candidate files (if known)   |
+ * | eta_sec          | int64   | Estimated time left (if known)           |
+ */
+class ScanMetrics {
+public:
+  /** @brief Number of parse time buckets; each doubles the previous limit. */
+  static constexpr int32 kHistogramBuckets = 12;
+
+  /**
+   * @struct QueueDepths
+   * @brief Work waiting in each stage of the scan pipeline.
+   */
+  struct QueueDepths {
+    int32 dirs = 0;
+    int32 files = 0;
+    int32 helpers = 0;
+    int32 batch = 0;
+    int32 cache = 0;
+  };
+
+  /** @brief Resets all counters and starts the clock. */
+  void Start();
+
+  void AddParsed(bigtime_t parseTime);
+  void AddSkipped() { fSkipped++; }
+  void AddOther() { fOther++; }
+  void AddBytes(off_t bytes) { fBytes += bytes; }
+  void SetQueueDepths(const QueueDepths &depths);
+
+  /** @brief Sets the result of the pre-count; safe from any thread. */
+  void SetTotal(int32 files) { fTotal.store(files); }
+
+  int32 Examined() const { return fParsed + fSkipped + fOther; }
+
+  /** @brief Adds a snapshot of the counters to @p msg (see the table). */
+  void AddTo(BMessage &msg) const;
+
+  /**
+   * @brief Upper limit of a parse time bucket in microseconds.
+   * @return The limit, or B_INFINITE_TIMEOUT for the last bucket.
+   */
+  static bigtime_t BucketLimit(int32 bucket);
+
+  /**
+   * @brief Formats the metrics in @p msg as a multi-line report for the scan
+   * log.
+   */
+  static BString Describe(const BMessage &msg);
+
+private:
+  bigtime_t fStart = 0;
+  int32 fParsed = 0;
+  int32 fSkipped = 0;
+  int32 fOther = 0; ///< Quarantined or rejected before parsing.
+  off_t fBytes = 0;
+  int32 fHistogram[kHistogramBuckets] = {};
+  QueueDepths fQueues;
+  QueueDepths fPeakQueues;
+  std::atomic<int32> fTotal{-1};
+};
+
+#endif // SCAN_METRICS_H
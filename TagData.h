@@ -0,0 +1,65 @@
+#ifndef TAG_DATA_H
+#define TAG_DATA_H
+
+#include "FormatDetector.h"
+
+#include <String.h>
+#include <SupportDefs.h>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct TagData
+ * @brief Holds metadata read from or written to audio files.
+ */
+struct TagData {
+  BString title, artist, album, genre, comment;
+
+  uint32 year = 0;
+  uint32 track = 0;
+  BString albumArtist;
+  BString composer;
+  uint32 trackTotal = 0;
+  uint32 disc = 0;
+  uint32 discTotal = 0;
+
+  uint32 lengthSec = 0;
+  uint32 bitrate = 0;
+  uint32 sampleRate = 0;
+  uint32 channels = 0;
+
+  BString mbAlbumID, mbArtistID, mbTrackID;
+  BString acoustId, acoustIdFp;
+
+  AudioFormat format; ///< Detected container and codec.
+};
+
+/**
+ * @struct CoverBlob
+ * @brief Simple container for binary cover art data.
+ */
+struct CoverBlob {
+  std::vector<uint8_t> bytes;
+
+  void clear() { bytes.clear(); }
+  void assign(const void *p, size_t n) {
+    const auto *b = static_cast<const uint8_t *>(p);
+    bytes.assign(b, b + n);
+  }
+  const void *data() const { return bytes.empty() ? nullptr : bytes.data(); }
+  size_t size() const { return bytes.size(); }
+};
+
+/**
+ * @struct CoverInfo
+ * @brief Describes the first embedded picture of a file, without its data.
+ */
+struct CoverInfo {
+  bool present = false;
+  uint64 offset = 0; ///< File offset of the image data, 0 if not known.
+  uint32 size = 0;   ///< Size of the image data in bytes.
+  BString mime;
+};
+
+#endif // TAG_DATA_H
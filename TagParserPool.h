@@ -0,0 +1,69 @@
+#ifndef TAG_PARSER_POOL_H
+#define TAG_PARSER_POOL_H
+
+#include "TagData.h"
+
+#include <OS.h>
+#include <String.h>
+#include <SupportDefs.h>
+
+/**
+ * @class TagParserPool
+ * @brief Parses tags outside the scanning thread, so that a file that
+ * crashes or hangs the parser only costs that file.
+ *
+ * The interface the ScanEngine submits files through. TagParserSandbox
+ * implements it with helper processes on Haiku.
+ */
+class TagParserPool {
+public:
+  /**
+   * @struct Result
+   * @brief Outcome of one submitted request.
+   */
+  struct Result {
+    int32 id = -1;
+    BString path;
+    /**
+     * B_OK if the file was parsed, B_TIMED_OUT if the parser hung,
+     * B_ERROR if it crashed, B_NO_INIT if no parser could be started and
+     * B_NO_MEMORY if the tags could not be handed back.
+     */
+    status_t status = B_ERROR;
+    bigtime_t elapsed = 0; ///< Time the parser spent on the file.
+    TagData tags;
+  };
+
+  /**
+   * @brief Number of parsers used when sandboxed parsing is enabled, or
+   * when in-process parsing has too many stuck threads.
+   */
+  static constexpr int32 kDefaultHelpers = 2;
+
+  virtual ~TagParserPool() = default;
+
+  /** @brief B_OK if at least one parser is running. */
+  virtual status_t InitCheck() const = 0;
+
+  /**
+   * @brief Queues a file on the least busy parser.
+   * @param id Caller-chosen id, handed back in the Result.
+   * @param path Absolute path of the file to parse.
+   * @return B_OK, B_WOULD_BLOCK if every queue is full (Collect() first),
+   * or another error if the file cannot be queued at all.
+   */
+  virtual status_t Submit(int32 id, const BString &path) = 0;
+
+  /** @brief Number of submitted requests that were not collected yet. */
+  virtual int32 CountPending() const = 0;
+
+  /**
+   * @brief Returns the next finished request.
+   * @param out Receives the result.
+   * @param timeout Maximum time to wait.
+   * @return false if nothing finished in time or nothing is pending.
+   */
+  virtual bool Collect(Result &out, bigtime_t timeout) = 0;
+};
+
+#endif // TAG_PARSER_POOL_H
@@ -0,0 +1,457 @@
+#include "TagParserSandbox.h"
+#include "Debug.h"
+
+#include <Message.h>
+#include <Path.h>
+#include <algorithm>
+#include <image.h>
+#include <string.h>
+#include <unistd.h>
+
+/** @brief Magic value at the start of every ring area ('TPSB'). */
+static const uint32 kRingMagic = 'TPSB';
+
+/** @brief How often the watchdog looks at the helpers while waiting. */
+static const bigtime_t kWatchdogInterval = 100000;
+
+enum SlotState { kSlotFree = 0, kSlotQueued, kSlotDone };
+
+/**
+ * @struct SandboxSlot
+ * @brief One request and, once the helper is done, its result.
+ */
+struct SandboxSlot {
+  int32 id;
+  int32 state; ///< SlotState, only changed atomically.
+  status_t status;
+  bigtime_t elapsed;
+  uint32 resultSize;
+  char path[B_PATH_NAME_LENGTH];
+  char result[TagParserSandbox::kResultBytes]; ///< Flattened BMessage.
+};
+
+/**
+ * @struct TagParserSandbox::Ring
+ * @brief Layout of the area shared between the host and one helper.
+ */
+struct TagParserSandbox::Ring {
+  uint32 magic;
+  sem_id requestSem; ///< Counts queued slots the helper has not taken yet.
+  sem_id resultSem;  ///< Shared by all helpers, released per finished slot.
+  int32 next;        ///< Slot the helper takes next.
+  int32 busySlot;    ///< Slot the helper is parsing, valid if busySince != 0.
+  int64 busySince;   ///< system_time() the helper started busySlot, or 0.
+  SandboxSlot slots[kSlotsPerHelper];
+};
+
+/**
+ * @brief Stores the fields the scanner needs in @p msg.
+ */
+static void _ArchiveTags(const TagData &td, BMessage &msg) {
+  msg.AddString("title", td.title);
+  msg.AddString("artist", td.artist);
+  msg.AddString("album", td.album);
+  msg.AddString("albumArtist", td.albumArtist);
+  msg.AddString("composer", td.composer);
+  msg.AddString("genre", td.genre);
+  msg.AddString("comment", td.comment);
+  msg.AddInt32("year", td.year);
+  msg.AddInt32("track", td.track);
+  msg.AddInt32("trackTotal", td.trackTotal);
+  msg.AddInt32("disc", td.disc);
+  msg.AddInt32("discTotal", td.discTotal);
+  msg.AddInt32("duration", td.lengthSec);
+  msg.AddInt32("bitrate", td.bitrate);
+  msg.AddInt32("sampleRate", td.sampleRate);
+  msg.AddInt32("channels", td.channels);
+  msg.AddString("mbAlbumID", td.mbAlbumID);
+  msg.AddString("mbArtistID", td.mbArtistID);
+  msg.AddString("mbTrackID", td.mbTrackID);
+  msg.AddInt32("container", (int32)td.format.container);
+  msg.AddInt32("codec", (int32)td.format.codec);
+}
+
+/**
+ * @brief Counterpart of _ArchiveTags().
+ */
+static void _UnarchiveTags(const BMessage &msg, TagData &td) {
+  td.title = msg.GetString("title", "");
+  td.artist = msg.GetString("artist", "");
+  td.album = msg.GetString("album", "");
+  td.albumArtist = msg.GetString("albumArtist", "");
+  td.composer = msg.GetString("composer", "");
+  td.genre = msg.GetString("genre", "");
+  td.comment = msg.GetString("comment", "");
+  td.year = msg.GetInt32("year", 0);
+  td.track = msg.GetInt32("track", 0);
+  td.trackTotal = msg.GetInt32("trackTotal", 0);
+  td.disc = msg.GetInt32("disc", 0);
+  td.discTotal = msg.GetInt32("discTotal", 0);
+  td.lengthSec = msg.GetInt32("duration", 0);
+  td.bitrate = msg.GetInt32("bitrate", 0);
+  td.sampleRate = msg.GetInt32("sampleRate", 0);
+  td.channels = msg.GetInt32("channels", 0);
+  td.mbAlbumID = msg.GetString("mbAlbumID", "");
+  td.mbArtistID = msg.GetString("mbArtistID", "");
+  td.mbTrackID = msg.GetString("mbTrackID", "");
+  td.format.container = (AudioContainer)msg.GetInt32("container", 0);
+  td.format.codec = (AudioCodec)msg.GetInt32("codec", 0);
+}
+
+/**
+ * @brief Finds the path of the running executable.
+ */
+static status_t _ExecutablePath(BString &out) {
+  image_info info;
+  int32 cookie = 0;
+  while (get_next_image_info(B_CURRENT_TEAM, &cookie, &info) == B_OK) {
+    if (info.type == B_APP_IMAGE) {
+      out = info.name;
+      return B_OK;
+    }
+  }
+  return B_ENTRY_NOT_FOUND;
+}
+
+/**
+ * @brief Constructor.
+ *
+ * Helpers that cannot be started are left out; InitCheck() fails only if
+ * none is running.
+ */
+TagParserSandbox::TagParserSandbox(int32 helperCount, bigtime_t timeout)
+    : fResultSem(-1), fTimeout(timeout), fInitStatus(B_NO_INIT) {
+  fResultSem = create_sem(0, "tag parser results");
+  if (fResultSem < 0) {
+    fInitStatus = fResultSem;
+    return;
+  }
+
+  for (int32 i = 0; i < helperCount; i++) {
+    Helper helper;
+    if (_CreateHelper(helper) == B_OK)
+      fHelpers.push_back(helper);
+  }
+
+  if (!fHelpers.empty())
+    fInitStatus = B_OK;
+
+  DEBUG_PRINT("[TagParserSandbox] Started %zu of %d helpers\n",
+              fHelpers.size(), (int)helperCount);
+}
+
+/**
+ * @brief Destructor.
+ *
+ * Deleting the request semaphores makes idle helpers exit; helpers that are
+ * still parsing are killed.
+ */
+TagParserSandbox::~TagParserSandbox() {
+  for (auto &helper : fHelpers) {
+    delete_sem(helper.ring->requestSem);
+    if (helper.team >= 0) {
+      if (atomic_get64(&helper.ring->busySince) != 0)
+        kill_team(helper.team);
+      status_t exitValue;
+      wait_for_thread(helper.thread, &exitValue);
+    }
+    delete_area(helper.area);
+  }
+
+  if (fResultSem >= 0)
+    delete_sem(fResultSem);
+}
+
+/**
+ * @brief Creates the ring area of a new helper and starts its process.
+ */
+status_t TagParserSandbox::_CreateHelper(Helper &helper) {
+  size_t size = (sizeof(Ring) + B_PAGE_SIZE - 1) & ~(B_PAGE_SIZE - 1);
+  helper.area = create_area("tag parser ring", (void **)&helper.ring,
+                            B_ANY_ADDRESS, size, B_NO_LOCK,
+                            B_READ_AREA | B_WRITE_AREA | B_CLONEABLE_AREA);
+  if (helper.area < 0)
+    return helper.area;
+
+  memset(helper.ring, 0, sizeof(Ring));
+  helper.ring->magic = kRingMagic;
+  helper.ring->resultSem = fResultSem;
+  helper.ring->requestSem = create_sem(0, "tag parser requests");
+
+  status_t status = helper.ring->requestSem;
+  if (status >= B_OK)
+    status = _LaunchHelper(helper);
+
+  if (status < B_OK) {
+    delete_sem(helper.ring->requestSem);
+    delete_area(helper.area);
+    return status;
+  }
+  return B_OK;
+}
+
+/**
+ * @brief Starts a helper process for an initialized ring.
+ */
+status_t TagParserSandbox::_LaunchHelper(Helper &helper) {
+  BString executable;
+  status_t status = _ExecutablePath(executable);
+  if (status != B_OK)
+    return status;
+
+  BString areaArg;
+  areaArg << (int32)helper.area;
+
+  const char *argv[] = {executable.String(), kHelperArgument,
+                        areaArg.String(), nullptr};
+  thread_id thread = load_image(3, argv, (const char **)environ);
+  if (thread < 0)
+    return thread;
+
+  thread_info info;
+  get_thread_info(thread, &info);
+  helper.thread = thread;
+  helper.team = info.team;
+
+  return resume_thread(thread);
+}
+
+/**
+ * @brief Replaces a dead or hung helper.
+ *
+ * The slot it was busy with is finished with @p reason. Its queued slots are
+ * handed to the new process, or failed with B_NO_INIT if none can be started.
+ */
+void TagParserSandbox::_RestartHelper(Helper &helper, status_t reason) {
+  Ring *ring = helper.ring;
+
+  kill_team(helper.team);
+  status_t exitValue;
+  wait_for_thread(helper.thread, &exitValue);
+  helper.team = -1;
+
+  bigtime_t since = atomic_get64(&ring->busySince);
+  if (since != 0) {
+    SandboxSlot &slot = ring->slots[ring->busySlot];
+    if (atomic_get(&slot.state) == kSlotQueued) {
+      DEBUG_PRINT("[TagParserSandbox] %s: %s\n", slot.path,
+                  reason == B_TIMED_OUT ? "timed out" : "helper crashed");
+      slot.status = reason;
+      slot.elapsed = system_time() - since;
+      slot.resultSize = 0;
+      atomic_set(&slot.state, kSlotDone);
+      release_sem(fResultSem);
+    }
+    atomic_set64(&ring->busySince, 0);
+  }
+
+  // The new helper starts at the oldest queued slot, with a request count
+  // that matches what is still queued
+  int32 queued = 0;
+  ring->next = helper.head;
+  for (int32 i = 0; i < helper.pending; i++) {
+    int32 index = (helper.tail + i) % kSlotsPerHelper;
+    if (atomic_get(&ring->slots[index].state) != kSlotQueued)
+      continue;
+    if (queued++ == 0)
+      ring->next = index;
+  }
+
+  delete_sem(ring->requestSem);
+  ring->requestSem = create_sem(queued, "tag parser requests");
+  if (ring->requestSem >= B_OK && _LaunchHelper(helper) == B_OK)
+    return;
+
+  for (int32 i = 0; i < helper.pending; i++) {
+    SandboxSlot &slot = ring->slots[(helper.tail + i) % kSlotsPerHelper];
+    if (atomic_get(&slot.state) != kSlotQueued)
+      continue;
+    slot.status = B_NO_INIT;
+    slot.elapsed = 0;
+    slot.resultSize = 0;
+    atomic_set(&slot.state, kSlotDone);
+    release_sem(fResultSem);
+  }
+  helper.team = -1;
+}
+
+/**
+ * @brief Restarts every helper that died or exceeded the per-file timeout.
+ */
+void TagParserSandbox::_Watchdog() {
+  const bigtime_t now = system_time();
+
+  for (auto &helper : fHelpers) {
+    if (helper.team < 0)
+      continue;
+
+    team_info info;
+    if (get_team_info(helper.team, &info) != B_OK) {
+      _RestartHelper(helper, B_ERROR);
+      continue;
+    }
+
+    bigtime_t since = atomic_get64(&helper.ring->busySince);
+    if (since != 0 && now - since > fTimeout)
+      _RestartHelper(helper, B_TIMED_OUT);
+  }
+}
+
+status_t TagParserSandbox::Submit(int32 id, const BString &path) {
+  if (path.Length() >= B_PATH_NAME_LENGTH)
+    return B_NAME_TOO_LONG;
+
+  Helper *target = nullptr;
+  bool running = false;
+  for (auto &helper : fHelpers) {
+    if (helper.team < 0)
+      continue;
+    running = true;
+    if (helper.pending < kSlotsPerHelper &&
+        (!target || helper.pending < target->pending))
+      target = &helper;
+  }
+
+  if (!running)
+    return B_NO_INIT;
+  if (!target)
+    return B_WOULD_BLOCK;
+
+  SandboxSlot &slot = target->ring->slots[target->head];
+  slot.id = id;
+  slot.status = B_OK;
+  slot.elapsed = 0;
+  slot.resultSize = 0;
+  strlcpy(slot.path, path.String(), sizeof(slot.path));
+  atomic_set(&slot.state, kSlotQueued);
+
+  target->head = (target->head + 1) % kSlotsPerHelper;
+  target->pending++;
+  release_sem(target->ring->requestSem);
+  return B_OK;
+}
+
+int32 TagParserSandbox::CountPending() const {
+  int32 pending = 0;
+  for (const auto &helper : fHelpers)
+    pending += helper.pending;
+  return pending;
+}
+
+/**
+ * @brief Takes the oldest finished slot of any helper.
+ */
+bool TagParserSandbox::_PopFinished(Result &out) {
+  for (auto &helper : fHelpers) {
+    if (helper.pending == 0)
+      continue;
+
+    SandboxSlot &slot = helper.ring->slots[helper.tail];
+    if (atomic_get(&slot.state) != kSlotDone)
+      continue;
+
+    out.id = slot.id;
+    out.path = slot.path;
+    out.status = slot.status;
+    out.elapsed = slot.elapsed;
+    out.tags = TagData();
+    if (out.status == B_OK) {
+      BMessage msg;
+      if (msg.Unflatten(slot.result) == B_OK)
+        _UnarchiveTags(msg, out.tags);
+      else
+        out.status = B_BAD_DATA;
+    }
+
+    atomic_set(&slot.state, kSlotFree);
+    helper.tail = (helper.tail + 1) % kSlotsPerHelper;
+    helper.pending--;
+    return true;
+  }
+  return false;
+}
+
+bool TagParserSandbox::Collect(Result &out, bigtime_t timeout) {
+  const bigtime_t deadline =
+      timeout == B_INFINITE_TIMEOUT ? B_INFINITE_TIMEOUT
+                                    : system_time() + timeout;
+
+  // The semaphore only wakes us up; the slot states are authoritative
+  while (CountPending() > 0) {
+    if (_PopFinished(out))
+      return true;
+
+    bigtime_t wait = kWatchdogInterval;
+    if (deadline != B_INFINITE_TIMEOUT)
+      wait = std::max((bigtime_t)0, std::min(wait, deadline - system_time()));
+
+    status_t status =
+        acquire_sem_etc(fResultSem, 1, B_RELATIVE_TIMEOUT, wait);
+    if (status == B_OK)
+      continue;
+    if (status != B_TIMED_OUT && status != B_WOULD_BLOCK &&
+        status != B_INTERRUPTED)
+      return false;
+
+    _Watchdog();
+    if (deadline != B_INFINITE_TIMEOUT && system_time() >= deadline)
+      return _PopFinished(out);
+  }
+  return false;
+}
+
+int TagParserSandbox::RunHelper(area_id area) {
+  Ring *ring = nullptr;
+  area_id local = clone_area("tag parser ring", (void **)&ring, B_ANY_ADDRESS,
+                             B_READ_AREA | B_WRITE_AREA, area);
+  if (local < 0 || ring->magic != kRingMagic)
+    return 1;
+
+  while (true) {
+    status_t err = acquire_sem(ring->requestSem);
+    if (err == B_INTERRUPTED)
+      continue;
+    if (err != B_OK)
+      break; // Host deleted the semaphore
+
+    const int32 index = ring->next;
+    SandboxSlot &slot = ring->slots[index];
+    const bigtime_t start = system_time();
+    ring->busySlot = index;
+    atomic_set64(&ring->busySince, start);
+
+    TagData td;
+    try {
+      TagSync::ReadAll(BPath(slot.path), td);
+    } catch (...) {
+      // Same as in-process parsing: keep what was read
+    }
+
+    BMessage msg;
+    _ArchiveTags(td, msg);
+    if (msg.FlattenedSize() > (ssize_t)kResultBytes) {
+      // Oversized comments are the usual culprit
+      msg.RemoveName("comment");
+      msg.AddString("comment", "");
+    }
+
+    ssize_t size = msg.FlattenedSize();
+    if (size <= (ssize_t)kResultBytes &&
+        msg.Flatten(slot.result, size) == B_OK) {
+      slot.resultSize = size;
+      slot.status = B_OK;
+    } else {
+      slot.resultSize = 0;
+      slot.status = B_NO_MEMORY;
+    }
+
+    slot.elapsed = system_time() - start;
+    ring->next = (index + 1) % kSlotsPerHelper;
+    atomic_set(&slot.state, kSlotDone);
+    atomic_set64(&ring->busySince, 0);
+    release_sem(ring->resultSem);
+  }
+
+  delete_area(local);
+  return 0;
+}
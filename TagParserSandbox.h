@@ -0,0 +1,116 @@
+#ifndef TAG_PARSER_SANDBOX_H
+#define TAG_PARSER_SANDBOX_H
+
+#include "TagParserPool.h"
+#include "TagSync.h"
+
+#include <OS.h>
+#include <String.h>
+#include <SupportDefs.h>
+#include <vector>
+
+/**
+ * @class TagParserSandbox
+ * @brief Runs tag extraction in helper processes, so that a parser crashing or
+ * spinning on a malformed file cannot take the player down.
+ *
+ * Every helper is another instance of the BeTon executable, started with
+ * kHelperArgument and the id of an area it shares with the host. The area
+ * holds a ring of request slots: the host writes a path into the slot at the
+ * head, the helper parses the slots in ring order and writes the flattened
+ * TagData back into the same slot. One semaphore shared by all helpers wakes
+ * the host whenever a slot is finished.
+ *
+ * While waiting for results, a watchdog checks every helper. One that has been
+ * busy with a single file for longer than the timeout is killed, one that died
+ * is noticed; in both cases the file is reported as failed and a new helper
+ * picks up the remaining requests.
+ *
+ * Not thread safe: a sandbox must only be used by the thread that created it.
+ */
+class TagParserSandbox : public TagParserPool {
+public:
+  /** @brief Command line argument that turns BeTon into a parser helper. */
+  static constexpr const char *kHelperArgument = "--tag-helper";
+
+  /** @brief Requests that can be queued per helper. */
+  static constexpr int32 kSlotsPerHelper = 8;
+
+  /** @brief Space for the flattened result of one file. */
+  static constexpr size_t kResultBytes = 16 * 1024;
+
+  /** @brief Time a helper may spend on a single file (20 s). */
+  static constexpr bigtime_t kDefaultTimeout = 20000000;
+
+  /**
+   * @brief Creates the shared rings and starts the helpers.
+   * @param helperCount Number of helper processes.
+   * @param timeout Time a helper may spend on a single file.
+   */
+  explicit TagParserSandbox(int32 helperCount,
+                            bigtime_t timeout = kDefaultTimeout);
+  ~TagParserSandbox() override;
+
+  /** @brief B_OK if at least one helper is running. */
+  status_t InitCheck() const override { return fInitStatus; }
+
+  /**
+   * @brief Queues a file on the least busy helper.
+   * @param id Caller-chosen id, handed back in the Result.
+   * @param path Absolute path of the file to parse.
+   * @return B_OK, B_WOULD_BLOCK if every ring is full (Collect() first),
+   * B_NAME_TOO_LONG or B_NO_INIT if no helper is running.
+   */
+  status_t Submit(int32 id, const BString &path) override;
+
+  /** @brief Number of submitted requests that were not collected yet. */
+  int32 CountPending() const override;
+
+  /**
+   * @brief Returns the next finished request.
+   *
+   * Runs the watchdog while waiting. A result with B_NO_MEMORY did not fit
+   * into its slot.
+   * @param out Receives the result.
+   * @param timeout Maximum time to wait.
+   * @return false if nothing finished in time or nothing is pending.
+   */
+  bool Collect(Result &out, bigtime_t timeout = B_INFINITE_TIMEOUT) override;
+
+  /**
+   * @brief Main loop of a helper process.
+   * @param area Id of the ring area created by the host.
+   * @return Process exit code.
+   */
+  static int RunHelper(area_id area);
+
+private:
+  struct Ring;
+
+  /**
+   * @struct Helper
+   * @brief Host-side state of one helper process and its ring.
+   */
+  struct Helper {
+    area_id area = -1;
+    Ring *ring = nullptr;
+    thread_id thread = -1;
+    team_id team = -1;
+    int32 head = 0;    ///< Next slot to submit to.
+    int32 tail = 0;    ///< Oldest slot not collected yet.
+    int32 pending = 0; ///< Slots between tail and head.
+  };
+
+  status_t _CreateHelper(Helper &helper);
+  status_t _LaunchHelper(Helper &helper);
+  void _RestartHelper(Helper &helper, status_t reason);
+  void _Watchdog();
+  bool _PopFinished(Result &out);
+
+  std::vector<Helper> fHelpers;
+  sem_id fResultSem;
+  bigtime_t fTimeout;
+  status_t fInitStatus;
+};
+
+#endif // TAG_PARSER_SANDBOX_H
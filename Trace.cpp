@@ -0,0 +1,234 @@
+#include "Trace.h"
+
+#ifdef BETON_TRACE
+
+#include <Autolock.h>
+#include <File.h>
+#include <FindDirectory.h>
+#include <Locker.h>
+#include <Path.h>
+#include <String.h>
+
+#include <algorithm>
+#include <map>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace Trace {
+
+std::atomic<bool> gEnabled{false};
+
+namespace {
+
+/**
+ * @struct Event
+ * @brief One recorded span or instant.
+ */
+struct Event {
+  const char *category;
+  const char *name;
+  const char *argName;
+  int64 arg;
+  bigtime_t start;
+  bigtime_t duration;
+  thread_id thread;
+};
+
+/**
+ * @struct Buffer
+ * @brief Ring of events written by a single thread.
+ *
+ * Only the owner writes; it fills the slot, then publishes it by advancing
+ * head. Buffers are never freed: a new thread takes over the buffer of a
+ * thread that has exited, so the number of buffers follows the number of
+ * threads alive at the same time.
+ */
+struct Buffer {
+  Event events[kBufferEvents];
+  std::atomic<uint64> head{0}; ///< Number of events ever written.
+  std::atomic<thread_id> owner{-1};
+  Buffer *next = nullptr;
+};
+
+static_assert((kBufferEvents & (kBufferEvents - 1)) == 0,
+              "kBufferEvents must be a power of two");
+
+std::atomic<Buffer *> sBuffers{nullptr};
+thread_local Buffer *tBuffer = nullptr;
+
+/// Names of all threads that ever recorded, for the export. Only touched
+/// when a thread records its first event and when exporting.
+BLocker sNamesLock("trace names");
+std::map<thread_id, BString> sThreadNames;
+
+Buffer *ClaimBuffer() {
+  const thread_id self = find_thread(nullptr);
+
+  thread_info info;
+  if (get_thread_info(self, &info) == B_OK) {
+    BAutolock lock(sNamesLock);
+    sThreadNames[self] = info.name;
+  }
+
+  for (Buffer *buffer = sBuffers.load(std::memory_order_acquire); buffer;
+       buffer = buffer->next) {
+    thread_id owner = buffer->owner.load(std::memory_order_relaxed);
+    thread_info ownerInfo;
+    if (get_thread_info(owner, &ownerInfo) != B_OK &&
+        buffer->owner.compare_exchange_strong(owner, self))
+      return buffer;
+  }
+
+  Buffer *buffer = new Buffer;
+  buffer->owner.store(self, std::memory_order_relaxed);
+  Buffer *first = sBuffers.load(std::memory_order_relaxed);
+  do {
+    buffer->next = first;
+  } while (!sBuffers.compare_exchange_weak(first, buffer,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+  return buffer;
+}
+
+/**
+ * @brief Copies the events of @p buffer that were not overwritten meanwhile.
+ */
+void CopyEvents(const Buffer *buffer, std::vector<Event> &out) {
+  const uint64 end = buffer->head.load(std::memory_order_acquire);
+  const uint64 begin = end > kBufferEvents ? end - kBufferEvents : 0;
+
+  std::vector<Event> copied;
+  copied.reserve(end - begin);
+  for (uint64 i = begin; i < end; i++)
+    copied.push_back(buffer->events[i & (kBufferEvents - 1)]);
+
+  // The owner may have lapped the copy; slots it has since reused (or is
+  // writing right now) hold newer events and are left out
+  const uint64 after = buffer->head.load(std::memory_order_acquire);
+  const uint64 firstValid =
+      after + 1 > kBufferEvents ? after + 1 - kBufferEvents : 0;
+  for (uint64 i = std::max(begin, firstValid); i < end; i++)
+    out.push_back(copied[i - begin]);
+}
+
+void AppendJsonString(BString &json, const char *s) {
+  json << '"';
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\')
+      json << '\\' << *s;
+    else if ((unsigned char)*s >= 0x20)
+      json << *s;
+  }
+  json << '"';
+}
+
+} // namespace
+
+void SetEnabled(bool enabled) {
+  gEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Record(const char *category, const char *name, const char *argName,
+            int64 arg, bigtime_t start, bigtime_t duration) {
+  if (tBuffer == nullptr)
+    tBuffer = ClaimBuffer();
+
+  const uint64 head = tBuffer->head.load(std::memory_order_relaxed);
+  Event &event = tBuffer->events[head & (kBufferEvents - 1)];
+  event.category = category;
+  event.name = name;
+  event.argName = argName;
+  event.arg = arg;
+  event.start = start;
+  event.duration = duration;
+  event.thread = find_thread(nullptr);
+  tBuffer->head.store(head + 1, std::memory_order_release);
+}
+
+status_t Export(const char *path) {
+  std::vector<Event> events;
+  for (Buffer *buffer = sBuffers.load(std::memory_order_acquire); buffer;
+       buffer = buffer->next)
+    CopyEvents(buffer, events);
+
+  BFile file(path, B_WRITE_ONLY | B_CREATE_FILE | B_ERASE_FILE);
+  status_t status = file.InitCheck();
+  if (status != B_OK)
+    return status;
+
+  // The main thread carries the program name and the team's ID
+  const pid_t pid = getpid();
+  thread_info mainThread;
+  BString process = "BeTon";
+  if (get_thread_info(pid, &mainThread) == B_OK)
+    process = mainThread.name;
+
+  BString json;
+  json << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  json << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << pid
+       << ", \"args\": {\"name\": ";
+  AppendJsonString(json, process.String());
+  json << "}}";
+
+  {
+    BAutolock lock(sNamesLock);
+    for (const auto &[thread, name] : sThreadNames) {
+      json << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid
+           << ", \"tid\": " << thread << ", \"args\": {\"name\": ";
+      AppendJsonString(json, name.String());
+      json << "}}";
+    }
+  }
+
+  for (const Event &event : events) {
+    json << ",\n{\"name\": ";
+    AppendJsonString(json, event.name);
+    json << ", \"cat\": ";
+    AppendJsonString(json, event.category);
+    if (event.duration < 0)
+      json << ", \"ph\": \"i\", \"s\": \"t\"";
+    else
+      json << ", \"ph\": \"X\", \"dur\": " << event.duration;
+    json << ", \"ts\": " << event.start << ", \"pid\": " << pid
+         << ", \"tid\": " << event.thread;
+    if (event.argName) {
+      json << ", \"args\": {";
+      AppendJsonString(json, event.argName);
+      json << ": " << event.arg << "}";
+    }
+    json << "}";
+
+    if (json.Length() > 256 * 1024) {
+      file.Write(json.String(), json.Length());
+      json.Truncate(0);
+    }
+  }
+
+  json << "\n]}\n";
+  ssize_t written = file.Write(json.String(), json.Length());
+  return written < 0 ? (status_t)written : B_OK;
+}
+
+status_t ExportToLogDirectory(BString *outPath) {
+  BPath path;
+  status_t status = find_directory(B_USER_LOG_DIRECTORY, &path, true);
+  if (status != B_OK)
+    return status;
+
+  char stamp[32];
+  time_t now = time(nullptr);
+  strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&now));
+  BString name;
+  name << "BeTon-trace-" << stamp << ".json";
+  path.Append(name.String());
+
+  status = Export(path.Path());
+  if (status == B_OK && outPath)
+    *outPath = path.Path();
+  return status;
+}
+
+} // namespace Trace
+
+#endif // BETON_TRACE
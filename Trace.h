@@ -0,0 +1,126 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <OS.h>
+#include <String.h>
+#include <SupportDefs.h>
+#include <atomic>
+
+/**
+ * @file Trace.h
+ * @brief Scoped trace spans, exported as Chrome trace-event JSON.
+ *
+ * Spans are only compiled in when BETON_TRACE is defined (the Makefiles do
+ * this); otherwise the macros expand to nothing. Compiled in, they record
+ * nothing until Trace::SetEnabled(true) is called (`--trace`, or File >
+ * Record Trace), and a span that is off costs one relaxed atomic load.
+ *
+ * Every thread writes into its own ring buffer of the last kBufferEvents
+ * events, without locks or system calls. Export() may run at any time; an
+ * event overwritten while it is being copied is dropped. The JSON opens in
+ * chrome://tracing and ui.perfetto.dev, with one track per thread, which is
+ * what DEBUG_PRINT timestamps cannot show: the scanner, cache and window
+ * threads waiting on each other.
+ *
+ * Names, categories and argument names must be string literals, since only
+ * the pointers are stored.
+ */
+
+/** @brief Records the enclosing scope as a span. */
+#define TRACE_SCOPE(category, name)
+
+/** @brief Records the enclosing scope with one numeric argument. */
+#define TRACE_SCOPE_ARG(category, name, argName, value)
+
+/** @brief Records a point in time, e.g. a message being sent. */
+#define TRACE_INSTANT(category, name)
+
+#ifdef BETON_TRACE
+
+#undef TRACE_SCOPE
+#undef TRACE_SCOPE_ARG
+#undef TRACE_INSTANT
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#define TRACE_SCOPE(category, name)                                            \
+  TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name)
+#define TRACE_SCOPE_ARG(category, name, argName, value)                        \
+  TraceScope TRACE_CONCAT(traceScope, __LINE__)(category, name, argName,       \
+                                                (int64)(value))
+#define TRACE_INSTANT(category, name)                                          \
+  do {                                                                         \
+    if (Trace::IsEnabled())                                                    \
+      Trace::Record(category, name, nullptr, 0, system_time(), -1);            \
+  } while (0)
+
+/**
+ * @namespace Trace
+ * @brief The recorder behind the TRACE_* macros.
+ */
+namespace Trace {
+
+/** @brief Events kept per thread; older ones are overwritten. */
+static constexpr uint32 kBufferEvents = 16384;
+
+extern std::atomic<bool> gEnabled;
+
+inline bool IsEnabled() { return gEnabled.load(std::memory_order_relaxed); }
+
+/** @brief Starts or stops recording; recorded events are kept. */
+void SetEnabled(bool enabled);
+
+/**
+ * @brief Appends an event to the calling thread's buffer.
+ * @param duration Length of the span, or -1 for an instant event.
+ */
+void Record(const char *category, const char *name, const char *argName,
+            int64 arg, bigtime_t start, bigtime_t duration);
+
+/**
+ * @brief Writes the events of all threads to @p path.
+ * @return B_OK, or the error from creating the file.
+ */
+status_t Export(const char *path);
+
+/**
+ * @brief Writes the events to a new BeTon-trace-<time>.json in the user's
+ * log directory (~/config/var/log).
+ * @param outPath Receives the path of the file written, if not null.
+ */
+status_t ExportToLogDirectory(BString *outPath = nullptr);
+
+} // namespace Trace
+
+/**
+ * @class TraceScope
+ * @brief Span from construction to destruction, see TRACE_SCOPE.
+ */
+class TraceScope {
+public:
+  TraceScope(const char *category, const char *name,
+             const char *argName = nullptr, int64 arg = 0)
+      : fCategory(category), fName(name), fArgName(argName), fArg(arg),
+        fStart(Trace::IsEnabled() ? system_time() : 0) {}
+
+  ~TraceScope() {
+    if (fStart != 0)
+      Trace::Record(fCategory, fName, fArgName, fArg, fStart,
+                    system_time() - fStart);
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  const char *fCategory;
+  const char *fName;
+  const char *fArgName;
+  int64 fArg;
+  bigtime_t fStart;
+};
+
+#endif // BETON_TRACE
+
+#endif // TRACE_H
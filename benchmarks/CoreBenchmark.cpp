@@ -0,0 +1,844 @@
+/**
+ * @file CoreBenchmark.cpp
+ * @brief Times BeTon's core library paths on synthetic libraries.
+ *
+ * Reads one or more manifests written by LibraryGenerator (-M is enough, no
+ * audio files are touched) and, for each library, times:
+ *
+ * | Case                 | Code path                                        |
+ * |----------------------|--------------------------------------------------|
+ * | batch_encode         | MediaBatchWriter, as in MediaScanner::FlushBatch |
+ * | batch_ingest_new     | LibraryStore::AddBatch() into an empty store,    |
+ * |                      | as CacheManager handles MSG_MEDIA_BATCH          |
+ * | batch_ingest_update  | The same batches again (rescan)                  |
+ * | cache_save           | LibraryStore::Save(), as CacheManager::SaveCache |
+ * | cache_load           | LibraryStore::Load(), as CacheManager::LoadCache |
+ * | cache_load_serial    | ... decoding on the loading thread only          |
+ * | cache_load_streamed  | ... with every chunk sent as MSG_CACHE_CHUNK and |
+ * |                      | decoded by the window                            |
+ * | all_entries          | LibraryStore::AllEntries()                       |
+ * | filter_none          | LibraryFilter (UpdateFilteredViews), no selection|
+ * | filter_genre         | ... the largest genre selected                   |
+ * | filter_artist        | ... and its largest artist                       |
+ * | filter_album         | ... and one of that artist's albums              |
+ * | filter_text          | ... search text only                             |
+ * | view_rows            | LibraryViewManager handing the matches to rows   |
+ * | snapshot_load        | LibrarySnapshot::Load(), painted at startup      |
+ * |                      | before the cache is loaded (one op per load)     |
+ * | playlist_save        | PlaylistManager's .m3u writer, every 10th track  |
+ * | playlist_load        | PlaylistManager's .m3u reader                    |
+ * | similarity           | MatchingUtils::Similarity() on 1000 title pairs  |
+ * | smart_match          | MatcherWindow's scoring (AssignTracks) per album |
+ *
+ * Each case runs once to warm up, then repeats until it has at least the
+ * minimum number of runs and the minimum time, or the maximum number of
+ * runs. The results go to stdout (or -o) as JSON:
+ *
+ *     {"schema": 1, "suite": "beton-core", "label": ..., "date": ...,
+ *      "host": {...}, "settings": {...},
+ *      "results": [{"name": "cache_load", "tracks": 100000,
+ *                   "ops_per_run": 100000, "runs": 7, "unit": "ms",
+ *                   "median": ..., "mean": ..., "stddev": ..., "ci95": ...,
+ *                   "mad": ..., "min": ..., "max": ..., "ns_per_op": ...,
+ *                   "allocs_per_op": ..., "copies_per_op": ...,
+ *                   "samples": [...]}, ...]}
+ *
+ * Times are per run in milliseconds; ci95 is the half-width of the 95%
+ * confidence interval of the mean (Student's t), mad the median absolute
+ * deviation. Compare medians between releases; differences inside ci95 are
+ * noise.
+ *
+ * With glibc, malloc() and friends are wrapped to count calls, and each
+ * result also carries "allocs_per_op": heap allocations per track (or
+ * pair, album...) of the last run, setup excluded. It is null on other
+ * systems and under AddressSanitizer, which brings its own malloc. The
+ * portable BString copies its buffer where Haiku's shares it, so Linux
+ * counts are an upper bound for the app.
+ *
+ * Every result also has "copies_per_op", the MediaItem copies per track of
+ * the last run (see CopyCounter; CoreBenchmark.make builds the benchmark
+ * and libbeton-core with BETON_COPY_COUNT for this). The pipeline from
+ * scanner batch to view row is meant to copy an item only where it crosses
+ * into the UI thread (all_entries) and into its row (view_rows); if a case
+ * makes more copies than kCopyBudgets allows, the benchmark says so and
+ * exits with status 2.
+ *
+ * Only libbeton-core is used, so the benchmark also builds on Linux for
+ * perf and the sanitizers (see CoreBenchmark.make). Results of the two
+ * platforms are not comparable with each other.
+ *
+ * Usage: CoreBenchmark [-r min runs] [-R max runs] [-t min seconds]
+ *        [-c case] [-l label] [-w work dir] [-o results.json] manifest...
+ */
+
+#include "LibraryFilter.h"
+#include "LibrarySnapshot.h"
+#include "LibraryStore.h"
+#include "MatchingUtils.h"
+#include "MediaBatch.h"
+#include "MediaItem.h"
+#include "Messages.h"
+#include "PlaylistFile.h"
+
+#include <Message.h>
+#include <Path.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef BETON_COPY_COUNT
+#error "CoreBenchmark needs BETON_COPY_COUNT, see CoreBenchmark.make"
+#endif
+
+bool gIsDebug = false;
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+static std::atomic<int64> sAllocations{0};
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+
+void *malloc(size_t size) {
+  sAllocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+  sAllocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+  sAllocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(pointer, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+  sAllocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+  return memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+  void *pointer = memalign(alignment, size);
+  if (!pointer)
+    return ENOMEM;
+  *out = pointer;
+  return 0;
+}
+}
+
+static int64 AllocationCount() {
+  return sAllocations.load(std::memory_order_relaxed);
+}
+#else
+static int64 AllocationCount() { return -1; }
+#endif
+
+/** @brief Directory the manifest paths are placed under. */
+static const char *kLibraryRoot = "/boot/home/music";
+
+/** @brief Number of title pairs compared per similarity run. */
+static const size_t kSimilarityPairs = 1000;
+
+/** @brief Number of albums matched per smart_match run. */
+static const size_t kMatchAlbums = 200;
+
+/** @brief Search text of filter_text; LibraryGenerator titles use "Tides". */
+static const char *kSearchText = "tide";
+
+/**
+ * @struct CopyBudget
+ * @brief Most MediaItem copies per operation a case may make.
+ */
+struct CopyBudget {
+  const char *prefix; ///< Cases whose name starts with this.
+  double copies;
+};
+
+static const CopyBudget kCopyBudgets[] = {
+    {"batch_", 0},     {"cache_", 0},    {"all_entries", 1},
+    {"filter_", 0},    {"view_rows", 1}, {"snapshot_", 0}};
+
+/**
+ * @struct Options
+ * @brief Command line settings.
+ */
+struct Options {
+  int32 minRuns = 5;
+  int32 maxRuns = 50;
+  double minSeconds = 1.0;
+  const char *onlyCase = nullptr;
+  const char *label = "";
+  const char *workDir = "/tmp/beton-bench";
+  const char *output = nullptr;
+  std::vector<const char *> manifests;
+};
+
+/**
+ * @struct Result
+ * @brief Samples of one case on one library.
+ */
+struct Result {
+  std::string name;
+  size_t tracks;
+  int64 opsPerRun;
+  std::vector<double> samples; ///< Milliseconds per run.
+  int64 allocations;           ///< Heap allocations of the last run, or -1.
+  int64 copies;                ///< MediaItem copies of the last run.
+};
+
+/**
+ * @class Runner
+ * @brief Repeats cases and collects their samples.
+ */
+class Runner {
+public:
+  explicit Runner(const Options &options) : fOptions(options) {}
+
+  /**
+   * @brief Times @p body.
+   * @param setup Untimed preparation before every run (may be empty).
+   */
+  void Run(const char *name, size_t tracks, int64 opsPerRun,
+           const std::function<void()> &body,
+           const std::function<void()> &setup = nullptr) {
+    if (fOptions.onlyCase && strstr(name, fOptions.onlyCase) == nullptr)
+      return;
+
+    Result result{name, tracks, opsPerRun, {}, -1, 0};
+    double total = 0;
+
+    // The first run warms caches and allocators and is not counted
+    for (int32 run = -1;; run++) {
+      if (setup)
+        setup();
+      const int64 allocationsBefore = AllocationCount();
+      const int64 copiesBefore = MediaItem::Copies();
+      auto start = std::chrono::steady_clock::now();
+      body();
+      std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+      if (run < 0)
+        continue;
+
+      if (allocationsBefore >= 0)
+        result.allocations = AllocationCount() - allocationsBefore;
+      result.copies = MediaItem::Copies() - copiesBefore;
+
+      result.samples.push_back(elapsed.count());
+      total += elapsed.count() / 1000.0;
+      const int32 runs = run + 1;
+      if (runs >= fOptions.maxRuns ||
+          (runs >= fOptions.minRuns && total >= fOptions.minSeconds))
+        break;
+    }
+
+    std::vector<double> sorted = result.samples;
+    std::sort(sorted.begin(), sorted.end());
+    fprintf(stderr, "%-20s %8zu tracks %12.3f ms  (%zu runs)", name, tracks,
+            Median(sorted), result.samples.size());
+    if (result.allocations >= 0 && opsPerRun > 0)
+      fprintf(stderr, " %10.2f allocs/op",
+              (double)result.allocations / opsPerRun);
+    if (opsPerRun > 0)
+      fprintf(stderr, " %6.2f copies/op", (double)result.copies / opsPerRun);
+    fprintf(stderr, "\n");
+    fResults.push_back(result);
+  }
+
+  const std::vector<Result> &Results() const { return fResults; }
+
+  static double Median(const std::vector<double> &sorted) {
+    const size_t n = sorted.size();
+    if (n == 0)
+      return 0;
+    return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+  }
+
+private:
+  const Options &fOptions;
+  std::vector<Result> fResults;
+};
+
+/** @brief Two-sided 95% quantile of Student's t with @p df degrees. */
+static double StudentT95(size_t df) {
+  static const double kTable[] = {
+      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  if (df == 0)
+    return 0;
+  if (df <= sizeof(kTable) / sizeof(kTable[0]))
+    return kTable[df - 1];
+  return 1.960;
+}
+
+static std::string JsonString(const char *s) {
+  std::string out = "\"";
+  for (; *s; s++) {
+    const unsigned char c = *s;
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (c < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+static void WriteJson(FILE *out, const Options &options,
+                      const std::vector<Result> &results) {
+  char date[32];
+  time_t now = time(nullptr);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+  struct utsname host;
+  if (uname(&host) != 0)
+    memset(&host, 0, sizeof(host));
+
+  fprintf(out, "{\n  \"schema\": 1,\n  \"suite\": \"beton-core\",\n");
+  fprintf(out, "  \"label\": %s,\n  \"date\": \"%s\",\n",
+          JsonString(options.label).c_str(), date);
+  fprintf(out,
+          "  \"host\": {\"system\": %s, \"release\": %s, \"version\": %s, "
+          "\"machine\": %s, \"cpus\": %ld},\n",
+          JsonString(host.sysname).c_str(), JsonString(host.release).c_str(),
+          JsonString(host.version).c_str(), JsonString(host.machine).c_str(),
+          sysconf(_SC_NPROCESSORS_ONLN));
+  fprintf(out,
+          "  \"settings\": {\"min_runs\": %d, \"max_runs\": %d, "
+          "\"min_seconds\": %.2f},\n",
+          (int)options.minRuns, (int)options.maxRuns, options.minSeconds);
+  fprintf(out, "  \"results\": [");
+
+  for (size_t r = 0; r < results.size(); r++) {
+    const Result &result = results[r];
+    std::vector<double> sorted = result.samples;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t n = sorted.size();
+
+    double mean = 0;
+    for (double s : sorted)
+      mean += s;
+    mean /= n;
+
+    double variance = 0;
+    for (double s : sorted)
+      variance += (s - mean) * (s - mean);
+    const double stddev = n > 1 ? std::sqrt(variance / (n - 1)) : 0;
+
+    const double median = Runner::Median(sorted);
+    std::vector<double> deviations;
+    for (double s : sorted)
+      deviations.push_back(std::fabs(s - median));
+    std::sort(deviations.begin(), deviations.end());
+
+    fprintf(out,
+            "%s\n    {\"name\": %s, \"tracks\": %zu, \"ops_per_run\": %lld, "
+            "\"runs\": %zu, \"unit\": \"ms\",\n",
+            r ? "," : "", JsonString(result.name.c_str()).c_str(),
+            result.tracks, (long long)result.opsPerRun, n);
+    fprintf(out,
+            "     \"median\": %.6f, \"mean\": %.6f, \"stddev\": %.6f, "
+            "\"ci95\": %.6f, \"mad\": %.6f,\n",
+            median, mean, stddev, StudentT95(n - 1) * stddev / std::sqrt(n),
+            Runner::Median(deviations));
+    fprintf(out, "     \"min\": %.6f, \"max\": %.6f, \"ns_per_op\": %.3f,\n",
+            sorted.front(), sorted.back(),
+            result.opsPerRun > 0 ? median * 1e6 / result.opsPerRun : 0.0);
+    if (result.allocations >= 0 && result.opsPerRun > 0)
+      fprintf(out, "     \"allocs_per_op\": %.3f,\n",
+              (double)result.allocations / result.opsPerRun);
+    else
+      fprintf(out, "     \"allocs_per_op\": null,\n");
+    fprintf(out, "     \"copies_per_op\": %.3f,\n",
+            result.opsPerRun > 0 ? (double)result.copies / result.opsPerRun
+                                 : 0.0);
+    fprintf(out, "     \"samples\": [");
+    for (size_t i = 0; i < n; i++)
+      fprintf(out, "%s%.6f", i ? ", " : "", result.samples[i]);
+    fprintf(out, "]}");
+  }
+  fprintf(out, "\n  ]\n}\n");
+}
+
+/**
+ * @brief Loads a LibraryGenerator manifest as the items a scan of it would
+ * produce.
+ * @return False if the file cannot be read.
+ */
+static bool LoadManifest(const char *path, std::vector<MediaItem> &items) {
+  FILE *file = fopen(path, "r");
+  if (!file)
+    return false;
+
+  char *line = nullptr;
+  size_t capacity = 0;
+  int64 index = 0;
+  // path format title artist album albumArtist genre year track trackTotal
+  // disc discTotal compilation seconds coverBytes
+  while (getline(&line, &capacity, file) > 0) {
+    if (index++ == 0)
+      continue;
+
+    std::vector<const char *> fields;
+    for (char *field = line;;) {
+      fields.push_back(field);
+      char *tab = strchr(field, '\t');
+      if (!tab)
+        break;
+      *tab = '\0';
+      field = tab + 1;
+    }
+    if (fields.size() < 15)
+      continue;
+
+    MediaItem item;
+    item.path << kLibraryRoot << "/" << fields[0];
+    item.base = kLibraryRoot;
+    item.title = fields[2];
+    item.artist = fields[3];
+    item.album = fields[4];
+    item.albumArtist = fields[5];
+    item.genre = fields[6];
+    item.year = atoi(fields[7]);
+    item.track = atoi(fields[8]);
+    item.trackTotal = atoi(fields[9]);
+    item.disc = atoi(fields[10]);
+    item.discTotal = atoi(fields[11]);
+    item.duration = atoi(fields[13]);
+
+    const char *format = fields[1];
+    item.bitrate = strcmp(format, "flac") == 0  ? 900
+                   : strcmp(format, "m4a") == 0 ? 256
+                   : strcmp(format, "ogg") == 0 ? 160
+                                                : 128;
+    item.sampleRate = 44100;
+    item.channels = 2;
+    item.size = (int64)item.duration * item.bitrate * 125 + atoll(fields[14]);
+    item.mtime = 1700000000 + index;
+    item.inode = 1000 + index;
+    items.push_back(std::move(item));
+  }
+
+  free(line);
+  fclose(file);
+  return true;
+}
+
+/**
+ * @brief Encodes @p items the way MediaScanner::FlushBatch() does.
+ */
+static void EncodeBatches(const std::vector<MediaItem> &items,
+                          std::vector<BMessage> &batches) {
+  batches.clear();
+  MediaBatchWriter writer;
+  size_t bytes = 0;
+
+  auto flush = [&]() {
+    BMessage msg(MSG_MEDIA_BATCH);
+    msg.AddString("base", kLibraryRoot);
+    writer.AddToMessage(msg);
+    batches.push_back(msg);
+    writer.Clear();
+    bytes = 0;
+  };
+
+  for (const auto &item : items) {
+    writer.Add(item);
+    bytes += MediaBatchWriter::EncodedSizeOf(item);
+    if ((size_t)writer.CountItems() >= kMediaBatchMaxItems ||
+        bytes >= kMediaBatchMaxBytes)
+      flush();
+  }
+  if (writer.CountItems() > 0)
+    flush();
+}
+
+/** @brief Returns the key that occurs most often among @p items. */
+template <typename KeyFunc>
+static BString MostCommon(const std::vector<MediaItem> &items, KeyFunc key) {
+  std::map<BString, int32> counts;
+  for (const auto &item : items) {
+    const BString &value = key(item);
+    if (!value.IsEmpty())
+      counts[value]++;
+  }
+
+  BString best;
+  int32 bestCount = 0;
+  for (const auto &[value, count] : counts) {
+    if (count > bestCount) {
+      best = value;
+      bestCount = count;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Builds the input of MatcherWindow::_SmartMatch for up to
+ * kMatchAlbums albums: the tagged files, and the release tracks in reverse
+ * order with durations a few seconds off.
+ */
+static void BuildMatchAlbums(
+    const std::vector<MediaItem> &entries,
+    std::vector<std::vector<MatchingUtils::FileCandidate>> &files,
+    std::vector<std::vector<MatchingUtils::TrackCandidate>> &tracks) {
+  auto folderOf = [](const BString &path) {
+    BString folder;
+    path.CopyInto(folder, 0, path.FindLast('/'));
+    return folder;
+  };
+
+  // Entries are sorted by path, so each album folder is a contiguous run
+  size_t start = 0;
+  while (start < entries.size() && files.size() < kMatchAlbums) {
+    const BString folder = folderOf(entries[start].path);
+    size_t end = start + 1;
+    while (end < entries.size() && folderOf(entries[end].path) == folder)
+      end++;
+
+    if (end - start >= 2) {
+      std::vector<MatchingUtils::FileCandidate> albumFiles;
+      std::vector<MatchingUtils::TrackCandidate> albumTracks;
+      for (size_t i = start; i < end; i++) {
+        BPath path(entries[i].path.String());
+        MatchingUtils::FileCandidate file;
+        file.durationSec = entries[i].duration;
+        file.trackNum = entries[i].track;
+        file.cleanName = MatchingUtils::CleanFileName(path.Leaf());
+        albumFiles.push_back(file);
+
+        MatchingUtils::TrackCandidate track;
+        track.durationSec = entries[i].duration + (int)(i % 5) - 2;
+        track.index = entries[i].track;
+        track.name = entries[i].title;
+        albumTracks.insert(albumTracks.begin(), track);
+      }
+      files.push_back(albumFiles);
+      tracks.push_back(albumTracks);
+    }
+    start = end;
+  }
+}
+
+static void RunLibrary(Runner &runner, const Options &options,
+                       const char *manifest) {
+  std::vector<MediaItem> items;
+  if (!LoadManifest(manifest, items)) {
+    fprintf(stderr, "Cannot read %s\n", manifest);
+    return;
+  }
+  const size_t tracks = items.size();
+  fprintf(stderr, "%s: %zu tracks\n", manifest, tracks);
+
+  BString cachePath;
+  cachePath.SetToFormat("%s/library-%zu.cache", options.workDir, tracks);
+  BString playlistPath;
+  playlistPath.SetToFormat("%s/library-%zu.m3u", options.workDir, tracks);
+  unlink(cachePath.String());
+
+  // Scanner -> cache
+  std::vector<BMessage> batches;
+  runner.Run("batch_encode", tracks, tracks,
+             [&]() { EncodeBatches(items, batches); });
+  if (batches.empty())
+    EncodeBatches(items, batches);
+  items = std::vector<MediaItem>();
+
+  LibraryStore store;
+  auto ingest = [&]() {
+    for (const auto &batch : batches) {
+      MediaBatchReader reader;
+      if (reader.SetTo(&batch) == B_OK)
+        store.AddBatch(reader, batch.GetString("base", nullptr));
+    }
+  };
+  runner.Run("batch_ingest_new", tracks, tracks, ingest,
+             [&]() { store.Clear(); });
+  store.Clear();
+  ingest();
+  runner.Run("batch_ingest_update", tracks, tracks, ingest);
+  batches = std::vector<BMessage>();
+
+  runner.Run("cache_save", tracks, tracks,
+             [&]() { store.Save(cachePath.String()); });
+  store.Save(cachePath.String());
+  runner.Run("cache_load", tracks, tracks,
+             [&]() { store.Load(cachePath.String()); });
+  store.SetDecodeThreads(1);
+  runner.Run("cache_load_serial", tracks, tracks,
+             [&]() { store.Load(cachePath.String()); });
+  store.SetDecodeThreads(0);
+
+  std::vector<MediaItem> streamed;
+  auto forward = [&](const MediaBatchReader &chunk, int32, int32 total) {
+    BMessage msg(MSG_CACHE_CHUNK);
+    msg.AddData(kMediaBatchField, B_RAW_TYPE, chunk.Data(), chunk.Size());
+
+    MediaBatchReader received;
+    if (received.SetTo(&msg) != B_OK)
+      return;
+    if (streamed.empty())
+      streamed.reserve(total);
+    const size_t first = streamed.size();
+    streamed.resize(first + received.CountItems());
+    for (int32 i = 0; i < received.CountItems(); i++)
+      received.ItemAt(i, streamed[first + i]);
+  };
+  runner.Run(
+      "cache_load_streamed", tracks, tracks,
+      [&]() { store.Load(cachePath.String(), forward); },
+      [&]() { streamed = std::vector<MediaItem>(); });
+  streamed = std::vector<MediaItem>();
+
+  std::vector<MediaItem> entries;
+  runner.Run(
+      "all_entries", tracks, tracks, [&]() { entries = store.AllEntries(); },
+      [&]() { entries = std::vector<MediaItem>(); });
+  entries = store.AllEntries();
+
+  store.Clear();
+  unlink(cachePath.String());
+
+  // Column browser
+  const BString genre =
+      MostCommon(entries, [](const MediaItem &i) { return i.genre; });
+  std::vector<MediaItem> inGenre;
+  for (const auto &item : entries) {
+    if (item.genre == genre)
+      inGenre.push_back(item);
+  }
+  const BString artist =
+      MostCommon(inGenre, [](const MediaItem &i) { return i.artist; });
+  int32 albumYear = -1;
+  BString album;
+  for (const auto &item : inGenre) {
+    if (item.artist == artist && !item.album.IsEmpty()) {
+      album = item.album;
+      albumYear = item.year;
+      break;
+    }
+  }
+  inGenre.clear();
+
+  LibraryFilterResult result;
+  auto filterCase = [&](const char *name, const LibraryFilter &filter) {
+    runner.Run(
+        name, tracks, tracks, [&]() { filter.Apply(entries, result); },
+        [&]() { result = LibraryFilterResult(); });
+  };
+
+  LibraryFilter filter;
+  filterCase("filter_none", filter);
+  filter.SetGenre(LibraryFilter::kValue, genre);
+  filterCase("filter_genre", filter);
+  filter.SetArtist(LibraryFilter::kValue, artist);
+  filterCase("filter_artist", filter);
+  filter.SetAlbum(LibraryFilter::kValue, album, albumYear);
+  filterCase("filter_album", filter);
+
+  LibraryFilter search;
+  search.SetText(kSearchText);
+  filterCase("filter_text", search);
+
+  // Content view: every match is copied into the item its row owns
+  LibraryFilter().Apply(entries, result);
+  std::vector<MediaItem> rows;
+  runner.Run(
+      "view_rows", tracks, result.items.size(),
+      [&]() {
+        rows.reserve(result.items.size());
+        for (int32 index : result.items)
+          rows.push_back(entries[index]);
+      },
+      [&]() { rows = std::vector<MediaItem>(); });
+  rows = std::vector<MediaItem>();
+
+  // Startup: the columns and the first screenful of the unfiltered view
+  LibrarySnapshot snapshot;
+  auto addToColumn = [&](LibrarySnapshot::Column column, const BString &text) {
+    snapshot.columns[column].texts.push_back(text);
+    snapshot.columns[column].data.push_back("");
+  };
+  for (const BString &name : result.genres)
+    addToColumn(LibrarySnapshot::kGenre, name);
+  for (const BString &name : result.artists)
+    addToColumn(LibrarySnapshot::kArtist, name);
+  for (const auto &[name, years] : result.albums)
+    addToColumn(LibrarySnapshot::kAlbum, name);
+  for (size_t i = 0;
+       i < result.items.size() && i < (size_t)LibrarySnapshot::kMaxRows; i++)
+    snapshot.rows.push_back(entries[result.items[i]]);
+  snapshot.trackCount = (int32)result.items.size();
+  snapshot.duration = result.duration;
+  result = LibraryFilterResult();
+
+  BString snapshotPath;
+  snapshotPath.SetToFormat("%s/library-%zu.snapshot", options.workDir, tracks);
+  snapshot.Save(snapshotPath.String());
+  runner.Run("snapshot_load", tracks, 1,
+             [&]() { snapshot.Load(snapshotPath.String()); });
+  snapshot.Clear();
+  unlink(snapshotPath.String());
+
+  // Playlists
+  std::vector<BString> playlist;
+  for (size_t i = 0; i < entries.size(); i += 10)
+    playlist.push_back(entries[i].path);
+  runner.Run("playlist_save", tracks, playlist.size(), [&]() {
+    WritePlaylistFile(playlistPath.String(), playlist);
+  });
+
+  WritePlaylistFile(playlistPath.String(), playlist);
+  std::vector<BString> loaded;
+  runner.Run(
+      "playlist_load", tracks, playlist.size(),
+      [&]() { ReadPlaylistFile(playlistPath.String(), loaded); },
+      [&]() { loaded.clear(); });
+  unlink(playlistPath.String());
+
+  // Matching
+  const size_t pairs = std::min(kSimilarityPairs, entries.size() / 2);
+  volatile float similaritySum = 0;
+  runner.Run("similarity", tracks, pairs, [&]() {
+    float sum = 0;
+    for (size_t i = 0; i < pairs; i++) {
+      sum += MatchingUtils::Similarity(entries[2 * i].title.String(),
+                                       entries[2 * i + 1].title.String());
+    }
+    similaritySum = sum;
+  });
+
+  std::vector<std::vector<MatchingUtils::FileCandidate>> matchFiles;
+  std::vector<std::vector<MatchingUtils::TrackCandidate>> matchTracks;
+  BuildMatchAlbums(entries, matchFiles, matchTracks);
+  volatile int matchSum = 0;
+  runner.Run("smart_match", tracks, matchFiles.size(), [&]() {
+    int sum = 0;
+    for (size_t a = 0; a < matchFiles.size(); a++)
+      sum += MatchingUtils::AssignTracks(matchFiles[a], matchTracks[a])[0];
+    matchSum = sum;
+  });
+}
+
+/**
+ * @brief Reports the results that exceed their copy budget.
+ * @return False if any did.
+ */
+static bool CheckCopyBudgets(const std::vector<Result> &results) {
+  bool ok = true;
+  for (const Result &result : results) {
+    if (result.opsPerRun <= 0)
+      continue;
+    const double copies = (double)result.copies / result.opsPerRun;
+    for (const CopyBudget &budget : kCopyBudgets) {
+      if (result.name.compare(0, strlen(budget.prefix), budget.prefix) != 0)
+        continue;
+      if (copies > budget.copies) {
+        fprintf(stderr,
+                "%s: %.2f MediaItem copies per op on %zu tracks, budget "
+                "%.0f\n",
+                result.name.c_str(), copies, result.tracks, budget.copies);
+        ok = false;
+      }
+      break;
+    }
+  }
+  return ok;
+}
+
+static int Usage() {
+  fprintf(stderr,
+          "Usage: CoreBenchmark [-r min runs] [-R max runs] [-t min seconds]\n"
+          "       [-c case] [-l label] [-w work dir] [-o results.json] "
+          "manifest...\n"
+          "Manifests come from LibraryGenerator -M.\n");
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (arg[0] != '-') {
+      options.manifests.push_back(arg);
+      continue;
+    }
+    if (i + 1 >= argc || arg[2] != '\0')
+      return Usage();
+
+    const char *value = argv[++i];
+    switch (arg[1]) {
+    case 'r':
+      options.minRuns = std::max(1, atoi(value));
+      break;
+    case 'R':
+      options.maxRuns = std::max(1, atoi(value));
+      break;
+    case 't':
+      options.minSeconds = atof(value);
+      break;
+    case 'c':
+      options.onlyCase = value;
+      break;
+    case 'l':
+      options.label = value;
+      break;
+    case 'w':
+      options.workDir = value;
+      break;
+    case 'o':
+      options.output = value;
+      break;
+    default:
+      return Usage();
+    }
+  }
+  if (options.manifests.empty())
+    return Usage();
+  options.maxRuns = std::max(options.maxRuns, options.minRuns);
+
+  mkdir(options.workDir, 0755);
+
+  Runner runner(options);
+  for (const char *manifest : options.manifests)
+    RunLibrary(runner, options, manifest);
+
+  FILE *out = options.output ? fopen(options.output, "w") : stdout;
+  if (!out) {
+    fprintf(stderr, "Cannot write %s\n", options.output);
+    return 1;
+  }
+  WriteJson(out, options, runner.Results());
+  if (out != stdout)
+    fclose(out);
+  return CheckCopyBudgets(runner.Results()) ? 0 : 2;
+}
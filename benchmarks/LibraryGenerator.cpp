@@ -0,0 +1,966 @@
+/**
+ * @file LibraryGenerator.cpp
+ * @brief Generates a reproducible, tagged music library for benchmarks.
+ *
+ * Writes N small but valid audio files (MP3 with ID3v2.4, FLAC, M4A and Ogg
+ * Vorbis) with a realistic spread of tags:
+ * - artists drawn from a Zipf distribution, so a few artists own most albums,
+ * - albums of 8-20 tracks, some spanning two discs,
+ * - compilations with per-track artists,
+ * - missing titles, albums, years and genres, and completely untagged files,
+ * - Unicode in names (accents, Cyrillic, Greek, CJK, emoji),
+ * - embedded covers from none up to 1 MB,
+ * - an Initial/Artist/Album tree, optionally nested deeper.
+ *
+ * Files carry only a few audio frames, but their headers describe tracks of
+ * 1.5-7 minutes, so durations and bitrates look real to tag readers. Covers
+ * are JPEG-framed filler, not decodable images.
+ *
+ * The same seed always produces the same library: all randomness comes from
+ * std::mt19937_64 (whose output the standard fixes) without the standard
+ * distributions (whose output it does not).
+ *
+ * Usage: LibraryGenerator [-n files] [-s seed] [-d depth] [-m manifest] [-M]
+ *        <output directory>
+ *   -n  number of files (default 1000)
+ *   -s  random seed (default 1)
+ *   -d  extra directory levels above the artist folders (default 0)
+ *   -m  also write a tab-separated manifest of every file and its tags
+ *   -M  write only the manifest, no audio files (for in-memory tests)
+ *
+ * Only needs the C++ standard library and POSIX, so LibraryGenerator.make
+ * also builds it on Linux.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static const uint32_t kSampleRate = 44100;
+static const uint32_t kMp3FrameSize = 417; // MPEG-1 L3, 128 kbps, 44.1 kHz
+static const uint32_t kMp3WrittenFrames = 4;
+
+/** @brief Output container of a generated file. */
+enum Format { kMp3, kFlac, kM4a, kOgg };
+
+static const char *kExtensions[] = {"mp3", "flac", "m4a", "ogg"};
+
+/**
+ * @class Random
+ * @brief Seeded random source with distributions defined here, so results do
+ * not depend on the standard library.
+ */
+class Random {
+public:
+  explicit Random(uint64_t seed) : fEngine(seed) {}
+
+  /** @brief Uniform in [0, n). */
+  uint32_t Below(uint32_t n) { return (uint32_t)(fEngine() % n); }
+
+  /** @brief Uniform in [0, 1). */
+  double Unit() { return (fEngine() >> 11) * (1.0 / 9007199254740992.0); }
+
+  bool Chance(double p) { return Unit() < p; }
+
+  template <typename T> const T &Pick(const std::vector<T> &v) {
+    return v[Below((uint32_t)v.size())];
+  }
+
+private:
+  std::mt19937_64 fEngine;
+};
+
+/**
+ * @class Zipf
+ * @brief Draws ranks 0..n-1 with probability proportional to 1/(rank+1)^s.
+ */
+class Zipf {
+public:
+  Zipf(uint32_t n, double s) : fCdf(n) {
+    double sum = 0;
+    for (uint32_t i = 0; i < n; i++)
+      fCdf[i] = (sum += 1.0 / std::pow(i + 1, s));
+    for (double &c : fCdf)
+      c /= sum;
+  }
+
+  uint32_t Draw(Random &random) const {
+    auto it = std::upper_bound(fCdf.begin(), fCdf.end(), random.Unit());
+    return (uint32_t)std::min<size_t>(it - fCdf.begin(), fCdf.size() - 1);
+  }
+
+private:
+  std::vector<double> fCdf;
+};
+
+// ---------------------------------------------------------------------------
+// Names
+
+static const std::vector<std::string> kFirstNames = {
+    "Anna",  "Ben",   "Clara",   "David", "Elif",  "Finn",   "Greta",
+    "Hugo",  "Ines",  "Jonas",   "Kai",   "Lena",  "Mira",   "Noah",
+    "Olga",  "Paul",  "Rosa",    "Sven",  "Tara",  "Zoë",    "José",
+    "Małgorzata",     "Søren",   "Ελένη", "Дмитрий",         "美咲"};
+
+static const std::vector<std::string> kLastNames = {
+    "Berg",   "Clarke",   "Dietrich", "Evans",  "Fischer", "Garcia",
+    "Hansen", "Ito",      "Jensen",   "Kowalski",          "Larsen",
+    "Moreau", "Novak",    "Okafor",   "Peters", "Quinn",   "Rossi",
+    "Müller", "Ångström", "Nuñez",    "Иванова",           "Παππάς",
+    "山田"};
+
+static const std::vector<std::string> kAdjectives = {
+    "Silent", "Electric", "Golden",   "Broken", "Midnight", "Velvet",
+    "Hollow", "Crimson",  "Frozen",   "Wild",   "Distant",  "Northern",
+    "Paper",  "Neon",     "Glass",    "Lost",   "Sacred",   "Quiet",
+    "Bleu",   "Dunkel",   "Schwarze", "Тихий",  "夜の"};
+
+static const std::vector<std::string> kNouns = {
+    "Owls",     "Rivers",  "Machines", "Echoes",  "Gardens", "Wolves",
+    "Harbors",  "Signals", "Mirrors",  "Forests", "Stars",   "Engines",
+    "Lanterns", "Tides",   "Cities",   "Dreams",  "Ghosts",  "Waves",
+    "Café",     "Nächte",  "Fjørd",    "Звёзды",  "Κύματα",  "東京",
+    "Sonic 🎸"};
+
+static const std::vector<std::string> kGenres = {
+    "Rock",      "Pop",     "Electronic", "Jazz",       "Classical",
+    "Hip-Hop",   "Metal",   "Folk",       "Ambient",    "Soul",
+    "Reggae",    "Blues",   "Punk",       "Soundtrack", "Country",
+    "Chanson",   "K-Pop"};
+
+static std::string MakeArtistName(Random &r) {
+  switch (r.Below(4)) {
+  case 0:
+  case 1:
+    return r.Pick(kFirstNames) + " " + r.Pick(kLastNames);
+  case 2:
+    return "The " + r.Pick(kAdjectives) + " " + r.Pick(kNouns);
+  default:
+    return r.Pick(kNouns) + " " + r.Pick(kNouns);
+  }
+}
+
+static std::string MakeTitle(Random &r) {
+  switch (r.Below(5)) {
+  case 0:
+    return r.Pick(kNouns);
+  case 1:
+    return r.Pick(kNouns) + " of " + r.Pick(kNouns);
+  case 2:
+    return r.Pick(kAdjectives) + " " + r.Pick(kNouns) + " (Live)";
+  default:
+    return r.Pick(kAdjectives) + " " + r.Pick(kNouns);
+  }
+}
+
+/** @brief Makes @p name usable as a file or directory name. */
+static std::string SafeName(const std::string &name) {
+  std::string out = name;
+  std::replace(out.begin(), out.end(), '/', '-');
+  if (out.empty() || out[0] == '.')
+    out.insert(0, "_");
+  return out;
+}
+
+// ---------------------------------------------------------------------------
+// Library model
+
+struct Track {
+  std::string title;
+  std::string artist;
+  uint32_t number = 0;
+  uint32_t disc = 1;
+  uint32_t seconds = 0;
+  bool untagged = false;
+  std::string path; ///< Relative to the output directory.
+};
+
+struct Album {
+  std::string title;
+  std::string albumArtist;
+  std::string genre;
+  uint32_t year = 0;
+  uint32_t discs = 1;
+  uint32_t tracksPerDisc = 0;
+  bool compilation = false;
+  Format format = kMp3;
+  Bytes cover;
+  std::vector<Track> tracks;
+};
+
+/**
+ * @brief Filler framed as a JPEG (SOI, JFIF APP0, COM segments, EOI), so
+ * MIME sniffing treats it as one.
+ */
+static Bytes MakeCover(size_t size, Random &r) {
+  Bytes b = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 'J',  'F',  'I',
+             'F',  0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01,
+             0x00, 0x00};
+  while (b.size() + 4 + 2 < size) {
+    size_t chunk = std::min<size_t>(size - b.size() - 4 - 2, 65533);
+    b.push_back(0xFF);
+    b.push_back(0xFE);
+    b.push_back((uint8_t)((chunk + 2) >> 8));
+    b.push_back((uint8_t)(chunk + 2));
+    for (size_t i = 0; i < chunk; i++)
+      b.push_back((uint8_t)r.Below(256));
+  }
+  b.push_back(0xFF);
+  b.push_back(0xD9);
+  return b;
+}
+
+static Album MakeAlbum(Random &r, const std::vector<std::string> &artists,
+                       const Zipf &artistRank, const Zipf &genreRank,
+                       uint32_t trackCount, uint32_t extraDepth) {
+  Album a;
+  a.compilation = r.Chance(0.1);
+  a.albumArtist =
+      a.compilation ? "Various Artists" : artists[artistRank.Draw(r)];
+  a.title = r.Chance(0.03) ? "" : MakeTitle(r);
+  a.genre = r.Chance(0.08) ? "" : kGenres[genreRank.Draw(r)];
+  a.year = r.Chance(0.1) ? 0 : 1955 + r.Below(70);
+  a.discs = trackCount >= 14 && r.Chance(0.1) ? 2 : 1;
+  a.tracksPerDisc = (trackCount + a.discs - 1) / a.discs;
+
+  const double format = r.Unit();
+  a.format = format < 0.5 ? kMp3 : format < 0.75 ? kFlac : format < 0.9 ? kM4a
+                                                                        : kOgg;
+
+  static const size_t kCoverSizes[] = {0, 16 * 1024, 64 * 1024, 256 * 1024,
+                                       1024 * 1024};
+  static const double kCoverWeights[] = {0.35, 0.25, 0.2, 0.15, 0.05};
+  double pick = r.Unit();
+  size_t coverSize = 0;
+  for (int i = 0; i < 5; i++) {
+    if (pick < kCoverWeights[i]) {
+      coverSize = kCoverSizes[i];
+      break;
+    }
+    pick -= kCoverWeights[i];
+  }
+  if (coverSize > 0)
+    a.cover = MakeCover(coverSize, r);
+
+  // Initial/Artist/Year - Album/[CD n/], below optional extra levels
+  std::string dir;
+  for (uint32_t level = 0; level < extraDepth; level++) {
+    char shelf[32];
+    snprintf(shelf, sizeof(shelf), "Shelf %02u/", r.Below(8));
+    dir += shelf;
+  }
+  if (a.compilation) {
+    dir += "Compilations/";
+  } else {
+    std::string initial = a.albumArtist.substr(0, 1);
+    dir += SafeName((uint8_t)initial[0] < 0x80 ? initial : "#") + "/" +
+           SafeName(a.albumArtist) + "/";
+  }
+  char albumDir[32];
+  snprintf(albumDir, sizeof(albumDir), "%04u - ", a.year);
+  dir += albumDir + SafeName(a.title.empty() ? "Unknown Album" : a.title);
+
+  for (uint32_t i = 0; i < trackCount; i++) {
+    Track t;
+    t.disc = 1 + i / a.tracksPerDisc;
+    t.number = 1 + i % a.tracksPerDisc;
+    t.artist = a.compilation ? artists[artistRank.Draw(r)] : a.albumArtist;
+    t.title = r.Chance(0.05) ? "" : MakeTitle(r);
+    t.seconds = 90 + r.Below(331);
+    t.untagged = r.Chance(0.02);
+
+    char name[64];
+    snprintf(name, sizeof(name), "%02u - ", t.number);
+    t.path = dir + "/";
+    if (a.discs > 1)
+      t.path += "CD " + std::to_string(t.disc) + "/";
+    t.path += name + SafeName(t.title.empty() ? "Track" : t.title) + "." +
+              kExtensions[a.format];
+    a.tracks.push_back(t);
+  }
+  return a;
+}
+
+// ---------------------------------------------------------------------------
+// Byte helpers
+
+static void PutBE(Bytes &b, uint64_t v, int bytes) {
+  for (int i = bytes - 1; i >= 0; i--)
+    b.push_back((uint8_t)(v >> (i * 8)));
+}
+
+static void PutLE(Bytes &b, uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; i++)
+    b.push_back((uint8_t)(v >> (i * 8)));
+}
+
+static void PutSyncSafe(Bytes &b, uint32_t v) {
+  b.push_back((v >> 21) & 0x7F);
+  b.push_back((v >> 14) & 0x7F);
+  b.push_back((v >> 7) & 0x7F);
+  b.push_back(v & 0x7F);
+}
+
+static void PutText(Bytes &b, const std::string &s) {
+  b.insert(b.end(), s.begin(), s.end());
+}
+
+static void PutBytes(Bytes &b, const Bytes &data) {
+  b.insert(b.end(), data.begin(), data.end());
+}
+
+static std::string Base64(const Bytes &data) {
+  static const char kAlphabet[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  out.reserve((data.size() + 2) / 3 * 4);
+  for (size_t i = 0; i < data.size(); i += 3) {
+    uint32_t v = data[i] << 16;
+    if (i + 1 < data.size())
+      v |= data[i + 1] << 8;
+    if (i + 2 < data.size())
+      v |= data[i + 2];
+    out += kAlphabet[(v >> 18) & 63];
+    out += kAlphabet[(v >> 12) & 63];
+    out += i + 1 < data.size() ? kAlphabet[(v >> 6) & 63] : '=';
+    out += i + 2 < data.size() ? kAlphabet[v & 63] : '=';
+  }
+  return out;
+}
+
+// ---------------------------------------------------------------------------
+// Writers
+
+/** @brief Vorbis comments shared by FLAC and Ogg Vorbis. */
+static Bytes MakeVorbisComment(const Album &a, const Track &t,
+                               const std::vector<std::string> &extra) {
+  std::vector<std::string> comments;
+  if (!t.untagged) {
+    if (!t.title.empty())
+      comments.push_back("TITLE=" + t.title);
+    comments.push_back("ARTIST=" + t.artist);
+    if (!a.title.empty())
+      comments.push_back("ALBUM=" + a.title);
+    comments.push_back("ALBUMARTIST=" + a.albumArtist);
+    if (!a.genre.empty())
+      comments.push_back("GENRE=" + a.genre);
+    if (a.year)
+      comments.push_back("DATE=" + std::to_string(a.year));
+    comments.push_back("TRACKNUMBER=" + std::to_string(t.number));
+    comments.push_back("TRACKTOTAL=" + std::to_string(a.tracksPerDisc));
+    comments.push_back("DISCNUMBER=" + std::to_string(t.disc));
+    comments.push_back("DISCTOTAL=" + std::to_string(a.discs));
+    if (a.compilation)
+      comments.push_back("COMPILATION=1");
+    comments.insert(comments.end(), extra.begin(), extra.end());
+  }
+
+  Bytes vc;
+  const std::string vendor = "BeTon library generator";
+  PutLE(vc, vendor.size(), 4);
+  PutText(vc, vendor);
+  PutLE(vc, comments.size(), 4);
+  for (const std::string &c : comments) {
+    PutLE(vc, c.size(), 4);
+    PutText(vc, c);
+  }
+  return vc;
+}
+
+/** @brief Body of a FLAC PICTURE block (also used base64'd in Ogg). */
+static Bytes MakeFlacPicture(const Bytes &cover) {
+  Bytes p;
+  PutBE(p, 3, 4); // front cover
+  const std::string mime = "image/jpeg";
+  PutBE(p, mime.size(), 4);
+  PutText(p, mime);
+  PutBE(p, 0, 4);   // description
+  PutBE(p, 500, 4); // width
+  PutBE(p, 500, 4); // height
+  PutBE(p, 24, 4);  // depth
+  PutBE(p, 0, 4);   // colors
+  PutBE(p, cover.size(), 4);
+  PutBytes(p, cover);
+  return p;
+}
+
+static void PutId3TextFrame(Bytes &b, const char *id, const std::string &v) {
+  if (v.empty())
+    return;
+  PutText(b, id);
+  PutSyncSafe(b, (uint32_t)v.size() + 1);
+  b.push_back(0);
+  b.push_back(0);
+  b.push_back(3); // UTF-8
+  PutText(b, v);
+}
+
+static Bytes MakeMp3(const Album &a, const Track &t) {
+  Bytes b;
+  if (!t.untagged) {
+    Bytes frames;
+    PutId3TextFrame(frames, "TIT2", t.title);
+    PutId3TextFrame(frames, "TPE1", t.artist);
+    PutId3TextFrame(frames, "TALB", a.title);
+    PutId3TextFrame(frames, "TPE2", a.albumArtist);
+    PutId3TextFrame(frames, "TCON", a.genre);
+    PutId3TextFrame(frames, "TDRC", a.year ? std::to_string(a.year) : "");
+    PutId3TextFrame(frames, "TRCK", std::to_string(t.number) + "/" +
+                                        std::to_string(a.tracksPerDisc));
+    PutId3TextFrame(frames, "TPOS", std::to_string(t.disc) + "/" +
+                                        std::to_string(a.discs));
+    if (a.compilation)
+      PutId3TextFrame(frames, "TCMP", "1");
+    if (!a.cover.empty()) {
+      Bytes apic;
+      apic.push_back(0); // ISO-8859-1 MIME type and description
+      PutText(apic, "image/jpeg");
+      apic.push_back(0);
+      apic.push_back(3); // front cover
+      apic.push_back(0); // empty description
+      PutBytes(apic, a.cover);
+      PutText(frames, "APIC");
+      PutSyncSafe(frames, (uint32_t)apic.size());
+      frames.push_back(0);
+      frames.push_back(0);
+      PutBytes(frames, apic);
+    }
+    frames.resize(frames.size() + 512, 0); // padding
+
+    PutText(b, "ID3");
+    b.push_back(4);
+    b.push_back(0);
+    b.push_back(0);
+    PutSyncSafe(b, (uint32_t)frames.size());
+    PutBytes(b, frames);
+  }
+
+  // A Xing header describing the full track, followed by a few frames.
+  // Rounded up, so that the length parsers read (truncated to whole
+  // seconds) is exactly the one in the manifest.
+  const uint32_t frameCount = (t.seconds * kSampleRate + 1151) / 1152;
+  const uint8_t header[4] = {0xFF, 0xFB, 0x90, 0x64};
+  for (uint32_t f = 0; f < kMp3WrittenFrames; f++) {
+    size_t start = b.size();
+    b.insert(b.end(), header, header + 4);
+    if (f == 0) {
+      b.resize(start + 4 + 32, 0);
+      PutText(b, "Xing");
+      PutBE(b, 3, 4);
+      PutBE(b, frameCount, 4);
+      PutBE(b, (uint64_t)frameCount * kMp3FrameSize, 4);
+    }
+    b.resize(start + kMp3FrameSize, 0);
+  }
+  return b;
+}
+
+static Bytes MakeFlac(const Album &a, const Track &t) {
+  Bytes b;
+  PutText(b, "fLaC");
+
+  // STREAMINFO
+  b.push_back(0x00);
+  PutBE(b, 34, 3);
+  PutBE(b, 4096, 2);
+  PutBE(b, 4096, 2);
+  PutBE(b, 0, 3);
+  PutBE(b, 0, 3);
+  const uint64_t packed = ((uint64_t)kSampleRate << 44) | (1ULL << 41) |
+                          (15ULL << 36) | ((uint64_t)kSampleRate * t.seconds);
+  PutBE(b, packed, 8);
+  b.resize(b.size() + 16, 0); // MD5
+
+  Bytes vc = MakeVorbisComment(a, t, {});
+  b.push_back(0x04);
+  PutBE(b, vc.size(), 3);
+  PutBytes(b, vc);
+
+  if (!a.cover.empty() && !t.untagged) {
+    Bytes picture = MakeFlacPicture(a.cover);
+    b.push_back(0x06);
+    PutBE(b, picture.size(), 3);
+    PutBytes(b, picture);
+  }
+
+  // PADDING (last block), then placeholder audio
+  b.push_back(0x81);
+  PutBE(b, 1024, 3);
+  b.resize(b.size() + 1024 + 4096, 0);
+  return b;
+}
+
+static void PutBox(Bytes &b, const char *type, const Bytes &payload) {
+  PutBE(b, 8 + payload.size(), 4);
+  b.insert(b.end(), type, type + 4);
+  PutBytes(b, payload);
+}
+
+static void PutIlstItem(Bytes &ilst, const char *type, uint32_t dataType,
+                        const Bytes &value) {
+  Bytes data;
+  PutBE(data, dataType, 4);
+  PutBE(data, 0, 4); // locale
+  PutBytes(data, value);
+  Bytes item;
+  PutBox(item, "data", data);
+  PutBox(ilst, type, item);
+}
+
+static void PutIlstText(Bytes &ilst, const char *type, const std::string &v) {
+  if (!v.empty())
+    PutIlstItem(ilst, type, 1, Bytes(v.begin(), v.end()));
+}
+
+static void PutMatrix(Bytes &b) {
+  const uint32_t matrix[9] = {0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0,
+                              0x40000000};
+  for (uint32_t v : matrix)
+    PutBE(b, v, 4);
+}
+
+static Bytes MakeM4a(const Album &a, const Track &t) {
+  Bytes b;
+  Bytes ftyp;
+  PutText(ftyp, "M4A ");
+  PutBE(ftyp, 0, 4);
+  PutText(ftyp, "M4A mp42isom");
+  PutBox(b, "ftyp", ftyp);
+
+  Bytes mvhd;
+  PutBE(mvhd, 0, 12); // version/flags, creation and modification time
+  PutBE(mvhd, 1000, 4);
+  PutBE(mvhd, t.seconds * 1000, 4);
+  PutBE(mvhd, 0x00010000, 4);
+  PutBE(mvhd, 0x0100, 2);
+  mvhd.resize(mvhd.size() + 10, 0);
+  PutMatrix(mvhd);
+  mvhd.resize(mvhd.size() + 24, 0);
+  PutBE(mvhd, 2, 4);
+
+  Bytes tkhd;
+  PutBE(tkhd, 0x00000007, 4);
+  PutBE(tkhd, 0, 8);
+  PutBE(tkhd, 1, 4); // track ID
+  PutBE(tkhd, 0, 4);
+  PutBE(tkhd, t.seconds * 1000, 4);
+  PutBE(tkhd, 0, 12); // reserved, layer, alternate group
+  PutBE(tkhd, 0x0100, 2);
+  PutBE(tkhd, 0, 2);
+  PutMatrix(tkhd);
+  PutBE(tkhd, 0, 8); // width, height
+
+  Bytes mdhd;
+  PutBE(mdhd, 0, 12);
+  PutBE(mdhd, kSampleRate, 4);
+  PutBE(mdhd, (uint64_t)kSampleRate * t.seconds, 4);
+  PutBE(mdhd, 0x55C4, 2); // "und"
+  PutBE(mdhd, 0, 2);
+
+  Bytes hdlr;
+  PutBE(hdlr, 0, 8);
+  PutText(hdlr, "soun");
+  PutBE(hdlr, 0, 12);
+  hdlr.push_back(0);
+
+  Bytes smhd;
+  PutBE(smhd, 0, 8);
+
+  Bytes url;
+  PutBE(url, 1, 4); // media data is in this file
+  Bytes dref;
+  PutBE(dref, 0, 4);
+  PutBE(dref, 1, 4);
+  PutBox(dref, "url ", url);
+  Bytes dinf;
+  PutBox(dinf, "dref", dref);
+
+  Bytes mp4a;
+  PutBE(mp4a, 0, 6);
+  PutBE(mp4a, 1, 2); // data reference index
+  PutBE(mp4a, 0, 8);
+  PutBE(mp4a, 2, 2);  // channels
+  PutBE(mp4a, 16, 2); // sample size
+  PutBE(mp4a, 0, 4);
+  PutBE(mp4a, (uint64_t)kSampleRate << 16, 4);
+
+  // ES descriptor: AAC LC, 44.1 kHz stereo, 128 kbps
+  const uint8_t esDescriptor[] = {
+      0x03, 25,   0x00, 0x01, 0x00,                         // ES
+      0x04, 17,   0x40, 0x15, 0x00, 0x00, 0x00,             // decoder config
+      0x00, 0x01, 0xF4, 0x00, 0x00, 0x01, 0xF4, 0x00,       // bitrates
+      0x05, 2,    0x12, 0x10,                               // AAC config
+      0x06, 1,    0x02};                                    // SL config
+  Bytes esds;
+  PutBE(esds, 0, 4);
+  esds.insert(esds.end(), esDescriptor,
+              esDescriptor + sizeof(esDescriptor));
+  PutBox(mp4a, "esds", esds);
+
+  Bytes stsd;
+  PutBE(stsd, 0, 4);
+  PutBE(stsd, 1, 4);
+  PutBox(stsd, "mp4a", mp4a);
+
+  Bytes emptyTable;
+  PutBE(emptyTable, 0, 8);
+  Bytes stsz;
+  PutBE(stsz, 0, 12);
+
+  Bytes stbl;
+  PutBox(stbl, "stsd", stsd);
+  PutBox(stbl, "stts", emptyTable);
+  PutBox(stbl, "stsc", emptyTable);
+  PutBox(stbl, "stsz", stsz);
+  PutBox(stbl, "stco", emptyTable);
+
+  Bytes minf;
+  PutBox(minf, "smhd", smhd);
+  PutBox(minf, "dinf", dinf);
+  PutBox(minf, "stbl", stbl);
+
+  Bytes mdia;
+  PutBox(mdia, "mdhd", mdhd);
+  PutBox(mdia, "hdlr", hdlr);
+  PutBox(mdia, "minf", minf);
+
+  Bytes trak;
+  PutBox(trak, "tkhd", tkhd);
+  PutBox(trak, "mdia", mdia);
+
+  Bytes moov;
+  PutBox(moov, "mvhd", mvhd);
+  PutBox(moov, "trak", trak);
+
+  if (!t.untagged) {
+    Bytes ilst;
+    PutIlstText(ilst, "\xA9nam", t.title);
+    PutIlstText(ilst, "\xA9" "ART", t.artist);
+    PutIlstText(ilst, "\xA9" "alb", a.title);
+    PutIlstText(ilst, "aART", a.albumArtist);
+    PutIlstText(ilst, "\xA9gen", a.genre);
+    PutIlstText(ilst, "\xA9" "day", a.year ? std::to_string(a.year) : "");
+
+    Bytes trkn;
+    PutBE(trkn, 0, 2);
+    PutBE(trkn, t.number, 2);
+    PutBE(trkn, a.tracksPerDisc, 2);
+    PutBE(trkn, 0, 2);
+    PutIlstItem(ilst, "trkn", 0, trkn);
+
+    Bytes disk;
+    PutBE(disk, 0, 2);
+    PutBE(disk, t.disc, 2);
+    PutBE(disk, a.discs, 2);
+    PutIlstItem(ilst, "disk", 0, disk);
+
+    if (a.compilation)
+      PutIlstItem(ilst, "cpil", 21, Bytes{1});
+    if (!a.cover.empty())
+      PutIlstItem(ilst, "covr", 13, a.cover);
+
+    Bytes metaHdlr;
+    PutBE(metaHdlr, 0, 8);
+    PutText(metaHdlr, "mdirappl");
+    PutBE(metaHdlr, 0, 8);
+    metaHdlr.push_back(0);
+
+    Bytes meta;
+    PutBE(meta, 0, 4);
+    PutBox(meta, "hdlr", metaHdlr);
+    PutBox(meta, "ilst", ilst);
+    Bytes udta;
+    PutBox(udta, "meta", meta);
+    PutBox(moov, "udta", udta);
+  }
+  PutBox(b, "moov", moov);
+
+  PutBox(b, "mdat", Bytes(4096, 0));
+  return b;
+}
+
+static uint32_t OggCrc(const uint8_t *data, size_t size) {
+  static uint32_t table[256];
+  if (table[1] == 0) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t r = i << 24;
+      for (int bit = 0; bit < 8; bit++)
+        r = (r & 0x80000000) ? (r << 1) ^ 0x04C11DB7 : r << 1;
+      table[i] = r;
+    }
+  }
+
+  uint32_t crc = 0;
+  for (size_t i = 0; i < size; i++)
+    crc = (crc << 8) ^ table[((crc >> 24) ^ data[i]) & 0xFF];
+  return crc;
+}
+
+/**
+ * @class OggWriter
+ * @brief Lays packets out into Ogg pages.
+ */
+class OggWriter {
+public:
+  OggWriter(Bytes &out, uint32_t serial) : fOut(out), fSerial(serial) {}
+
+  /** @brief Appends @p packet, emitting full pages as needed. */
+  void AddPacket(const Bytes &packet) {
+    size_t left = packet.size();
+    const uint8_t *data = packet.data();
+    while (true) {
+      uint8_t lacing = (uint8_t)std::min<size_t>(left, 255);
+      fLacing.push_back(lacing);
+      fBody.insert(fBody.end(), data, data + lacing);
+      data += lacing;
+      left -= lacing;
+      if (lacing < 255) {
+        fPacketEnded = true;
+        break;
+      }
+      if (fLacing.size() == 255)
+        FlushPage(fPacketEnded ? 0 : ~0ULL, false);
+    }
+    if (fLacing.size() == 255)
+      FlushPage(0, false);
+  }
+
+  /** @brief Ends the current page. */
+  void FlushPage(uint64_t granule, bool last) {
+    if (fLacing.empty())
+      return;
+
+    Bytes page;
+    PutText(page, "OggS");
+    page.push_back(0);
+    uint8_t flags = 0;
+    if (fContinued)
+      flags |= 0x01;
+    if (fSequence == 0)
+      flags |= 0x02;
+    if (last)
+      flags |= 0x04;
+    page.push_back(flags);
+    PutLE(page, granule, 8);
+    PutLE(page, fSerial, 4);
+    PutLE(page, fSequence++, 4);
+    PutLE(page, 0, 4); // CRC, filled in below
+    page.push_back((uint8_t)fLacing.size());
+    PutBytes(page, fLacing);
+    PutBytes(page, fBody);
+
+    const uint32_t crc = OggCrc(page.data(), page.size());
+    for (int i = 0; i < 4; i++)
+      page[22 + i] = (uint8_t)(crc >> (i * 8));
+    PutBytes(fOut, page);
+
+    fContinued = fLacing.back() == 255;
+    fLacing.clear();
+    fBody.clear();
+    fPacketEnded = false;
+  }
+
+private:
+  Bytes &fOut;
+  uint32_t fSerial;
+  uint32_t fSequence = 0;
+  Bytes fLacing;
+  Bytes fBody;
+  bool fContinued = false;
+  bool fPacketEnded = false;
+};
+
+static Bytes MakeOgg(const Album &a, const Track &t, uint32_t serial) {
+  Bytes identification;
+  PutText(identification, "\x01vorbis");
+  PutLE(identification, 0, 4);
+  identification.push_back(2);
+  PutLE(identification, kSampleRate, 4);
+  PutLE(identification, 0, 4);
+  PutLE(identification, 128000, 4);
+  PutLE(identification, 0, 4);
+  identification.push_back(0xB8); // block sizes 256/2048
+  identification.push_back(1);
+
+  std::vector<std::string> extra;
+  if (!a.cover.empty())
+    extra.push_back("METADATA_BLOCK_PICTURE=" +
+                    Base64(MakeFlacPicture(a.cover)));
+  Bytes comment;
+  PutText(comment, "\x03vorbis");
+  PutBytes(comment, MakeVorbisComment(a, t, extra));
+  comment.push_back(1);
+
+  Bytes setup;
+  PutText(setup, "\x05vorbis");
+  setup.resize(setup.size() + 32, 0);
+
+  Bytes b;
+  OggWriter ogg(b, serial);
+  ogg.AddPacket(identification);
+  ogg.FlushPage(0, false);
+  ogg.AddPacket(comment);
+  ogg.AddPacket(setup);
+  ogg.FlushPage(0, false);
+  ogg.AddPacket(Bytes(64, 0));
+  ogg.FlushPage((uint64_t)kSampleRate * t.seconds, true);
+  return b;
+}
+
+// ---------------------------------------------------------------------------
+// Output
+
+static bool MakeDirectories(const std::string &path) {
+  for (size_t pos = 1; pos != std::string::npos;) {
+    pos = path.find('/', pos + 1);
+    std::string dir = path.substr(0, pos);
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+      return false;
+  }
+  return true;
+}
+
+static bool WriteFile(const std::string &path, const Bytes &b) {
+  size_t slash = path.rfind('/');
+  if (slash != std::string::npos && !MakeDirectories(path.substr(0, slash)))
+    return false;
+
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(b.data(), 1, b.size(), f) == b.size();
+  fclose(f);
+  return ok;
+}
+
+static void WriteManifestHeader(FILE *f) {
+  fputs("path\tformat\ttitle\tartist\talbum\talbumArtist\tgenre\tyear\t"
+        "track\ttrackTotal\tdisc\tdiscTotal\tcompilation\tseconds\t"
+        "coverBytes\n",
+        f);
+}
+
+static void WriteManifestLine(FILE *f, const Album &a, const Track &t) {
+  if (t.untagged) {
+    fprintf(f, "%s\t%s\t\t\t\t\t\t\t\t\t\t\t\t%u\t0\n", t.path.c_str(),
+            kExtensions[a.format], t.seconds);
+    return;
+  }
+  fprintf(f, "%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%u\t%u\t%u\t%u\t%d\t%u\t%zu\n",
+          t.path.c_str(), kExtensions[a.format], t.title.c_str(),
+          t.artist.c_str(), a.title.c_str(), a.albumArtist.c_str(),
+          a.genre.c_str(), a.year ? std::to_string(a.year).c_str() : "",
+          t.number, a.tracksPerDisc, t.disc, a.discs, a.compilation ? 1 : 0,
+          t.seconds, a.cover.size());
+}
+
+static int Usage() {
+  fprintf(stderr, "Usage: LibraryGenerator [-n files] [-s seed] [-d depth] "
+                  "[-m manifest] [-M] <output directory>\n");
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  uint32_t count = 1000;
+  uint64_t seed = 1;
+  uint32_t extraDepth = 0;
+  const char *manifestPath = nullptr;
+  bool manifestOnly = false;
+
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-'; i++) {
+    const bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "-n") == 0 && hasValue)
+      count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "-s") == 0 && hasValue)
+      seed = strtoull(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "-d") == 0 && hasValue)
+      extraDepth = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "-m") == 0 && hasValue)
+      manifestPath = argv[++i];
+    else if (strcmp(argv[i], "-M") == 0)
+      manifestOnly = true;
+    else
+      return Usage();
+  }
+  if (i + 1 != argc || (manifestOnly && !manifestPath))
+    return Usage();
+  const std::string root = argv[i];
+
+  Random random(seed);
+
+  std::vector<std::string> artists(std::max<uint32_t>(8, count / 30));
+  for (std::string &name : artists)
+    name = MakeArtistName(random);
+  const Zipf artistRank((uint32_t)artists.size(), 1.1);
+  const Zipf genreRank((uint32_t)kGenres.size(), 1.0);
+
+  FILE *manifest = nullptr;
+  if (manifestPath) {
+    manifest = fopen(manifestPath, "w");
+    if (!manifest) {
+      fprintf(stderr, "Cannot write %s\n", manifestPath);
+      return 1;
+    }
+    WriteManifestHeader(manifest);
+  }
+
+  uint32_t written = 0;
+  uint32_t albums = 0;
+  uint64_t bytes = 0;
+  while (written < count) {
+    const uint32_t tracks = std::min(8 + random.Below(13), count - written);
+    const Album album =
+        MakeAlbum(random, artists, artistRank, genreRank, tracks, extraDepth);
+    albums++;
+
+    for (const Track &track : album.tracks) {
+      if (manifest)
+        WriteManifestLine(manifest, album, track);
+      written++;
+      if (manifestOnly)
+        continue;
+
+      Bytes data;
+      switch (album.format) {
+      case kMp3:
+        data = MakeMp3(album, track);
+        break;
+      case kFlac:
+        data = MakeFlac(album, track);
+        break;
+      case kM4a:
+        data = MakeM4a(album, track);
+        break;
+      case kOgg:
+        data = MakeOgg(album, track, written);
+        break;
+      }
+
+      if (!WriteFile(root + "/" + track.path, data)) {
+        fprintf(stderr, "Cannot write %s/%s\n", root.c_str(),
+                track.path.c_str());
+        return 1;
+      }
+      bytes += data.size();
+    }
+  }
+
+  if (manifest)
+    fclose(manifest);
+
+  printf("%u files in %u albums by %zu artists, %.1f MB (seed %llu)\n",
+         written, albums, artists.size(), bytes / (1024.0 * 1024.0),
+         (unsigned long long)seed);
+  return 0;
+}
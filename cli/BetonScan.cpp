@@ -0,0 +1,454 @@
+/**
+ * @file BetonScan.cpp
+ * @brief Headless scanner and cache tool built from BeTon's scan and cache
+ * code.
+ *
+ * Scans directories into a cache file without starting the GUI, and inspects
+ * existing caches:
+ *
+ *     beton-scan scan [options] <cache> <root>...
+ *         -j <n>        read tags in <n> helper processes
+ *         -L            do not follow symbolic links
+ *         -r <MB/s>     limit the read rate
+ *         -x <pattern>  skip directories matching <pattern> (repeatable)
+ *         -v            print progress while scanning
+ *         -T <file>     write a Chrome trace of the scan to <file>
+ *     beton-scan stats <cache>
+ *     beton-scan verify <cache>
+ *     beton-scan compact <cache>
+ *     beton-scan dump <cache>
+ *
+ * Reports and timings go to stderr, so the output of `dump` (a JSON array of
+ * all entries) can be redirected as is. `verify` exits with 1 if any entry is
+ * missing or has changed on disk.
+ *
+ * The scans run on the calling thread through ScanEngine, and the cache is
+ * a plain LibraryStore, so nothing here needs a looper and the tool builds
+ * wherever libbeton-core does. On Haiku tags are read with TagSync (and
+ * TagLib); elsewhere FastTagReader reads those of MP3 and FLAC files, and
+ * `-j` is not available.
+ */
+
+#include "Debug.h"
+#include "LibraryStore.h"
+#include "MediaBatch.h"
+#include "Messages.h"
+#include "ScanEngine.h"
+#include "ScanFilter.h"
+#include "ScanIOGovernor.h"
+#include "ScanMetrics.h"
+#include "Trace.h"
+#ifdef __HAIKU__
+#include "TagParserSandbox.h"
+#include "TagSync.h"
+#endif
+
+#include <File.h>
+#include <Message.h>
+#include <OS.h>
+#include <Path.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <sys/stat.h>
+
+bool gIsDebug = false;
+
+static double Milliseconds(bigtime_t since) {
+  return (system_time() - since) / 1000.0;
+}
+
+/**
+ * @brief Loads the cache at @p cachePath into @p store.
+ * @return false if the file exists but cannot be loaded.
+ */
+static bool LoadCache(const char *cachePath, LibraryStore &store) {
+  bigtime_t start = system_time();
+  status_t status = store.Load(cachePath);
+  if (status != B_OK && status != B_ENTRY_NOT_FOUND) {
+    fprintf(stderr, "Cannot load %s: %s\n", cachePath, strerror(status));
+    return false;
+  }
+  fprintf(stderr, "Loaded %zu entries from %s in %.1f ms\n",
+          store.Entries().size(), cachePath, Milliseconds(start));
+  return true;
+}
+
+/**
+ * @brief Takes the messages a scan sends to the cache, as the CacheManager
+ * does for the app.
+ */
+static status_t StoreScanResult(LibraryStore &store, BMessage &msg) {
+  switch (msg.what) {
+  case MSG_MEDIA_BATCH: {
+    MediaBatchReader batch;
+    status_t status = batch.SetTo(&msg);
+    if (status != B_OK)
+      return status;
+    store.AddBatch(batch, msg.GetString("base", nullptr));
+    break;
+  }
+
+  case MSG_SCAN_FILE_FAILED: {
+    QuarantinedFile bad;
+    bad.size = msg.GetInt64("size", 0);
+    bad.mtime = msg.GetInt64("mtime", 0);
+    bad.reason = msg.GetString("reason", "");
+    store.AddToQuarantine(msg.GetString("path", ""), bad);
+    break;
+  }
+  }
+  return B_OK;
+}
+
+/** @brief Prints the progress and the final report of a scan. */
+static status_t PrintScanStatus(bool verbose, BMessage &msg) {
+  switch (msg.what) {
+  case MSG_SCAN_PROGRESS:
+    if (verbose) {
+      fprintf(stderr, "\r%d folders, %d files, %.0f files/s, %.1f MB/s   ",
+              (int)msg.GetInt32("dirs", 0), (int)msg.GetInt32("files", 0),
+              msg.GetFloat("files_per_sec", 0), msg.GetFloat("mb_per_sec", 0));
+    }
+    break;
+
+  case MSG_SCAN_DONE: {
+    const int64 elapsed = msg.GetInt64("elapsed_sec", 0);
+    fprintf(stderr,
+            "%s%s: %d folders in %02d:%02d, %d quarantined, %d skipped\n",
+            verbose ? "\n" : "", msg.GetString("base", ""),
+            (int)msg.GetInt32("dirs", 0), (int)(elapsed / 60),
+            (int)(elapsed % 60), (int)msg.GetInt32("quarantined", 0),
+            (int)msg.GetInt32("skipped", 0));
+    fputs(ScanMetrics::Describe(msg).String(), stderr);
+    break;
+  }
+  }
+  return B_OK;
+}
+
+static int Usage() {
+  fprintf(stderr,
+          "Usage: beton-scan scan [-j helpers] [-L] [-r MB/s] [-x pattern]... "
+          "[-v] [-T trace] <cache> <root>...\n"
+          "       beton-scan stats|verify|compact|dump <cache>\n");
+  return 2;
+}
+
+static int Scan(int argc, char **argv) {
+  ScanFilter filter;
+  bool verbose = false;
+  int32 helpers = 0;
+  bool followLinks = true;
+  int64 readRate = 0;
+  const char *tracePath = nullptr;
+
+  int i = 0;
+  for (; i < argc && argv[i][0] == '-'; i++) {
+    const char *option = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (strcmp(option, "-j") == 0 && hasValue) {
+      helpers = atoi(argv[++i]);
+    } else if (strcmp(option, "-L") == 0) {
+      followLinks = false;
+    } else if (strcmp(option, "-r") == 0 && hasValue) {
+      readRate = strtoll(argv[++i], nullptr, 10) * 1024 * 1024;
+    } else if (strcmp(option, "-x") == 0 && hasValue) {
+      BString line("exclude ");
+      line << argv[++i];
+      filter.ParseOption(line);
+    } else if (strcmp(option, "-v") == 0) {
+      verbose = true;
+    } else if (strcmp(option, "-T") == 0 && hasValue) {
+      tracePath = argv[++i];
+    } else {
+      return Usage();
+    }
+  }
+  if (argc - i < 2)
+    return Usage();
+
+#ifndef __HAIKU__
+  if (helpers > 0) {
+    fprintf(stderr, "Parser helpers need Haiku, -j is ignored\n");
+    helpers = 0;
+  }
+#endif
+
+  const char *cachePath = argv[i++];
+  std::vector<BString> roots;
+  for (; i < argc; i++) {
+    BPath root(argv[i], nullptr, true);
+    struct stat st;
+    if (root.InitCheck() != B_OK || stat(root.Path(), &st) != 0 ||
+        !S_ISDIR(st.st_mode)) {
+      fprintf(stderr, "Cannot resolve %s\n", argv[i]);
+      return 1;
+    }
+    roots.push_back(root.Path());
+  }
+
+  if (tracePath) {
+#ifdef BETON_TRACE
+    Trace::SetEnabled(true);
+#else
+    fprintf(stderr, "Built without BETON_TRACE, -T is ignored\n");
+    tracePath = nullptr;
+#endif
+  }
+
+  LibraryStore store;
+  if (!LoadCache(cachePath, store))
+    return 1;
+
+  // Same preparation as CacheManager::StartScan()
+  store.RemoveOtherBases(std::set<BString>(roots.begin(), roots.end()));
+  store.MarkMissingFiles();
+  auto governor = std::make_shared<ScanIOGovernor>();
+  governor->SetLimits(readRate, 0);
+
+  bigtime_t start = system_time();
+  for (const BString &root : roots) {
+    ScanEngine engine(root.String());
+    engine.SetTargets(
+        [&store](BMessage &msg) { return StoreScanResult(store, msg); },
+        [verbose](BMessage &msg) { return PrintScanStatus(verbose, msg); });
+    engine.SetCache(store.Entries());
+    engine.SetQuarantine(store.Quarantine());
+    engine.SetIOGovernor(governor);
+    engine.SetFollowLinks(followLinks);
+    engine.SetFilter(filter);
+#ifdef __HAIKU__
+    engine.SetParser([](const BString &path, TagData &out) {
+      TagSync::ReadAll(BPath(path.String()), out);
+    });
+    engine.SetParserHelpers(helpers, [](int32 count, bigtime_t timeout) {
+      return new TagParserSandbox(count, timeout);
+    });
+#endif
+    engine.Run();
+  }
+  // The last progress line follows the report
+  if (verbose)
+    fputc('\n', stderr);
+  fprintf(stderr, "Scanned %zu roots in %.1f s, cache holds %zu entries\n",
+          roots.size(), Milliseconds(start) / 1000.0, store.Entries().size());
+
+  status_t status = store.Save(cachePath);
+  if (status != B_OK) {
+    fprintf(stderr, "Cannot write %s: %s\n", cachePath, strerror(status));
+    return 1;
+  }
+
+#ifdef BETON_TRACE
+  if (tracePath) {
+    status = Trace::Export(tracePath);
+    if (status != B_OK) {
+      fprintf(stderr, "Cannot write %s: %s\n", tracePath, strerror(status));
+      return 1;
+    }
+    fprintf(stderr, "Trace written to %s\n", tracePath);
+  }
+#endif
+  return 0;
+}
+
+static int Stats(const char *cachePath) {
+  LibraryStore store;
+  if (!LoadCache(cachePath, store))
+    return 1;
+
+  int32 missing = 0;
+  int64 bytes = 0;
+  int64 seconds = 0;
+  std::set<BString> bases;
+  std::set<BString> artists;
+  std::set<BString> albums;
+  for (const auto &[path, item] : store.Entries()) {
+    if (item.missing)
+      missing++;
+    bytes += item.size;
+    seconds += item.duration;
+    bases.insert(item.base);
+    artists.insert(item.artist);
+    BString album(item.albumArtist.IsEmpty() ? item.artist : item.albumArtist);
+    album << "\t" << item.album;
+    albums.insert(album);
+  }
+
+  printf("entries      %zu\n", store.Entries().size());
+  printf("missing      %d\n", (int)missing);
+  printf("quarantined  %zu\n", store.Quarantine().size());
+  printf("roots        %zu\n", bases.size());
+  printf("artists      %zu\n", artists.size());
+  printf("albums       %zu\n", albums.size());
+  printf("size         %.1f MB\n", bytes / (1024.0 * 1024.0));
+  printf("duration     %lld h %02lld min\n", (long long)seconds / 3600,
+         (long long)(seconds / 60) % 60);
+
+  return 0;
+}
+
+static int Verify(const char *cachePath) {
+  LibraryStore store;
+  if (!LoadCache(cachePath, store))
+    return 1;
+
+  bigtime_t start = system_time();
+  int32 ok = 0;
+  int32 missing = 0;
+  int32 changed = 0;
+  for (const auto &[path, item] : store.Entries()) {
+    struct stat st;
+    if (stat(path.String(), &st) != 0) {
+      printf("missing  %s\n", path.String());
+      missing++;
+    } else if (st.st_size != item.size || st.st_mtime != item.mtime) {
+      printf("changed  %s\n", path.String());
+      changed++;
+    } else {
+      ok++;
+    }
+  }
+  fprintf(stderr, "%d ok, %d missing, %d changed (%.1f ms)\n", (int)ok,
+          (int)missing, (int)changed, Milliseconds(start));
+
+  return missing + changed > 0 ? 1 : 0;
+}
+
+static int Compact(const char *cachePath) {
+  off_t before = 0;
+  BFile(cachePath, B_READ_ONLY).GetSize(&before);
+
+  LibraryStore store;
+  if (!LoadCache(cachePath, store))
+    return 1;
+  int32 removed = store.Compact();
+
+  bigtime_t start = system_time();
+  status_t status = store.Save(cachePath);
+  if (status != B_OK) {
+    fprintf(stderr, "Cannot write %s: %s\n", cachePath, strerror(status));
+    return 1;
+  }
+
+  off_t after = 0;
+  BFile(cachePath, B_READ_ONLY).GetSize(&after);
+  fprintf(stderr,
+          "Removed %d entries, %lld -> %lld bytes (written in %.1f ms)\n",
+          (int)removed, (long long)before, (long long)after,
+          Milliseconds(start));
+
+  return 0;
+}
+
+/**
+ * @brief Prints @p s as a JSON string literal.
+ *
+ * Tags are stored as UTF-8, so only quotes, backslashes and control
+ * characters need escaping.
+ */
+static void PrintJsonString(const BString &s) {
+  putchar('"');
+  for (const char *c = s.String(); *c; c++) {
+    switch (*c) {
+    case '"':
+      fputs("\\\"", stdout);
+      break;
+    case '\\':
+      fputs("\\\\", stdout);
+      break;
+    case '\n':
+      fputs("\\n", stdout);
+      break;
+    case '\t':
+      fputs("\\t", stdout);
+      break;
+    default:
+      if ((uint8)*c < 0x20)
+        printf("\\u%04x", (unsigned)(uint8)*c);
+      else
+        putchar(*c);
+    }
+  }
+  putchar('"');
+}
+
+static void PrintJsonField(const char *name, const BString &value) {
+  printf(",\n    \"%s\": ", name);
+  PrintJsonString(value);
+}
+
+static void PrintJsonField(const char *name, int64 value) {
+  printf(",\n    \"%s\": %lld", name, (long long)value);
+}
+
+static int Dump(const char *cachePath) {
+  LibraryStore store;
+  if (!LoadCache(cachePath, store))
+    return 1;
+
+  printf("[");
+  bool first = true;
+  for (const auto &[path, item] : store.Entries()) {
+    printf(first ? "\n  {\n    \"path\": " : ",\n  {\n    \"path\": ");
+    first = false;
+    PrintJsonString(item.path);
+    PrintJsonField("base", item.base);
+    PrintJsonField("title", item.title);
+    PrintJsonField("artist", item.artist);
+    PrintJsonField("album", item.album);
+    PrintJsonField("albumArtist", item.albumArtist);
+    PrintJsonField("composer", item.composer);
+    PrintJsonField("genre", item.genre);
+    PrintJsonField("comment", item.comment);
+    PrintJsonField("year", item.year);
+    PrintJsonField("track", item.track);
+    PrintJsonField("trackTotal", item.trackTotal);
+    PrintJsonField("disc", item.disc);
+    PrintJsonField("discTotal", item.discTotal);
+    PrintJsonField("duration", item.duration);
+    PrintJsonField("bitrate", item.bitrate);
+    PrintJsonField("sampleRate", item.sampleRate);
+    PrintJsonField("channels", item.channels);
+    PrintJsonField("size", item.size);
+    PrintJsonField("mtime", item.mtime);
+    PrintJsonField("inode", item.inode);
+    PrintJsonField("mbTrackId", item.mbTrackId);
+    PrintJsonField("mbAlbumId", item.mbAlbumId);
+    PrintJsonField("mbArtistId", item.mbArtistId);
+    printf(",\n    \"missing\": %s\n  }", item.missing ? "true" : "false");
+  }
+  printf("\n]\n");
+
+  return 0;
+}
+
+int main(int argc, char **argv) {
+#ifdef __HAIKU__
+  // Tag parser helper spawned by a scan with -j, see TagParserSandbox
+  if (argc == 3 && strcmp(argv[1], TagParserSandbox::kHelperArgument) == 0)
+    return TagParserSandbox::RunHelper(atoi(argv[2]));
+#endif
+
+  if (argc < 3)
+    return Usage();
+
+  const char *command = argv[1];
+  if (strcmp(command, "scan") == 0)
+    return Scan(argc - 2, argv + 2);
+  if (argc != 3)
+    return Usage();
+  if (strcmp(command, "stats") == 0)
+    return Stats(argv[2]);
+  if (strcmp(command, "verify") == 0)
+    return Verify(argv[2]);
+  if (strcmp(command, "compact") == 0)
+    return Compact(argv[2]);
+  if (strcmp(command, "dump") == 0)
+    return Dump(argv[2]);
+  return Usage();
+}
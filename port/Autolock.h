@@ -0,0 +1,25 @@
+#ifndef BETON_PORT_AUTOLOCK_H
+#define BETON_PORT_AUTOLOCK_H
+
+#include <Locker.h>
+
+/**
+ * @class BAutolock
+ * @brief Holds a BLocker for the lifetime of the object.
+ */
+class BAutolock {
+public:
+  explicit BAutolock(BLocker &locker) : fLocker(&locker) { fLocker->Lock(); }
+  explicit BAutolock(BLocker *locker) : fLocker(locker) { fLocker->Lock(); }
+  ~BAutolock() { fLocker->Unlock(); }
+
+  bool IsLocked() const { return true; }
+
+  BAutolock(const BAutolock &) = delete;
+  BAutolock &operator=(const BAutolock &) = delete;
+
+private:
+  BLocker *fLocker;
+};
+
+#endif // BETON_PORT_AUTOLOCK_H
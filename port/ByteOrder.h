@@ -0,0 +1,34 @@
+#ifndef BETON_PORT_BYTE_ORDER_H
+#define BETON_PORT_BYTE_ORDER_H
+
+#include <SupportDefs.h>
+
+/**
+ * @file ByteOrder.h
+ * @brief The byte order macros of Haiku's <ByteOrder.h> that the core uses,
+ * for files that must read the same on every platform.
+ */
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define B_HOST_IS_LENDIAN 1
+#define B_HOST_IS_BENDIAN 0
+#else
+#define B_HOST_IS_LENDIAN 0
+#define B_HOST_IS_BENDIAN 1
+#endif
+
+#if B_HOST_IS_LENDIAN
+#define B_HOST_TO_LENDIAN_INT16(arg) (uint16)(arg)
+#define B_HOST_TO_LENDIAN_INT32(arg) (uint32)(arg)
+#define B_HOST_TO_LENDIAN_INT64(arg) (uint64)(arg)
+#else
+#define B_HOST_TO_LENDIAN_INT16(arg) __builtin_bswap16((uint16)(arg))
+#define B_HOST_TO_LENDIAN_INT32(arg) __builtin_bswap32((uint32)(arg))
+#define B_HOST_TO_LENDIAN_INT64(arg) __builtin_bswap64((uint64)(arg))
+#endif
+
+#define B_LENDIAN_TO_HOST_INT16(arg) B_HOST_TO_LENDIAN_INT16(arg)
+#define B_LENDIAN_TO_HOST_INT32(arg) B_HOST_TO_LENDIAN_INT32(arg)
+#define B_LENDIAN_TO_HOST_INT64(arg) B_HOST_TO_LENDIAN_INT64(arg)
+
+#endif // BETON_PORT_BYTE_ORDER_H
@@ -0,0 +1,33 @@
+#ifndef BETON_PORT_DATA_IO_H
+#define BETON_PORT_DATA_IO_H
+
+#include <SupportDefs.h>
+
+/**
+ * @class BDataIO
+ * @brief A stream of bytes that can be read and written.
+ */
+class BDataIO {
+public:
+  virtual ~BDataIO() = default;
+
+  /** @return Bytes read, 0 at the end, or a negative error code. */
+  virtual ssize_t Read(void *buffer, size_t size) = 0;
+  virtual ssize_t Write(const void *buffer, size_t size) = 0;
+};
+
+/**
+ * @class BPositionIO
+ * @brief A BDataIO with a file position.
+ */
+class BPositionIO : public BDataIO {
+public:
+  virtual ssize_t ReadAt(off_t position, void *buffer, size_t size) = 0;
+  virtual ssize_t WriteAt(off_t position, const void *buffer,
+                          size_t size) = 0;
+  virtual off_t Seek(off_t position, uint32 seekMode) = 0;
+  virtual off_t Position() const = 0;
+  virtual status_t GetSize(off_t *size) const = 0;
+};
+
+#endif // BETON_PORT_DATA_IO_H
@@ -0,0 +1,32 @@
+#ifndef BETON_PORT_ENTRY_H
+#define BETON_PORT_ENTRY_H
+
+#include <Path.h>
+
+/**
+ * @class BEntry
+ * @brief A location in the file system, which may or may not exist.
+ */
+class BEntry {
+public:
+  BEntry() = default;
+  explicit BEntry(const char *path, bool traverse = false) {
+    SetTo(path, traverse);
+  }
+
+  /** @param traverse Accepted for compatibility; links are not resolved. */
+  status_t SetTo(const char *path, bool traverse = false);
+  status_t InitCheck() const { return fPath.InitCheck(); }
+
+  bool Exists() const;
+  bool IsDirectory() const;
+  status_t GetPath(BPath *path) const;
+
+  /** @brief Deletes the file or (empty) directory. */
+  status_t Remove();
+
+private:
+  BPath fPath;
+};
+
+#endif // BETON_PORT_ENTRY_H
@@ -0,0 +1,46 @@
+#ifndef BETON_PORT_FILE_H
+#define BETON_PORT_FILE_H
+
+#include <DataIO.h>
+#include <StorageDefs.h>
+
+#include <stdio.h>
+
+/**
+ * @class BFile
+ * @brief A file opened with one of the B_READ_ONLY... open modes.
+ *
+ * Reads and writes go straight to the file descriptor, unbuffered, as on
+ * Haiku.
+ */
+class BFile : public BPositionIO {
+public:
+  BFile() = default;
+  BFile(const char *path, uint32 openMode) { SetTo(path, openMode); }
+  ~BFile() override { Unset(); }
+
+  status_t SetTo(const char *path, uint32 openMode);
+  void Unset();
+  status_t InitCheck() const { return fInitStatus; }
+
+  ssize_t Read(void *buffer, size_t size) override;
+  ssize_t Write(const void *buffer, size_t size) override;
+  ssize_t ReadAt(off_t position, void *buffer, size_t size) override;
+  ssize_t WriteAt(off_t position, const void *buffer, size_t size) override;
+  off_t Seek(off_t position, uint32 seekMode) override;
+  off_t Position() const override;
+  status_t GetSize(off_t *size) const override;
+  status_t SetSize(off_t size);
+
+  /** @brief Flushes the file to disk. */
+  status_t Sync();
+
+  BFile(const BFile &) = delete;
+  BFile &operator=(const BFile &) = delete;
+
+private:
+  int fFD = -1;
+  status_t fInitStatus = B_NO_INIT;
+};
+
+#endif // BETON_PORT_FILE_H
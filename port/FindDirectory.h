@@ -0,0 +1,32 @@
+#ifndef BETON_PORT_FIND_DIRECTORY_H
+#define BETON_PORT_FIND_DIRECTORY_H
+
+#include <Path.h>
+
+/**
+ * @brief The directories BeTon looks up, mapped to the XDG base directories:
+ *
+ * | Haiku                      | Here                                  |
+ * |----------------------------|---------------------------------------|
+ * | B_USER_SETTINGS_DIRECTORY  | $XDG_CONFIG_HOME or ~/.config         |
+ * | B_USER_CACHE_DIRECTORY     | $XDG_CACHE_HOME or ~/.cache           |
+ * | B_USER_LOG_DIRECTORY       | $XDG_STATE_HOME or ~/.local/state     |
+ * | B_SYSTEM_TEMP_DIRECTORY    | $TMPDIR or /tmp                       |
+ */
+enum directory_which {
+  B_USER_SETTINGS_DIRECTORY,
+  B_USER_CACHE_DIRECTORY,
+  B_USER_LOG_DIRECTORY,
+  B_SYSTEM_TEMP_DIRECTORY,
+};
+
+class BVolume;
+
+/**
+ * @param createIt Creates the directory and its parents if missing.
+ * @param volume Ignored.
+ */
+status_t find_directory(directory_which which, BPath *path,
+                        bool createIt = false, BVolume *volume = nullptr);
+
+#endif // BETON_PORT_FIND_DIRECTORY_H
@@ -0,0 +1,26 @@
+#ifndef BETON_PORT_LOCKER_H
+#define BETON_PORT_LOCKER_H
+
+#include <SupportDefs.h>
+
+#include <mutex>
+
+/**
+ * @class BLocker
+ * @brief Recursive lock, like Haiku's default BLocker.
+ */
+class BLocker {
+public:
+  explicit BLocker(const char *name = nullptr) { (void)name; }
+
+  bool Lock() {
+    fMutex.lock();
+    return true;
+  }
+  void Unlock() { fMutex.unlock(); }
+
+private:
+  std::recursive_mutex fMutex;
+};
+
+#endif // BETON_PORT_LOCKER_H
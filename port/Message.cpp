@@ -0,0 +1,588 @@
+#include <DataIO.h>
+#include <Message.h>
+
+#include <string.h>
+
+/**
+ * Flattened layout, in host byte order:
+ *
+ *     uint32 magic, uint32 what, uint64 body size
+ *     body: uint32 field count, then per field
+ *           uint32 type, uint32 name length, name,
+ *           uint32 value count, then per value uint32 size, bytes
+ */
+static const uint32 kMagic = 'BTm1';
+static const size_t kHeaderSize = 16;
+
+/// Larger bodies are taken for corruption rather than allocated.
+static const uint64 kMaxBodySize = 1ULL << 30;
+
+// Finding and adding fields
+
+const BMessage::Field *BMessage::_FindField(const char *name) const {
+  if (!name)
+    return nullptr;
+  for (const Field &field : fFields) {
+    if (field.name == name)
+      return &field;
+  }
+  return nullptr;
+}
+
+status_t BMessage::_FindValue(const char *name, type_code type, int32 index,
+                              const std::string **value) const {
+  const Field *field = _FindField(name);
+  if (!field)
+    return B_NAME_NOT_FOUND;
+  if (type != B_ANY_TYPE && field->type != type)
+    return B_BAD_TYPE;
+  if (index < 0 || (size_t)index >= field->values.size())
+    return B_BAD_INDEX;
+  *value = &field->values[index];
+  return B_OK;
+}
+
+status_t BMessage::_AddValue(const char *name, type_code type,
+                             const void *data, size_t size) {
+  if (!name || !*name)
+    return B_BAD_VALUE;
+
+  Field *field = const_cast<Field *>(_FindField(name));
+  if (!field) {
+    fFields.push_back(Field{name, type, {}});
+    field = &fFields.back();
+  } else if (field->type != type) {
+    return B_BAD_TYPE;
+  }
+  field->values.emplace_back((const char *)data, size);
+  return B_OK;
+}
+
+status_t BMessage::_SetValue(const char *name, type_code type,
+                             const void *data, size_t size) {
+  Field *field = const_cast<Field *>(_FindField(name));
+  if (!field)
+    return _AddValue(name, type, data, size);
+  if (field->type != type)
+    return B_BAD_TYPE;
+  field->values[0].assign((const char *)data, size);
+  return B_OK;
+}
+
+template <typename T>
+status_t BMessage::_FindFixed(const char *name, type_code type, int32 index,
+                              T *value) const {
+  const std::string *data;
+  status_t status = _FindValue(name, type, index, &data);
+  if (status != B_OK)
+    return status;
+  if (data->size() != sizeof(T))
+    return B_BAD_DATA;
+  memcpy(value, data->data(), sizeof(T));
+  return B_OK;
+}
+
+// Adding data
+
+status_t BMessage::AddString(const char *name, const char *string) {
+  if (!string)
+    string = "";
+  return _AddValue(name, B_STRING_TYPE, string, strlen(string) + 1);
+}
+
+status_t BMessage::AddString(const char *name, const BString &string) {
+  return _AddValue(name, B_STRING_TYPE, string.String(), string.Length() + 1);
+}
+
+status_t BMessage::AddInt8(const char *name, int8 value) {
+  return _AddValue(name, B_INT8_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::AddInt16(const char *name, int16 value) {
+  return _AddValue(name, B_INT16_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::AddInt32(const char *name, int32 value) {
+  return _AddValue(name, B_INT32_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::AddUInt32(const char *name, uint32 value) {
+  return _AddValue(name, B_UINT32_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::AddInt64(const char *name, int64 value) {
+  return _AddValue(name, B_INT64_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::AddUInt64(const char *name, uint64 value) {
+  return _AddValue(name, B_UINT64_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::AddBool(const char *name, bool value) {
+  const uint8 byte = value ? 1 : 0;
+  return _AddValue(name, B_BOOL_TYPE, &byte, sizeof(byte));
+}
+
+status_t BMessage::AddFloat(const char *name, float value) {
+  return _AddValue(name, B_FLOAT_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::AddDouble(const char *name, double value) {
+  return _AddValue(name, B_DOUBLE_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::AddMessage(const char *name, const BMessage *message) {
+  if (!message)
+    return B_BAD_VALUE;
+  std::string flat;
+  message->_FlattenInto(flat);
+  return _AddValue(name, B_MESSAGE_TYPE, flat.data(), flat.size());
+}
+
+status_t BMessage::AddData(const char *name, type_code type, const void *data,
+                           ssize_t numBytes, bool, int32) {
+  if (numBytes < 0 || (!data && numBytes > 0) || type == B_ANY_TYPE)
+    return B_BAD_VALUE;
+  return _AddValue(name, type, data, numBytes);
+}
+
+// Finding data
+
+status_t BMessage::FindString(const char *name, const char **string) const {
+  return FindString(name, 0, string);
+}
+
+status_t BMessage::FindString(const char *name, int32 index,
+                              const char **string) const {
+  const std::string *data;
+  status_t status = _FindValue(name, B_STRING_TYPE, index, &data);
+  if (status == B_OK)
+    *string = data->c_str();
+  return status;
+}
+
+status_t BMessage::FindString(const char *name, BString *string) const {
+  return FindString(name, 0, string);
+}
+
+status_t BMessage::FindString(const char *name, int32 index,
+                              BString *string) const {
+  const char *value;
+  status_t status = FindString(name, index, &value);
+  if (status == B_OK)
+    string->SetTo(value);
+  return status;
+}
+
+status_t BMessage::FindInt8(const char *name, int8 *value) const {
+  return _FindFixed(name, B_INT8_TYPE, 0, value);
+}
+
+status_t BMessage::FindInt8(const char *name, int32 index, int8 *value) const {
+  return _FindFixed(name, B_INT8_TYPE, index, value);
+}
+
+status_t BMessage::FindInt16(const char *name, int16 *value) const {
+  return _FindFixed(name, B_INT16_TYPE, 0, value);
+}
+
+status_t BMessage::FindInt16(const char *name, int32 index,
+                             int16 *value) const {
+  return _FindFixed(name, B_INT16_TYPE, index, value);
+}
+
+status_t BMessage::FindInt32(const char *name, int32 *value) const {
+  return _FindFixed(name, B_INT32_TYPE, 0, value);
+}
+
+status_t BMessage::FindInt32(const char *name, int32 index,
+                             int32 *value) const {
+  return _FindFixed(name, B_INT32_TYPE, index, value);
+}
+
+status_t BMessage::FindUInt32(const char *name, uint32 *value) const {
+  return _FindFixed(name, B_UINT32_TYPE, 0, value);
+}
+
+status_t BMessage::FindUInt32(const char *name, int32 index,
+                              uint32 *value) const {
+  return _FindFixed(name, B_UINT32_TYPE, index, value);
+}
+
+status_t BMessage::FindInt64(const char *name, int64 *value) const {
+  return _FindFixed(name, B_INT64_TYPE, 0, value);
+}
+
+status_t BMessage::FindInt64(const char *name, int32 index,
+                             int64 *value) const {
+  return _FindFixed(name, B_INT64_TYPE, index, value);
+}
+
+status_t BMessage::FindUInt64(const char *name, uint64 *value) const {
+  return _FindFixed(name, B_UINT64_TYPE, 0, value);
+}
+
+status_t BMessage::FindUInt64(const char *name, int32 index,
+                              uint64 *value) const {
+  return _FindFixed(name, B_UINT64_TYPE, index, value);
+}
+
+status_t BMessage::FindBool(const char *name, bool *value) const {
+  return FindBool(name, 0, value);
+}
+
+status_t BMessage::FindBool(const char *name, int32 index, bool *value) const {
+  uint8 byte;
+  status_t status = _FindFixed(name, B_BOOL_TYPE, index, &byte);
+  if (status == B_OK)
+    *value = byte != 0;
+  return status;
+}
+
+status_t BMessage::FindFloat(const char *name, float *value) const {
+  return _FindFixed(name, B_FLOAT_TYPE, 0, value);
+}
+
+status_t BMessage::FindFloat(const char *name, int32 index,
+                             float *value) const {
+  return _FindFixed(name, B_FLOAT_TYPE, index, value);
+}
+
+status_t BMessage::FindDouble(const char *name, double *value) const {
+  return _FindFixed(name, B_DOUBLE_TYPE, 0, value);
+}
+
+status_t BMessage::FindDouble(const char *name, int32 index,
+                              double *value) const {
+  return _FindFixed(name, B_DOUBLE_TYPE, index, value);
+}
+
+status_t BMessage::FindMessage(const char *name, BMessage *message) const {
+  return FindMessage(name, 0, message);
+}
+
+status_t BMessage::FindMessage(const char *name, int32 index,
+                               BMessage *message) const {
+  const std::string *data;
+  status_t status = _FindValue(name, B_MESSAGE_TYPE, index, &data);
+  if (status != B_OK)
+    return status;
+  return message->Unflatten(data->data());
+}
+
+status_t BMessage::FindData(const char *name, type_code type,
+                            const void **data, ssize_t *numBytes) const {
+  return FindData(name, type, 0, data, numBytes);
+}
+
+status_t BMessage::FindData(const char *name, type_code type, int32 index,
+                            const void **data, ssize_t *numBytes) const {
+  const std::string *value;
+  status_t status = _FindValue(name, type, index, &value);
+  if (status != B_OK)
+    return status;
+  *data = value->data();
+  *numBytes = value->size();
+  return B_OK;
+}
+
+// Getting data with a default
+
+const char *BMessage::GetString(const char *name,
+                                const char *defaultValue) const {
+  return GetString(name, 0, defaultValue);
+}
+
+const char *BMessage::GetString(const char *name, int32 index,
+                                const char *defaultValue) const {
+  const char *value;
+  return FindString(name, index, &value) == B_OK ? value : defaultValue;
+}
+
+int32 BMessage::GetInt32(const char *name, int32 defaultValue) const {
+  return GetInt32(name, 0, defaultValue);
+}
+
+int32 BMessage::GetInt32(const char *name, int32 index,
+                         int32 defaultValue) const {
+  int32 value;
+  return FindInt32(name, index, &value) == B_OK ? value : defaultValue;
+}
+
+uint32 BMessage::GetUInt32(const char *name, uint32 defaultValue) const {
+  uint32 value;
+  return FindUInt32(name, &value) == B_OK ? value : defaultValue;
+}
+
+int64 BMessage::GetInt64(const char *name, int64 defaultValue) const {
+  int64 value;
+  return FindInt64(name, &value) == B_OK ? value : defaultValue;
+}
+
+uint64 BMessage::GetUInt64(const char *name, uint64 defaultValue) const {
+  uint64 value;
+  return FindUInt64(name, &value) == B_OK ? value : defaultValue;
+}
+
+bool BMessage::GetBool(const char *name, bool defaultValue) const {
+  bool value;
+  return FindBool(name, &value) == B_OK ? value : defaultValue;
+}
+
+float BMessage::GetFloat(const char *name, float defaultValue) const {
+  float value;
+  return FindFloat(name, &value) == B_OK ? value : defaultValue;
+}
+
+double BMessage::GetDouble(const char *name, double defaultValue) const {
+  double value;
+  return FindDouble(name, &value) == B_OK ? value : defaultValue;
+}
+
+// Replacing data
+
+status_t BMessage::SetString(const char *name, const char *string) {
+  if (!string)
+    string = "";
+  return _SetValue(name, B_STRING_TYPE, string, strlen(string) + 1);
+}
+
+status_t BMessage::SetString(const char *name, const BString &string) {
+  return _SetValue(name, B_STRING_TYPE, string.String(), string.Length() + 1);
+}
+
+status_t BMessage::SetInt32(const char *name, int32 value) {
+  return _SetValue(name, B_INT32_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::SetInt64(const char *name, int64 value) {
+  return _SetValue(name, B_INT64_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::SetBool(const char *name, bool value) {
+  const uint8 byte = value ? 1 : 0;
+  return _SetValue(name, B_BOOL_TYPE, &byte, sizeof(byte));
+}
+
+status_t BMessage::SetFloat(const char *name, float value) {
+  return _SetValue(name, B_FLOAT_TYPE, &value, sizeof(value));
+}
+
+status_t BMessage::SetDouble(const char *name, double value) {
+  return _SetValue(name, B_DOUBLE_TYPE, &value, sizeof(value));
+}
+
+// Fields
+
+status_t BMessage::GetInfo(const char *name, type_code *type,
+                           int32 *count) const {
+  const Field *field = _FindField(name);
+  if (!field)
+    return B_NAME_NOT_FOUND;
+  if (type)
+    *type = field->type;
+  if (count)
+    *count = (int32)field->values.size();
+  return B_OK;
+}
+
+int32 BMessage::CountNames(type_code type) const {
+  int32 count = 0;
+  for (const Field &field : fFields) {
+    if (type == B_ANY_TYPE || field.type == type)
+      count++;
+  }
+  return count;
+}
+
+bool BMessage::HasString(const char *name, int32 index) const {
+  const std::string *value;
+  return _FindValue(name, B_STRING_TYPE, index, &value) == B_OK;
+}
+
+status_t BMessage::RemoveName(const char *name) {
+  const Field *field = _FindField(name);
+  if (!field)
+    return B_NAME_NOT_FOUND;
+  fFields.erase(fFields.begin() + (field - fFields.data()));
+  return B_OK;
+}
+
+status_t BMessage::RemoveData(const char *name, int32 index) {
+  Field *field = const_cast<Field *>(_FindField(name));
+  if (!field)
+    return B_NAME_NOT_FOUND;
+  if (index < 0 || (size_t)index >= field->values.size())
+    return B_BAD_INDEX;
+  field->values.erase(field->values.begin() + index);
+  if (field->values.empty())
+    return RemoveName(name);
+  return B_OK;
+}
+
+status_t BMessage::MakeEmpty() {
+  fFields.clear();
+  return B_OK;
+}
+
+// Flattening
+
+static void AppendUInt32(std::string &out, uint32 value) {
+  out.append((const char *)&value, sizeof(value));
+}
+
+void BMessage::_FlattenInto(std::string &out) const {
+  const size_t start = out.size();
+  AppendUInt32(out, kMagic);
+  AppendUInt32(out, what);
+  const uint64 placeholder = 0;
+  out.append((const char *)&placeholder, sizeof(placeholder));
+
+  AppendUInt32(out, (uint32)fFields.size());
+  for (const Field &field : fFields) {
+    AppendUInt32(out, field.type);
+    AppendUInt32(out, (uint32)field.name.size());
+    out += field.name;
+    AppendUInt32(out, (uint32)field.values.size());
+    for (const std::string &value : field.values) {
+      AppendUInt32(out, (uint32)value.size());
+      out += value;
+    }
+  }
+
+  const uint64 bodySize = out.size() - start - kHeaderSize;
+  memcpy(&out[start + 8], &bodySize, sizeof(bodySize));
+}
+
+ssize_t BMessage::FlattenedSize() const {
+  size_t size = kHeaderSize + sizeof(uint32);
+  for (const Field &field : fFields) {
+    size += 3 * sizeof(uint32) + field.name.size();
+    for (const std::string &value : field.values)
+      size += sizeof(uint32) + value.size();
+  }
+  return size;
+}
+
+status_t BMessage::Flatten(char *buffer, ssize_t size) const {
+  std::string flat;
+  _FlattenInto(flat);
+  if ((size_t)size < flat.size())
+    return B_BAD_VALUE;
+  memcpy(buffer, flat.data(), flat.size());
+  return B_OK;
+}
+
+status_t BMessage::Flatten(BDataIO *stream, ssize_t *size) const {
+  std::string flat;
+  _FlattenInto(flat);
+
+  size_t written = 0;
+  while (written < flat.size()) {
+    ssize_t bytes = stream->Write(flat.data() + written, flat.size() - written);
+    if (bytes <= 0)
+      return bytes < 0 ? (status_t)bytes : B_IO_ERROR;
+    written += bytes;
+  }
+  if (size)
+    *size = written;
+  return B_OK;
+}
+
+/**
+ * @brief Reads the fields of a flattened message.
+ * @param data The body, after the header.
+ */
+status_t BMessage::_UnflattenBody(const char *data, size_t size) {
+  const char *end = data + size;
+  auto readUInt32 = [&](uint32 &value) {
+    if ((size_t)(end - data) < sizeof(value))
+      return false;
+    memcpy(&value, data, sizeof(value));
+    data += sizeof(value);
+    return true;
+  };
+  auto readBytes = [&](std::string &value, uint32 length) {
+    if ((size_t)(end - data) < length)
+      return false;
+    value.assign(data, length);
+    data += length;
+    return true;
+  };
+
+  uint32 fieldCount;
+  if (!readUInt32(fieldCount))
+    return B_BAD_DATA;
+
+  fFields.clear();
+  fFields.reserve(fieldCount);
+  for (uint32 i = 0; i < fieldCount; i++) {
+    Field field;
+    uint32 nameLength;
+    uint32 valueCount;
+    if (!readUInt32(field.type) || !readUInt32(nameLength) ||
+        !readBytes(field.name, nameLength) || !readUInt32(valueCount) ||
+        valueCount > (size_t)(end - data) / sizeof(uint32)) {
+      fFields.clear();
+      return B_BAD_DATA;
+    }
+
+    field.values.resize(valueCount);
+    for (std::string &value : field.values) {
+      uint32 valueSize;
+      if (!readUInt32(valueSize) || !readBytes(value, valueSize)) {
+        fFields.clear();
+        return B_BAD_DATA;
+      }
+    }
+    fFields.push_back(std::move(field));
+  }
+  return data == end ? B_OK : B_BAD_DATA;
+}
+
+status_t BMessage::Unflatten(const char *flatBuffer) {
+  uint32 magic;
+  uint64 bodySize;
+  memcpy(&magic, flatBuffer, sizeof(magic));
+  if (magic != kMagic)
+    return B_BAD_VALUE;
+  memcpy(&what, flatBuffer + 4, sizeof(what));
+  memcpy(&bodySize, flatBuffer + 8, sizeof(bodySize));
+  return _UnflattenBody(flatBuffer + kHeaderSize, bodySize);
+}
+
+status_t BMessage::Unflatten(BDataIO *stream) {
+  auto readFully = [stream](void *buffer, size_t size) -> status_t {
+    size_t done = 0;
+    while (done < size) {
+      ssize_t bytes = stream->Read((char *)buffer + done, size - done);
+      if (bytes <= 0)
+        return bytes < 0 ? (status_t)bytes : B_BAD_DATA;
+      done += bytes;
+    }
+    return B_OK;
+  };
+
+  char header[kHeaderSize];
+  status_t status = readFully(header, sizeof(header));
+  if (status != B_OK)
+    return status;
+
+  uint32 magic;
+  uint64 bodySize;
+  memcpy(&magic, header, sizeof(magic));
+  if (magic != kMagic)
+    return B_BAD_VALUE;
+  memcpy(&bodySize, header + 8, sizeof(bodySize));
+  if (bodySize > kMaxBodySize)
+    return B_BAD_DATA;
+
+  std::string body;
+  body.resize(bodySize);
+  status = readFully(&body[0], bodySize);
+  if (status != B_OK)
+    return status;
+
+  memcpy(&what, header + 4, sizeof(what));
+  return _UnflattenBody(body.data(), body.size());
+}
@@ -0,0 +1,164 @@
+#ifndef BETON_PORT_MESSAGE_H
+#define BETON_PORT_MESSAGE_H
+
+#include <String.h>
+#include <SupportDefs.h>
+#include <TypeConstants.h>
+
+#include <string>
+#include <vector>
+
+class BDataIO;
+
+/**
+ * @class BMessage
+ * @brief A command code plus named, typed fields, each holding one or more
+ * values.
+ *
+ * Only the data container is provided, for the cache and batch formats;
+ * there is no messaging. The flattened form is this class's own and cannot
+ * be read by Haiku's BMessage, or the other way round; that is why the
+ * cache file is not a flattened message (see LibraryStore) and moves
+ * between the Haiku and the portable build unchanged.
+ *
+ * Pointers returned by the Find and Get methods stay valid until the field
+ * is changed or the message is destroyed.
+ */
+class BMessage {
+public:
+  BMessage() = default;
+  BMessage(uint32 command) : what(command) {}
+
+  uint32 what = 0;
+
+  /** @name Adding Data */
+  ///@{
+  status_t AddString(const char *name, const char *string);
+  status_t AddString(const char *name, const BString &string);
+  status_t AddInt8(const char *name, int8 value);
+  status_t AddInt16(const char *name, int16 value);
+  status_t AddInt32(const char *name, int32 value);
+  status_t AddUInt32(const char *name, uint32 value);
+  status_t AddInt64(const char *name, int64 value);
+  status_t AddUInt64(const char *name, uint64 value);
+  status_t AddBool(const char *name, bool value);
+  status_t AddFloat(const char *name, float value);
+  status_t AddDouble(const char *name, double value);
+  status_t AddMessage(const char *name, const BMessage *message);
+  status_t AddData(const char *name, type_code type, const void *data,
+                   ssize_t numBytes, bool isFixedSize = true,
+                   int32 count = 1);
+  ///@}
+
+  /** @name Finding Data
+   * Return B_NAME_NOT_FOUND, B_BAD_TYPE or B_BAD_INDEX if there is no
+   * such value.
+   */
+  ///@{
+  status_t FindString(const char *name, const char **string) const;
+  status_t FindString(const char *name, int32 index,
+                      const char **string) const;
+  status_t FindString(const char *name, BString *string) const;
+  status_t FindString(const char *name, int32 index, BString *string) const;
+  status_t FindInt8(const char *name, int8 *value) const;
+  status_t FindInt8(const char *name, int32 index, int8 *value) const;
+  status_t FindInt16(const char *name, int16 *value) const;
+  status_t FindInt16(const char *name, int32 index, int16 *value) const;
+  status_t FindInt32(const char *name, int32 *value) const;
+  status_t FindInt32(const char *name, int32 index, int32 *value) const;
+  status_t FindUInt32(const char *name, uint32 *value) const;
+  status_t FindUInt32(const char *name, int32 index, uint32 *value) const;
+  status_t FindInt64(const char *name, int64 *value) const;
+  status_t FindInt64(const char *name, int32 index, int64 *value) const;
+  status_t FindUInt64(const char *name, uint64 *value) const;
+  status_t FindUInt64(const char *name, int32 index, uint64 *value) const;
+  status_t FindBool(const char *name, bool *value) const;
+  status_t FindBool(const char *name, int32 index, bool *value) const;
+  status_t FindFloat(const char *name, float *value) const;
+  status_t FindFloat(const char *name, int32 index, float *value) const;
+  status_t FindDouble(const char *name, double *value) const;
+  status_t FindDouble(const char *name, int32 index, double *value) const;
+  status_t FindMessage(const char *name, BMessage *message) const;
+  status_t FindMessage(const char *name, int32 index,
+                       BMessage *message) const;
+  status_t FindData(const char *name, type_code type, const void **data,
+                    ssize_t *numBytes) const;
+  status_t FindData(const char *name, type_code type, int32 index,
+                    const void **data, ssize_t *numBytes) const;
+  ///@}
+
+  /** @name Getting Data With a Default */
+  ///@{
+  const char *GetString(const char *name,
+                        const char *defaultValue = nullptr) const;
+  const char *GetString(const char *name, int32 index,
+                        const char *defaultValue) const;
+  int32 GetInt32(const char *name, int32 defaultValue) const;
+  int32 GetInt32(const char *name, int32 index, int32 defaultValue) const;
+  uint32 GetUInt32(const char *name, uint32 defaultValue) const;
+  int64 GetInt64(const char *name, int64 defaultValue) const;
+  uint64 GetUInt64(const char *name, uint64 defaultValue) const;
+  bool GetBool(const char *name, bool defaultValue = false) const;
+  float GetFloat(const char *name, float defaultValue) const;
+  double GetDouble(const char *name, double defaultValue) const;
+  ///@}
+
+  /** @name Replacing Data
+   * Set the first value of the field, adding the field if needed.
+   */
+  ///@{
+  status_t SetString(const char *name, const char *string);
+  status_t SetString(const char *name, const BString &string);
+  status_t SetInt32(const char *name, int32 value);
+  status_t SetInt64(const char *name, int64 value);
+  status_t SetBool(const char *name, bool value);
+  status_t SetFloat(const char *name, float value);
+  status_t SetDouble(const char *name, double value);
+  ///@}
+
+  /** @name Fields */
+  ///@{
+  status_t GetInfo(const char *name, type_code *type,
+                   int32 *count = nullptr) const;
+  int32 CountNames(type_code type) const;
+  bool HasString(const char *name, int32 index = 0) const;
+  status_t RemoveName(const char *name);
+  status_t RemoveData(const char *name, int32 index = 0);
+  bool IsEmpty() const { return fFields.empty(); }
+  status_t MakeEmpty();
+  ///@}
+
+  /** @name Flattening */
+  ///@{
+  ssize_t FlattenedSize() const;
+  status_t Flatten(char *buffer, ssize_t size) const;
+  status_t Flatten(BDataIO *stream, ssize_t *size = nullptr) const;
+  status_t Unflatten(const char *flatBuffer);
+  status_t Unflatten(BDataIO *stream);
+  ///@}
+
+private:
+  struct Field {
+    std::string name;
+    type_code type;
+    std::vector<std::string> values;
+  };
+
+  const Field *_FindField(const char *name) const;
+  status_t _FindValue(const char *name, type_code type, int32 index,
+                      const std::string **value) const;
+  status_t _AddValue(const char *name, type_code type, const void *data,
+                     size_t size);
+  status_t _SetValue(const char *name, type_code type, const void *data,
+                     size_t size);
+  void _FlattenInto(std::string &out) const;
+  status_t _UnflattenBody(const char *data, size_t size);
+
+  template <typename T>
+  status_t _FindFixed(const char *name, type_code type, int32 index,
+                      T *value) const;
+
+  std::vector<Field> fFields;
+};
+
+#endif // BETON_PORT_MESSAGE_H
@@ -0,0 +1,226 @@
+#include <OS.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+bigtime_t system_time() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (bigtime_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+status_t snooze(bigtime_t microseconds) {
+  struct timespec delay;
+  delay.tv_sec = microseconds / 1000000;
+  delay.tv_nsec = (microseconds % 1000000) * 1000;
+  while (nanosleep(&delay, &delay) != 0) {
+    if (errno != EINTR)
+      return -errno;
+  }
+  return B_OK;
+}
+
+thread_id find_thread(const char *name) {
+  if (name != nullptr)
+    return B_NOT_SUPPORTED;
+  return (thread_id)syscall(SYS_gettid);
+}
+
+namespace {
+
+/**
+ * @struct Thread
+ * @brief A thread from spawn_thread(), until it has been waited for.
+ */
+struct Thread {
+  thread_func function;
+  void *data;
+  char name[B_OS_NAME_LENGTH];
+  pthread_t handle;
+  thread_id id = -1;
+  bool resumed = false;
+  status_t result = B_OK;
+};
+
+std::mutex sThreadsLock;
+std::condition_variable sThreadsChanged;
+std::map<thread_id, Thread *> sThreads;
+
+void *ThreadEntry(void *arg) {
+  Thread *thread = (Thread *)arg;
+  // Linux limits thread names to 15 characters
+  char shortName[16];
+  snprintf(shortName, sizeof(shortName), "%.15s", thread->name);
+  pthread_setname_np(pthread_self(), shortName);
+
+  {
+    std::unique_lock<std::mutex> lock(sThreadsLock);
+    thread->id = find_thread(nullptr);
+    sThreadsChanged.notify_all();
+    sThreadsChanged.wait(lock, [thread]() { return thread->resumed; });
+  }
+
+  thread->result = thread->function(thread->data);
+  return nullptr;
+}
+
+} // namespace
+
+thread_id spawn_thread(thread_func function, const char *name, int32,
+                       void *data) {
+  if (!function)
+    return B_BAD_VALUE;
+
+  Thread *thread = new Thread;
+  thread->function = function;
+  thread->data = data;
+  strncpy(thread->name, name ? name : "", sizeof(thread->name) - 1);
+  thread->name[sizeof(thread->name) - 1] = '\0';
+
+  int error = pthread_create(&thread->handle, nullptr, ThreadEntry, thread);
+  if (error != 0) {
+    delete thread;
+    return -error;
+  }
+
+  // The ID is only known once the thread runs
+  std::unique_lock<std::mutex> lock(sThreadsLock);
+  sThreadsChanged.wait(lock, [thread]() { return thread->id >= 0; });
+  sThreads[thread->id] = thread;
+  return thread->id;
+}
+
+status_t resume_thread(thread_id id) {
+  std::lock_guard<std::mutex> lock(sThreadsLock);
+  auto it = sThreads.find(id);
+  if (it == sThreads.end())
+    return B_BAD_THREAD_ID;
+  it->second->resumed = true;
+  sThreadsChanged.notify_all();
+  return B_OK;
+}
+
+status_t wait_for_thread(thread_id id, status_t *returnValue) {
+  Thread *thread;
+  {
+    std::lock_guard<std::mutex> lock(sThreadsLock);
+    auto it = sThreads.find(id);
+    if (it == sThreads.end())
+      return B_BAD_THREAD_ID;
+    thread = it->second;
+    sThreads.erase(it);
+    // Haiku resumes a suspended thread that is waited for
+    thread->resumed = true;
+    sThreadsChanged.notify_all();
+  }
+
+  int error = pthread_join(thread->handle, nullptr);
+  if (error == 0 && returnValue)
+    *returnValue = thread->result;
+  delete thread;
+  return -error;
+}
+
+/** @brief The /proc file of thread @p id with the given name. */
+static void ThreadFile(char *buffer, size_t size, thread_id id,
+                       const char *file) {
+  snprintf(buffer, size, "/proc/self/task/%d/%s", (int)id, file);
+}
+
+status_t rename_thread(thread_id id, const char *name) {
+  char path[64];
+  ThreadFile(path, sizeof(path), id, "comm");
+  FILE *file = fopen(path, "w");
+  if (!file)
+    return B_BAD_THREAD_ID;
+  fprintf(file, "%.15s", name ? name : "");
+  fclose(file);
+  return B_OK;
+}
+
+status_t get_thread_info(thread_id id, thread_info *info) {
+  char path[64];
+  ThreadFile(path, sizeof(path), id, "comm");
+  FILE *file = fopen(path, "r");
+  if (!file)
+    return B_BAD_THREAD_ID;
+
+  memset(info, 0, sizeof(*info));
+  if (fgets(info->name, sizeof(info->name), file))
+    info->name[strcspn(info->name, "\n")] = '\0';
+  fclose(file);
+
+  info->thread = id;
+  info->team = getpid();
+  return B_OK;
+}
+
+/**
+ * Reading smaps is slow, so the mappings are read once when the iteration
+ * starts (cookie 0) and handed out from that copy.
+ */
+status_t get_next_area_info(team_id team, ssize_t *cookie, area_info *info) {
+  thread_local std::vector<area_info> tAreas;
+
+  if (team != B_CURRENT_TEAM && team != getpid())
+    return B_BAD_VALUE;
+
+  if (*cookie == 0) {
+    tAreas.clear();
+    FILE *file = fopen("/proc/self/smaps", "r");
+    if (!file)
+      return -errno;
+
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+      unsigned long start, end;
+      size_t kilobytes;
+      if (sscanf(line, "%lx-%lx", &start, &end) == 2) {
+        area_info area;
+        memset(&area, 0, sizeof(area));
+        area.area = (area_id)tAreas.size() + 1;
+        area.address = (void *)start;
+        area.size = end - start;
+        // The file name, if any, is the last field
+        const char *name = strrchr(line, ' ');
+        strncpy(area.name, name ? name + 1 : "", sizeof(area.name) - 1);
+        area.name[strcspn(area.name, "\n")] = '\0';
+        tAreas.push_back(area);
+      } else if (!tAreas.empty() &&
+                 sscanf(line, "Rss: %zu kB", &kilobytes) == 1) {
+        tAreas.back().ram_size = kilobytes * 1024;
+      }
+    }
+    fclose(file);
+  }
+
+  if (*cookie < 0 || (size_t)*cookie >= tAreas.size())
+    return B_BAD_VALUE;
+  *info = tAreas[(*cookie)++];
+  return B_OK;
+}
+
+status_t get_system_info(system_info *info) {
+  memset(info, 0, sizeof(*info));
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  info->cpu_count = cpus > 0 ? cpus : 1;
+
+  long pageSize = sysconf(_SC_PAGESIZE);
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long freePages = sysconf(_SC_AVPHYS_PAGES);
+  if (pageSize > 0 && pages > 0) {
+    info->max_pages = pages;
+    info->used_pages = freePages > 0 ? pages - freePages : 0;
+  }
+  return B_OK;
+}
@@ -0,0 +1,88 @@
+#ifndef BETON_PORT_OS_H
+#define BETON_PORT_OS_H
+
+/**
+ * @file OS.h
+ * @brief Threads, time and memory areas of the kernel kit, on POSIX.
+ *
+ * Threads are pthreads named with pthread_setname_np(); a thread_id is the
+ * kernel's thread ID, so it matches what perf and gdb show. As on Haiku,
+ * spawn_thread() creates the thread suspended and resume_thread() starts
+ * it. Areas are the mappings listed in /proc/self/smaps, which is enough for
+ * the memory.resident metric.
+ */
+
+#include <SupportDefs.h>
+
+typedef int32 thread_id;
+typedef int32 team_id;
+typedef int32 area_id;
+
+typedef status_t (*thread_func)(void *);
+
+#define B_OS_NAME_LENGTH 32
+#define B_CURRENT_TEAM 0
+#define B_INFINITE_TIMEOUT (9223372036854775807LL)
+
+/** @name Thread Priorities
+ * Accepted for compatibility; threads keep the default scheduling.
+ */
+///@{
+#define B_LOWEST_ACTIVE_PRIORITY 1
+#define B_LOW_PRIORITY 5
+#define B_NORMAL_PRIORITY 10
+#define B_DISPLAY_PRIORITY 15
+#define B_URGENT_DISPLAY_PRIORITY 20
+///@}
+
+typedef struct {
+  thread_id thread;
+  team_id team;
+  char name[B_OS_NAME_LENGTH];
+} thread_info;
+
+typedef struct {
+  area_id area;
+  char name[B_OS_NAME_LENGTH];
+  size_t size;     ///< Size of the mapping.
+  size_t ram_size; ///< Resident part of the mapping.
+  void *address;
+} area_info;
+
+typedef struct {
+  uint32 cpu_count;
+  uint64 max_pages;
+  uint64 used_pages;
+} system_info;
+
+/** @brief Microseconds since boot (CLOCK_MONOTONIC). */
+bigtime_t system_time();
+
+status_t snooze(bigtime_t microseconds);
+
+/**
+ * @brief Returns the ID of the calling thread.
+ * @param name Must be null; looking threads up by name is not supported.
+ */
+thread_id find_thread(const char *name);
+
+thread_id spawn_thread(thread_func function, const char *name,
+                       int32 priority, void *data);
+status_t resume_thread(thread_id thread);
+
+/**
+ * @brief Waits for a thread started with spawn_thread() and returns its exit
+ * value in @p returnValue. Each thread can be waited for once.
+ */
+status_t wait_for_thread(thread_id thread, status_t *returnValue);
+
+status_t rename_thread(thread_id thread, const char *name);
+
+/** @return B_BAD_THREAD_ID once the thread has exited. */
+status_t get_thread_info(thread_id thread, thread_info *info);
+
+status_t get_next_area_info(team_id team, ssize_t *cookie, area_info *info);
+
+status_t get_system_info(system_info *info);
+
+#endif // BETON_PORT_OS_H
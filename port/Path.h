@@ -0,0 +1,41 @@
+#ifndef BETON_PORT_PATH_H
+#define BETON_PORT_PATH_H
+
+#include <StorageDefs.h>
+#include <String.h>
+
+/**
+ * @class BPath
+ * @brief An absolute, normalized path.
+ *
+ * Relative paths are resolved against the current directory, and "." and
+ * ".." components as well as duplicate slashes are removed, without
+ * touching the file system.
+ */
+class BPath {
+public:
+  BPath() = default;
+  BPath(const char *dir, const char *leaf = nullptr, bool normalize = false) {
+    SetTo(dir, leaf, normalize);
+  }
+
+  status_t SetTo(const char *dir, const char *leaf = nullptr,
+                 bool normalize = false);
+  void Unset();
+  status_t InitCheck() const { return fInitStatus; }
+
+  status_t Append(const char *path, bool normalize = false);
+  status_t GetParent(BPath *path) const;
+
+  /** @return The path, or null if the object is not initialized. */
+  const char *Path() const;
+
+  /** @return The last component, "" for "/", or null if not initialized. */
+  const char *Leaf() const;
+
+private:
+  BString fPath;
+  status_t fInitStatus = B_NO_INIT;
+};
+
+#endif // BETON_PORT_PATH_H
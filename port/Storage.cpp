@@ -0,0 +1,268 @@
+#include <Entry.h>
+#include <File.h>
+#include <FindDirectory.h>
+#include <Path.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vector>
+
+// BFile
+
+status_t BFile::SetTo(const char *path, uint32 openMode) {
+  Unset();
+  if (!path)
+    return fInitStatus = B_BAD_VALUE;
+
+  fFD = open(path, openMode | O_CLOEXEC, 0644);
+  fInitStatus = fFD < 0 ? -errno : B_OK;
+  return fInitStatus;
+}
+
+void BFile::Unset() {
+  if (fFD >= 0)
+    close(fFD);
+  fFD = -1;
+  fInitStatus = B_NO_INIT;
+}
+
+ssize_t BFile::Read(void *buffer, size_t size) {
+  if (fFD < 0)
+    return B_NO_INIT;
+  ssize_t bytes = read(fFD, buffer, size);
+  return bytes < 0 ? -errno : bytes;
+}
+
+ssize_t BFile::Write(const void *buffer, size_t size) {
+  if (fFD < 0)
+    return B_NO_INIT;
+  ssize_t bytes = write(fFD, buffer, size);
+  return bytes < 0 ? -errno : bytes;
+}
+
+ssize_t BFile::ReadAt(off_t position, void *buffer, size_t size) {
+  if (fFD < 0)
+    return B_NO_INIT;
+  ssize_t bytes = pread(fFD, buffer, size, position);
+  return bytes < 0 ? -errno : bytes;
+}
+
+ssize_t BFile::WriteAt(off_t position, const void *buffer, size_t size) {
+  if (fFD < 0)
+    return B_NO_INIT;
+  ssize_t bytes = pwrite(fFD, buffer, size, position);
+  return bytes < 0 ? -errno : bytes;
+}
+
+off_t BFile::Seek(off_t position, uint32 seekMode) {
+  if (fFD < 0)
+    return B_NO_INIT;
+  off_t result = lseek(fFD, position, seekMode);
+  return result < 0 ? -errno : result;
+}
+
+off_t BFile::Position() const {
+  if (fFD < 0)
+    return B_NO_INIT;
+  off_t result = lseek(fFD, 0, SEEK_CUR);
+  return result < 0 ? -errno : result;
+}
+
+status_t BFile::GetSize(off_t *size) const {
+  struct stat st;
+  if (fFD < 0)
+    return B_NO_INIT;
+  if (fstat(fFD, &st) != 0)
+    return -errno;
+  *size = st.st_size;
+  return B_OK;
+}
+
+status_t BFile::SetSize(off_t size) {
+  if (fFD < 0)
+    return B_NO_INIT;
+  return ftruncate(fFD, size) == 0 ? B_OK : -errno;
+}
+
+status_t BFile::Sync() {
+  if (fFD < 0)
+    return B_NO_INIT;
+  return fsync(fFD) == 0 ? B_OK : -errno;
+}
+
+// BPath
+
+/**
+ * @brief Makes @p path absolute and drops empty, "." and ".." components.
+ */
+static BString Normalize(const BString &path) {
+  BString absolute;
+  if (!path.StartsWith("/")) {
+    char cwd[B_PATH_NAME_LENGTH];
+    if (getcwd(cwd, sizeof(cwd)))
+      absolute << cwd << '/';
+  }
+  absolute << path;
+
+  std::vector<BString> components;
+  int32 start = 0;
+  while (start <= absolute.Length()) {
+    int32 end = absolute.FindFirst('/', start);
+    if (end < 0)
+      end = absolute.Length();
+
+    BString component;
+    absolute.CopyInto(component, start, end - start);
+    if (component == "..") {
+      if (!components.empty())
+        components.pop_back();
+    } else if (!component.IsEmpty() && component != ".") {
+      components.push_back(component);
+    }
+    start = end + 1;
+  }
+
+  BString normalized;
+  for (const BString &component : components)
+    normalized << '/' << component;
+  return normalized.IsEmpty() ? BString("/") : normalized;
+}
+
+status_t BPath::SetTo(const char *dir, const char *leaf, bool) {
+  Unset();
+  if (!dir || !*dir)
+    return fInitStatus = B_BAD_VALUE;
+  if (leaf && *leaf == '/')
+    return fInitStatus = B_BAD_VALUE;
+
+  BString path(dir);
+  if (leaf && *leaf)
+    path << '/' << leaf;
+  fPath = Normalize(path);
+  return fInitStatus = B_OK;
+}
+
+void BPath::Unset() {
+  fPath.MakeEmpty();
+  fInitStatus = B_NO_INIT;
+}
+
+status_t BPath::Append(const char *path, bool) {
+  if (fInitStatus != B_OK)
+    return fInitStatus;
+  if (!path || *path == '/')
+    return B_BAD_VALUE;
+  if (!*path)
+    return B_OK;
+
+  BString appended(fPath);
+  appended << '/' << path;
+  fPath = Normalize(appended);
+  return B_OK;
+}
+
+status_t BPath::GetParent(BPath *path) const {
+  if (fInitStatus != B_OK)
+    return fInitStatus;
+  if (fPath == "/")
+    return B_ENTRY_NOT_FOUND;
+  return path->SetTo(fPath.String(), "..");
+}
+
+const char *BPath::Path() const {
+  return fInitStatus == B_OK ? fPath.String() : nullptr;
+}
+
+const char *BPath::Leaf() const {
+  if (fInitStatus != B_OK)
+    return nullptr;
+  return fPath.String() + fPath.FindLast('/') + 1;
+}
+
+// BEntry
+
+status_t BEntry::SetTo(const char *path, bool) { return fPath.SetTo(path); }
+
+bool BEntry::Exists() const {
+  struct stat st;
+  return fPath.InitCheck() == B_OK && lstat(fPath.Path(), &st) == 0;
+}
+
+bool BEntry::IsDirectory() const {
+  struct stat st;
+  return fPath.InitCheck() == B_OK && lstat(fPath.Path(), &st) == 0 &&
+         S_ISDIR(st.st_mode);
+}
+
+status_t BEntry::GetPath(BPath *path) const {
+  if (fPath.InitCheck() != B_OK)
+    return fPath.InitCheck();
+  *path = fPath;
+  return B_OK;
+}
+
+status_t BEntry::Remove() {
+  if (fPath.InitCheck() != B_OK)
+    return fPath.InitCheck();
+  if (remove(fPath.Path()) != 0)
+    return -errno;
+  return B_OK;
+}
+
+// find_directory()
+
+static status_t CreateDirectories(const BString &path) {
+  int32 slash = 0;
+  do {
+    slash = path.FindFirst('/', slash + 1);
+    BString parent(path.String(), slash < 0 ? path.Length() : slash);
+    if (mkdir(parent.String(), 0755) != 0 && errno != EEXIST)
+      return -errno;
+  } while (slash >= 0);
+  return B_OK;
+}
+
+status_t find_directory(directory_which which, BPath *path, bool createIt,
+                        BVolume *) {
+  const char *home = getenv("HOME");
+  if (!home || !*home)
+    home = "/";
+
+  const char *variable = nullptr;
+  const char *fallback = nullptr;
+  switch (which) {
+  case B_USER_SETTINGS_DIRECTORY:
+    variable = "XDG_CONFIG_HOME";
+    fallback = ".config";
+    break;
+  case B_USER_CACHE_DIRECTORY:
+    variable = "XDG_CACHE_HOME";
+    fallback = ".cache";
+    break;
+  case B_USER_LOG_DIRECTORY:
+    variable = "XDG_STATE_HOME";
+    fallback = ".local/state";
+    break;
+  case B_SYSTEM_TEMP_DIRECTORY:
+    variable = "TMPDIR";
+    break;
+  default:
+    return B_BAD_VALUE;
+  }
+
+  const char *value = getenv(variable);
+  status_t status;
+  if (value && *value == '/')
+    status = path->SetTo(value);
+  else if (fallback)
+    status = path->SetTo(home, fallback);
+  else
+    status = path->SetTo("/tmp");
+
+  if (status == B_OK && createIt)
+    status = CreateDirectories(path->Path());
+  return status;
+}
@@ -0,0 +1,23 @@
+#ifndef BETON_PORT_STORAGE_DEFS_H
+#define BETON_PORT_STORAGE_DEFS_H
+
+#include <fcntl.h>
+#include <limits.h>
+
+#define B_FILE_NAME_LENGTH (NAME_MAX + 1)
+#define B_PATH_NAME_LENGTH PATH_MAX
+
+/** @name Open Modes
+ * The BFile open modes, which on Haiku are the open() flags as well.
+ */
+///@{
+#define B_READ_ONLY O_RDONLY
+#define B_WRITE_ONLY O_WRONLY
+#define B_READ_WRITE O_RDWR
+#define B_CREATE_FILE O_CREAT
+#define B_FAIL_IF_EXISTS O_EXCL
+#define B_ERASE_FILE O_TRUNC
+#define B_OPEN_AT_END O_APPEND
+///@}
+
+#endif // BETON_PORT_STORAGE_DEFS_H
@@ -0,0 +1,425 @@
+#include <String.h>
+
+#include <algorithm>
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+/** @brief Length of @p string, or of its first @p maxLength bytes. */
+static size_t BoundedLength(const char *string, int32 maxLength) {
+  if (!string || maxLength <= 0)
+    return 0;
+  const void *end = memchr(string, '\0', maxLength);
+  return end ? (const char *)end - string : (size_t)maxLength;
+}
+
+static std::string Lowered(const std::string &s) {
+  std::string lower(s);
+  for (char &c : lower)
+    c = tolower((unsigned char)c);
+  return lower;
+}
+
+static int32 Position(size_t pos) {
+  return pos == std::string::npos ? -1 : (int32)pos;
+}
+
+BString::BString(const char *string, int32 maxLength)
+    : fData(string ? string : "", BoundedLength(string, maxLength)) {}
+
+BString &BString::operator=(const char *string) { return SetTo(string); }
+
+BString &BString::operator=(char c) {
+  fData.assign(1, c);
+  return *this;
+}
+
+char BString::ByteAt(int32 index) const {
+  return index < 0 || index >= Length() ? 0 : fData[index];
+}
+
+BString &BString::SetTo(const char *string) {
+  fData.assign(string ? string : "");
+  return *this;
+}
+
+BString &BString::SetTo(const char *string, int32 maxLength) {
+  fData.assign(string ? string : "", BoundedLength(string, maxLength));
+  return *this;
+}
+
+BString &BString::SetTo(char c, int32 count) {
+  fData.assign(std::max<int32>(count, 0), c);
+  return *this;
+}
+
+BString &BString::SetToFormat(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  char buffer[512];
+  va_list copy;
+  va_copy(copy, args);
+  int length = vsnprintf(buffer, sizeof(buffer), format, copy);
+  va_end(copy);
+
+  if (length < 0) {
+    fData.clear();
+  } else if ((size_t)length < sizeof(buffer)) {
+    fData.assign(buffer, length);
+  } else {
+    fData.resize(length);
+    vsnprintf(&fData[0], length + 1, format, args);
+  }
+  va_end(args);
+  return *this;
+}
+
+BString &BString::Adopt(BString &from) {
+  fData.swap(from.fData);
+  from.fData.clear();
+  return *this;
+}
+
+BString &BString::CopyInto(BString &into, int32 fromOffset,
+                           int32 length) const {
+  if (&into == this) {
+    BString copy(*this);
+    return copy.CopyInto(into, fromOffset, length);
+  }
+  fromOffset = std::clamp<int32>(fromOffset, 0, Length());
+  length = std::clamp<int32>(length, 0, Length() - fromOffset);
+  into.fData.assign(fData, fromOffset, length);
+  return into;
+}
+
+void BString::CopyInto(char *into, int32 fromOffset, int32 length) const {
+  fromOffset = std::clamp<int32>(fromOffset, 0, Length());
+  length = std::clamp<int32>(length, 0, Length() - fromOffset);
+  memcpy(into, fData.data() + fromOffset, length);
+}
+
+BString &BString::operator+=(const BString &string) {
+  fData += string.fData;
+  return *this;
+}
+
+BString &BString::operator+=(const char *string) {
+  if (string)
+    fData += string;
+  return *this;
+}
+
+BString &BString::operator+=(char c) {
+  fData += c;
+  return *this;
+}
+
+BString &BString::Append(const BString &string) { return *this += string; }
+
+BString &BString::Append(const char *string) { return *this += string; }
+
+BString &BString::Append(const char *string, int32 length) {
+  fData.append(string ? string : "", BoundedLength(string, length));
+  return *this;
+}
+
+BString &BString::Append(char c, int32 count) {
+  fData.append(std::max<int32>(count, 0), c);
+  return *this;
+}
+
+BString &BString::Prepend(const char *string) {
+  if (string)
+    fData.insert(0, string);
+  return *this;
+}
+
+BString &BString::Insert(const char *string, int32 position) {
+  if (string && position >= 0 && position <= Length())
+    fData.insert(position, string);
+  return *this;
+}
+
+BString &BString::Truncate(int32 newLength, bool) {
+  if (newLength >= 0 && newLength < Length())
+    fData.resize(newLength);
+  return *this;
+}
+
+BString &BString::Remove(int32 from, int32 length) {
+  if (from >= 0 && from < Length() && length > 0)
+    fData.erase(from, length);
+  return *this;
+}
+
+BString &BString::RemoveFirst(const char *string) {
+  int32 pos = FindFirst(string);
+  if (pos >= 0)
+    fData.erase(pos, strlen(string));
+  return *this;
+}
+
+BString &BString::RemoveAll(const char *string) {
+  return ReplaceAll(string, "");
+}
+
+BString &BString::RemoveChars(const char *characters) {
+  if (characters) {
+    fData.erase(std::remove_if(fData.begin(), fData.end(),
+                               [characters](char c) {
+                                 return c && strchr(characters, c);
+                               }),
+                fData.end());
+  }
+  return *this;
+}
+
+BString &BString::MoveInto(BString &into, int32 from, int32 length) {
+  CopyInto(into, from, length);
+  Remove(from, length);
+  return into;
+}
+
+BString &BString::Trim() {
+  const char *space = " \t\r\n\v\f";
+  const size_t first = fData.find_first_not_of(space);
+  if (first == std::string::npos) {
+    fData.clear();
+    return *this;
+  }
+  fData.erase(fData.find_last_not_of(space) + 1);
+  fData.erase(0, first);
+  return *this;
+}
+
+BString &BString::MakeEmpty() {
+  fData.clear();
+  return *this;
+}
+
+bool BString::operator<(const char *string) const {
+  return strcmp(String(), string ? string : "") < 0;
+}
+
+bool BString::operator==(const char *string) const {
+  return strcmp(String(), string ? string : "") == 0;
+}
+
+bool BString::operator!=(const char *string) const {
+  return !(*this == string);
+}
+
+int BString::Compare(const BString &other) const {
+  return fData.compare(other.fData);
+}
+
+int BString::Compare(const char *string) const {
+  return strcmp(String(), string ? string : "");
+}
+
+int BString::Compare(const char *string, int32 length) const {
+  return strncmp(String(), string ? string : "", std::max<int32>(length, 0));
+}
+
+int BString::ICompare(const BString &other) const {
+  return strcasecmp(String(), other.String());
+}
+
+int BString::ICompare(const char *string) const {
+  return strcasecmp(String(), string ? string : "");
+}
+
+int BString::ICompare(const char *string, int32 length) const {
+  return strncasecmp(String(), string ? string : "",
+                     std::max<int32>(length, 0));
+}
+
+bool BString::StartsWith(const BString &prefix) const {
+  return fData.compare(0, prefix.fData.size(), prefix.fData) == 0;
+}
+
+bool BString::StartsWith(const char *prefix) const {
+  return prefix && fData.compare(0, strlen(prefix), prefix) == 0;
+}
+
+bool BString::EndsWith(const BString &suffix) const {
+  return EndsWith(suffix.String());
+}
+
+bool BString::EndsWith(const char *suffix) const {
+  if (!suffix)
+    return false;
+  const size_t length = strlen(suffix);
+  return length <= fData.size() &&
+         fData.compare(fData.size() - length, length, suffix) == 0;
+}
+
+bool BString::IStartsWith(const char *prefix) const {
+  return prefix && strncasecmp(String(), prefix, strlen(prefix)) == 0;
+}
+
+bool BString::IEndsWith(const char *suffix) const {
+  if (!suffix)
+    return false;
+  const size_t length = strlen(suffix);
+  return length <= fData.size() &&
+         strcasecmp(String() + fData.size() - length, suffix) == 0;
+}
+
+int32 BString::FindFirst(const BString &string, int32 fromOffset) const {
+  return FindFirst(string.String(), fromOffset);
+}
+
+int32 BString::FindFirst(const char *string, int32 fromOffset) const {
+  if (!string || fromOffset < 0 || fromOffset > Length())
+    return -1;
+  return Position(fData.find(string, fromOffset));
+}
+
+int32 BString::FindFirst(char c, int32 fromOffset) const {
+  if (fromOffset < 0 || fromOffset > Length())
+    return -1;
+  return Position(fData.find(c, fromOffset));
+}
+
+int32 BString::FindLast(const BString &string) const {
+  return FindLast(string.String());
+}
+
+int32 BString::FindLast(const char *string) const {
+  return string ? Position(fData.rfind(string)) : -1;
+}
+
+int32 BString::FindLast(char c) const { return Position(fData.rfind(c)); }
+
+int32 BString::IFindFirst(const BString &string, int32 fromOffset) const {
+  return IFindFirst(string.String(), fromOffset);
+}
+
+int32 BString::IFindFirst(const char *string, int32 fromOffset) const {
+  if (!string || fromOffset < 0 || fromOffset > Length())
+    return -1;
+  return Position(Lowered(fData).find(Lowered(string), fromOffset));
+}
+
+int32 BString::IFindLast(const char *string) const {
+  return string ? Position(Lowered(fData).rfind(Lowered(string))) : -1;
+}
+
+BString &BString::ReplaceFirst(const char *replaceThis, const char *withThis) {
+  int32 pos = FindFirst(replaceThis);
+  if (pos >= 0 && *replaceThis)
+    fData.replace(pos, strlen(replaceThis), withThis ? withThis : "");
+  return *this;
+}
+
+BString &BString::ReplaceAll(const char *replaceThis, const char *withThis) {
+  if (!replaceThis || !*replaceThis)
+    return *this;
+  const size_t length = strlen(replaceThis);
+  const std::string replacement(withThis ? withThis : "");
+  for (size_t pos = fData.find(replaceThis); pos != std::string::npos;
+       pos = fData.find(replaceThis, pos + replacement.size()))
+    fData.replace(pos, length, replacement);
+  return *this;
+}
+
+BString &BString::ReplaceAll(char replaceThis, char withThis) {
+  std::replace(fData.begin(), fData.end(), replaceThis, withThis);
+  return *this;
+}
+
+BString &BString::IReplaceAll(const char *replaceThis, const char *withThis) {
+  if (!replaceThis || !*replaceThis)
+    return *this;
+  const std::string needle = Lowered(replaceThis);
+  const std::string replacement(withThis ? withThis : "");
+  std::string lower = Lowered(fData);
+  for (size_t pos = lower.find(needle); pos != std::string::npos;
+       pos = lower.find(needle, pos + replacement.size())) {
+    fData.replace(pos, needle.size(), replacement);
+    lower.replace(pos, needle.size(), replacement);
+  }
+  return *this;
+}
+
+BString &BString::ToLower() {
+  for (char &c : fData)
+    c = tolower((unsigned char)c);
+  return *this;
+}
+
+BString &BString::ToUpper() {
+  for (char &c : fData)
+    c = toupper((unsigned char)c);
+  return *this;
+}
+
+BString &BString::Capitalize() {
+  ToLower();
+  if (!fData.empty())
+    fData[0] = toupper((unsigned char)fData[0]);
+  return *this;
+}
+
+BString &BString::operator<<(const char *string) { return *this += string; }
+
+BString &BString::operator<<(const BString &string) {
+  return *this += string;
+}
+
+BString &BString::operator<<(char c) { return *this += c; }
+
+BString &BString::operator<<(int value) {
+  fData += std::to_string(value);
+  return *this;
+}
+
+BString &BString::operator<<(unsigned int value) {
+  fData += std::to_string(value);
+  return *this;
+}
+
+BString &BString::operator<<(long value) {
+  fData += std::to_string(value);
+  return *this;
+}
+
+BString &BString::operator<<(unsigned long value) {
+  fData += std::to_string(value);
+  return *this;
+}
+
+BString &BString::operator<<(long long value) {
+  fData += std::to_string(value);
+  return *this;
+}
+
+BString &BString::operator<<(unsigned long long value) {
+  fData += std::to_string(value);
+  return *this;
+}
+
+// Haiku formats floating point values with two decimals
+BString &BString::operator<<(float value) { return *this << (double)value; }
+
+BString &BString::operator<<(double value) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.2f", value);
+  fData += buffer;
+  return *this;
+}
+
+bool operator<(const char *a, const BString &b) {
+  return strcmp(a ? a : "", b.String()) < 0;
+}
+
+bool operator==(const char *a, const BString &b) { return b == a; }
+
+bool operator!=(const char *a, const BString &b) { return b != a; }
+
+int Compare(const BString &a, const BString &b) { return a.Compare(b); }
+
+int ICompare(const BString &a, const BString &b) { return a.ICompare(b); }
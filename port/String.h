@@ -0,0 +1,158 @@
+#ifndef BETON_PORT_STRING_H
+#define BETON_PORT_STRING_H
+
+#include <SupportDefs.h>
+
+#include <string>
+
+/**
+ * @class BString
+ * @brief Haiku's string class on top of std::string.
+ *
+ * Covers the part of the BString API the core library uses, with the same
+ * semantics: lengths and offsets are int32 bytes, searches return -1 when
+ * nothing is found, and the I* methods ignore ASCII case.
+ *
+ * Unlike Haiku's BString, which shares its buffer between copies until one
+ * of them changes, copies are deep. Code that copies strings a lot is
+ * therefore slower here than on Haiku; keep that in mind when profiling.
+ */
+class BString {
+public:
+  BString() = default;
+  BString(const char *string) : fData(string ? string : "") {}
+  BString(const char *string, int32 maxLength);
+  BString(const BString &) = default;
+  BString(BString &&) = default;
+
+  BString &operator=(const BString &) = default;
+  BString &operator=(BString &&) = default;
+  BString &operator=(const char *string);
+  BString &operator=(char c);
+
+  /** @name Access */
+  ///@{
+  const char *String() const { return fData.c_str(); }
+  int32 Length() const { return (int32)fData.size(); }
+  bool IsEmpty() const { return fData.empty(); }
+  char operator[](int32 index) const { return fData[index]; }
+  char ByteAt(int32 index) const;
+  ///@}
+
+  /** @name Assigning */
+  ///@{
+  BString &SetTo(const char *string);
+  BString &SetTo(const char *string, int32 maxLength);
+  BString &SetTo(char c, int32 count);
+  BString &SetToFormat(const char *format, ...)
+      __attribute__((format(printf, 2, 3)));
+  BString &Adopt(BString &from);
+  BString &CopyInto(BString &into, int32 fromOffset, int32 length) const;
+  void CopyInto(char *into, int32 fromOffset, int32 length) const;
+  ///@}
+
+  /** @name Appending */
+  ///@{
+  BString &operator+=(const BString &string);
+  BString &operator+=(const char *string);
+  BString &operator+=(char c);
+  BString &Append(const BString &string);
+  BString &Append(const char *string);
+  BString &Append(const char *string, int32 length);
+  BString &Append(char c, int32 count);
+  BString &Prepend(const char *string);
+  BString &Insert(const char *string, int32 position);
+  ///@}
+
+  /** @name Removing */
+  ///@{
+  BString &Truncate(int32 newLength, bool lazy = true);
+  BString &Remove(int32 from, int32 length);
+  BString &RemoveFirst(const char *string);
+  BString &RemoveAll(const char *string);
+  BString &RemoveChars(const char *characters);
+  BString &MoveInto(BString &into, int32 from, int32 length);
+  BString &Trim();
+  BString &MakeEmpty();
+  ///@}
+
+  /** @name Comparing */
+  ///@{
+  bool operator<(const BString &other) const { return fData < other.fData; }
+  bool operator<=(const BString &other) const { return fData <= other.fData; }
+  bool operator==(const BString &other) const { return fData == other.fData; }
+  bool operator>=(const BString &other) const { return fData >= other.fData; }
+  bool operator>(const BString &other) const { return fData > other.fData; }
+  bool operator!=(const BString &other) const { return fData != other.fData; }
+  bool operator<(const char *string) const;
+  bool operator==(const char *string) const;
+  bool operator!=(const char *string) const;
+  int Compare(const BString &other) const;
+  int Compare(const char *string) const;
+  int Compare(const char *string, int32 length) const;
+  int ICompare(const BString &other) const;
+  int ICompare(const char *string) const;
+  int ICompare(const char *string, int32 length) const;
+  bool StartsWith(const BString &prefix) const;
+  bool StartsWith(const char *prefix) const;
+  bool EndsWith(const BString &suffix) const;
+  bool EndsWith(const char *suffix) const;
+  bool IStartsWith(const char *prefix) const;
+  bool IEndsWith(const char *suffix) const;
+  ///@}
+
+  /** @name Searching */
+  ///@{
+  int32 FindFirst(const BString &string, int32 fromOffset = 0) const;
+  int32 FindFirst(const char *string, int32 fromOffset = 0) const;
+  int32 FindFirst(char c, int32 fromOffset = 0) const;
+  int32 FindLast(const BString &string) const;
+  int32 FindLast(const char *string) const;
+  int32 FindLast(char c) const;
+  int32 IFindFirst(const BString &string, int32 fromOffset = 0) const;
+  int32 IFindFirst(const char *string, int32 fromOffset = 0) const;
+  int32 IFindLast(const char *string) const;
+  ///@}
+
+  /** @name Replacing */
+  ///@{
+  BString &ReplaceFirst(const char *replaceThis, const char *withThis);
+  BString &ReplaceAll(const char *replaceThis, const char *withThis);
+  BString &ReplaceAll(char replaceThis, char withThis);
+  BString &IReplaceAll(const char *replaceThis, const char *withThis);
+  ///@}
+
+  /** @name Case */
+  ///@{
+  BString &ToLower();
+  BString &ToUpper();
+  BString &Capitalize();
+  ///@}
+
+  /** @name Formatting */
+  ///@{
+  BString &operator<<(const char *string);
+  BString &operator<<(const BString &string);
+  BString &operator<<(char c);
+  BString &operator<<(int value);
+  BString &operator<<(unsigned int value);
+  BString &operator<<(long value);
+  BString &operator<<(unsigned long value);
+  BString &operator<<(long long value);
+  BString &operator<<(unsigned long long value);
+  BString &operator<<(float value);
+  BString &operator<<(double value);
+  ///@}
+
+private:
+  std::string fData;
+};
+
+bool operator<(const char *a, const BString &b);
+bool operator==(const char *a, const BString &b);
+bool operator!=(const char *a, const BString &b);
+
+int Compare(const BString &a, const BString &b);
+int ICompare(const BString &a, const BString &b);
+
+#endif // BETON_PORT_STRING_H
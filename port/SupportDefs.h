@@ -0,0 +1,62 @@
+#ifndef BETON_PORT_SUPPORT_DEFS_H
+#define BETON_PORT_SUPPORT_DEFS_H
+
+/**
+ * @file SupportDefs.h
+ * @brief Haiku's basic types and error codes, for building the core library
+ * on other systems.
+ *
+ * Only the subset used by libbeton-core is provided. The headers in port/
+ * are named after their Haiku counterparts so that core sources include
+ * <String.h> or <Message.h> on every platform; core/Makefile puts this
+ * directory on the include path when not building on Haiku.
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+typedef int8_t int8;
+typedef uint8_t uint8;
+typedef int16_t int16;
+typedef uint16_t uint16;
+typedef int32_t int32;
+typedef uint32_t uint32;
+typedef int64_t int64;
+typedef uint64_t uint64;
+
+typedef int32 status_t;
+typedef int64 bigtime_t;
+typedef uint32 type_code;
+
+/** @name Error Codes
+ * As on Haiku, every error is negative. Those with a POSIX equivalent are
+ * the negated errno value, so `-errno` can be returned directly.
+ */
+///@{
+#define B_OK 0
+#define B_ERROR (-1)
+#define B_NO_MEMORY (-ENOMEM)
+#define B_BAD_VALUE (-EINVAL)
+#define B_TIMED_OUT (-ETIMEDOUT)
+#define B_CANCELED (-ECANCELED)
+#define B_INTERRUPTED (-EINTR)
+#define B_WOULD_BLOCK (-EWOULDBLOCK)
+#define B_NOT_SUPPORTED (-ENOTSUP)
+#define B_BUSY (-EBUSY)
+#define B_IO_ERROR (-EIO)
+#define B_PERMISSION_DENIED (-EACCES)
+#define B_ENTRY_NOT_FOUND (-ENOENT)
+#define B_FILE_EXISTS (-EEXIST)
+#define B_NAME_TOO_LONG (-ENAMETOOLONG)
+#define B_BAD_THREAD_ID (-ESRCH)
+#define B_NAME_NOT_FOUND (-0x10001)
+#define B_BAD_INDEX (-0x10002)
+#define B_BAD_TYPE (-0x10003)
+#define B_BAD_DATA (-0x10004)
+#define B_NO_INIT (-0x10005)
+#define B_MISMATCHED_VALUES (-0x10006)
+///@}
+
+#endif // BETON_PORT_SUPPORT_DEFS_H